@@ -513,6 +513,323 @@ extern SDL_DECLSPEC SDL_PropertiesID SDLCALL MIX_GetMixerProperties(MIX_Mixer *m
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_GetMixerFormat(MIX_Mixer *mixer, SDL_AudioSpec *spec);
 
+/**
+ * Set how many threads a mixer uses to render audio.
+ *
+ * By default, a mixer does all of its work on a single thread (usually the
+ * audio device thread, or whatever thread calls MIX_Generate). With many
+ * tracks playing, it can make sense to spread this work across CPU cores.
+ *
+ * When more than one thread is requested, the mixer splits each group's
+ * tracks into small fixed-size batches, and the calling thread plus
+ * `threads - 1` render threads pull and mix those batches concurrently. The
+ * results are then added together in a fixed order, so the final output does
+ * not depend on how many threads were used or which thread mixed what. Group
+ * and mixer postmix callbacks always run after all of their tracks are mixed,
+ * on the thread that is generating the mixer's output.
+ *
+ * While rendering in parallel, track callbacks (MIX_TrackMixCallback,
+ * MIX_TrackStoppedCallback) may run on render threads, and several may run at
+ * the same time for different tracks. Such callbacks must not create or
+ * destroy tracks, change a track's group, or call MIX_PlayAudio(), as these
+ * need the mixer lock that the generating thread holds while it waits.
+ *
+ * \param mixer the mixer to change.
+ * \param threads the total number of threads to render with. Zero or one
+ *                disables parallel rendering. A negative value picks one
+ *                thread per CPU core.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerRenderThreads
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerRenderThreads(MIX_Mixer *mixer, int threads);
+
+/**
+ * Query how many threads a mixer uses to render audio.
+ *
+ * \param mixer the mixer to query.
+ * \returns the total number of threads used to render audio, including the
+ *          thread that generates the mixer's output, or -1 on error.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerRenderThreads
+ */
+extern SDL_DECLSPEC int SDLCALL MIX_GetMixerRenderThreads(MIX_Mixer *mixer);
+
+/**
+ * Make a mixer avoid allocating or freeing memory while generating audio.
+ *
+ * Normally, a mixer grows its internal buffers as needed while generating
+ * audio, and when a track from MIX_PlayAudio() finishes, it shuts down that
+ * track's decoder and releases its MIX_Audio right away, which might free a
+ * lot of memory. On the audio device thread, any of this can take long
+ * enough to cause an audible glitch, especially with small device buffers.
+ *
+ * In real-time-safe mode, the mixer preallocates SIMD-aligned buffers big
+ * enough to generate `max_frames` sample frames at a time, and keeps them
+ * sized as tracks, groups and render threads are added. If it is asked for
+ * more audio than that at once, it generates it in `max_frames` pieces. When
+ * a MIX_PlayAudio() track finishes, its decoder and MIX_Audio are not
+ * released until the app calls MIX_Update(), or MIX_PlayAudio() reuses the
+ * track.
+ *
+ * This covers SDL_mixer's own work. Decoders that stream from disk can still
+ * allocate as they decode; to keep those off the audio thread too, use
+ * predecoded audio or MIX_SetTrackDecodeAhead(). App callbacks are the app's
+ * responsibility.
+ *
+ * \param mixer the mixer to change.
+ * \param max_frames the largest number of sample frames the mixer should be
+ *                   ready to generate at once, usually the audio device's
+ *                   buffer size. Zero turns off real-time-safe mode. Must
+ *                   not be more than 65536.
+ * \returns true on success, false on error (including running out of memory
+ *          for the buffers, in which case real-time-safe mode is turned off);
+ *          call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerRealtimeSafe
+ * \sa MIX_Update
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerRealtimeSafe(MIX_Mixer *mixer, int max_frames);
+
+/**
+ * Query a mixer's real-time-safe mode.
+ *
+ * \param mixer the mixer to query.
+ * \returns the number of sample frames the mixer is prepared to generate at
+ *          once without allocating, zero if real-time-safe mode is off, or -1
+ *          on error.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerRealtimeSafe
+ */
+extern SDL_DECLSPEC int SDLCALL MIX_GetMixerRealtimeSafe(MIX_Mixer *mixer);
+
+/**
+ * Do a mixer's deferred cleanup work.
+ *
+ * In real-time-safe mode (see MIX_SetMixerRealtimeSafe()), tracks started
+ * with MIX_PlayAudio() keep their decoder and MIX_Audio after they finish,
+ * so the audio thread doesn't have to free them. This function releases
+ * them, on the calling thread instead. Apps using real-time-safe mode should
+ * call this regularly, such as once per frame; otherwise, MIX_Audio objects
+ * passed to MIX_PlayAudio() might stay in memory until their track is
+ * reused.
+ *
+ * It's harmless to call this when real-time-safe mode is off, or when there
+ * is nothing to clean up.
+ *
+ * \param mixer the mixer to update.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerRealtimeSafe
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_Update(MIX_Mixer *mixer);
+
+/**
+ * Keep mono and stereo tracks at their own channel count until they are
+ * mixed.
+ *
+ * Normally, a track's audio is converted to the mixer's channel layout as
+ * soon as it is decoded, so a mono sound effect on a 5.1 mixer moves six
+ * times as much data through the track as it needs to. With this enabled,
+ * tracks that aren't using MIX_SetTrackStereo() or MIX_SetTrack3DPosition()
+ * keep mono (or stereo, if the mixer has more than two channels) audio as-is,
+ * and it is spread to the front left and right speakers as it is mixed. This
+ * sounds the same as the usual conversion, but costs less.
+ *
+ * The only visible difference is that a track's cooked callback (see
+ * MIX_SetTrackCookedCallback()) will see the audio at its own channel count
+ * instead of the mixer's, so apps that assume otherwise should leave this
+ * off. It is off by default.
+ *
+ * \param mixer the mixer to change.
+ * \param enabled true to keep mono and stereo tracks at their own channel
+ *                count, false to convert them to the mixer's.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerNativeChannels
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerNativeChannels(MIX_Mixer *mixer, bool enabled);
+
+/**
+ * Query whether a mixer keeps mono and stereo tracks at their own channel
+ * count until they are mixed.
+ *
+ * \param mixer the mixer to query.
+ * \returns true if enabled, false if disabled or on error.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerNativeChannels
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetMixerNativeChannels(MIX_Mixer *mixer);
+
+/**
+ * Start recording a batch of track changes.
+ *
+ * Normally, each change to a track locks it, which means waiting for the
+ * mixer if it happens to be generating audio at that moment. When updating
+ * many tracks every frame, that adds up, and the changes can be split across
+ * different buffers of audio.
+ *
+ * Between MIX_BeginBatch() and MIX_CommitBatch(), these calls made on this
+ * thread, for tracks on this mixer, are recorded instead of applied:
+ *
+ * - MIX_SetTrackGain()
+ * - MIX_SetTrackFrequencyRatio()
+ * - MIX_SetTrackStereo()
+ * - MIX_SetTrack3DPosition()
+ * - MIX_SetTracks3DPositions()
+ * - MIX_SetTrack3DVelocity()
+ * - MIX_SetTracks3DVelocities()
+ * - MIX_SetTrackOcclusion()
+ * - MIX_SetTrackSend()
+ * - MIX_PlayTrack()
+ * - MIX_StopTrack()
+ * - MIX_PauseTrack()
+ * - MIX_ResumeTrack()
+ *
+ * Recording doesn't lock the mixer or the track, with two exceptions:
+ * MIX_PlayTrack() locks the track to get it ready (see below), and giving a
+ * track that isn't 3D yet a position locks the mixer once, to set it up for
+ * binaural rendering. Once the batch is committed, the mixer applies all of
+ * it, in order, right before it generates its next buffer of audio, so every
+ * change lands on the same sample frame. Until then, functions that query a
+ * track (MIX_GetTrackGain(), MIX_TrackPlaying(), etc) report how it was
+ * before the batch.
+ *
+ * MIX_PlayTrack() still validates its options and seeks to the start
+ * position right away, so it can report errors; only the start of playback
+ * waits for the batch. Playing a track that is already playing, or playing
+ * a track that uses MIX_SetTrackDecodeAhead(), is not recorded and happens
+ * right away.
+ *
+ * If there isn't enough memory to record a call, that call fails and changes
+ * nothing, rather than applying outside the batch.
+ *
+ * Calls from other threads, and the other functions that change several
+ * tracks at once (MIX_SetTagGain(), MIX_StopAllTracks(), etc), still apply
+ * right away.
+ *
+ * Batches can nest; nothing is committed until the outermost
+ * MIX_CommitBatch(). Only one thread can have a batch open on a mixer at a
+ * time.
+ *
+ * \param mixer the mixer to record changes for.
+ * \returns true on success, false on error (such as another thread having
+ *          a batch open); call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_CommitBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_BeginBatch(MIX_Mixer *mixer);
+
+/**
+ * Finish recording a batch of track changes, and hand it to the mixer.
+ *
+ * The changes are applied together before the mixer's next buffer of audio.
+ * See MIX_BeginBatch() for details.
+ *
+ * This must be called from the same thread that called MIX_BeginBatch().
+ *
+ * \param mixer the mixer whose batch should be committed.
+ * \returns true on success, false on error (such as no batch being open on
+ *          this thread); call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_BeginBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_CommitBatch(MIX_Mixer *mixer);
+
+/**
+ * The maximum number of decoders that MIX_MixerStats tracks separately.
+ *
+ * \since This macro is available since SDL_mixer 3.0.0.
+ */
+#define MIX_MAX_STATS_DECODERS 32
+
+/**
+ * Performance statistics for a mixer.
+ *
+ * All times are in nanoseconds, and all totals are since the mixer was
+ * created. Time spent in decoders includes decode-ahead worker threads, and
+ * time spent mixing includes render threads, so with those features enabled,
+ * the totals may add up to more than the wall-clock time of the callbacks.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerStats
+ */
+typedef struct MIX_MixerStats
+{
+    Uint64 callbacks;              /**< number of times the mixer has generated a buffer of audio. */
+    Uint64 callback_min_ns;        /**< shortest time spent generating a buffer. */
+    Uint64 callback_max_ns;        /**< longest time spent generating a buffer. */
+    Uint64 callback_avg_ns;        /**< average time spent generating a buffer. */
+    Uint64 decode_ns;              /**< total time spent in decoders. */
+    Uint64 mix_ns;                 /**< total time spent applying gain, fades and spatialization, and summing tracks together. */
+    Uint64 app_callback_ns;        /**< total time spent in the app's callbacks. */
+    Uint64 buffer_reallocations;   /**< number of times an internal buffer had to grow while generating audio. */
+    Uint64 missed_deadlines;       /**< number of buffers that took longer to generate than they take to play. */
+    int playing_tracks;            /**< tracks currently playing, as of the last buffer. */
+    int paused_tracks;             /**< tracks currently paused, as of the last buffer. */
+    int stopped_tracks;            /**< tracks currently stopped, as of the last buffer. */
+    int fire_and_forget_pool;      /**< idle internal tracks waiting to be reused by MIX_PlayAudio(). */
+    int virtual_tracks;            /**< playing tracks that are currently virtual (see MIX_SetMixerMaxVoices), as of the last buffer. */
+    int culled_tracks;             /**< virtual tracks that are below their audibility threshold (see MIX_SetMixerAudibilityThreshold), as of the last buffer. */
+    Uint64 frames_decoded[MIX_MAX_STATS_DECODERS];  /**< sample frames decoded, indexed the same as MIX_GetAudioDecoder(). */
+} MIX_MixerStats;
+
+/**
+ * Query a mixer's performance statistics.
+ *
+ * This does not block the mixer, and is cheap enough to call every frame. The
+ * statistics are updated each time the mixer generates a buffer of audio, and
+ * the data returned is always a consistent snapshot from one of those
+ * updates.
+ *
+ * \param mixer the mixer to query.
+ * \param stats on successful return, will be filled in with the mixer's
+ *              statistics.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetMixerStats(MIX_Mixer *mixer, MIX_MixerStats *stats);
+
 /**
  * Load audio for playback from an SDL_IOStream.
  *
@@ -618,6 +935,14 @@ extern SDL_DECLSPEC MIX_Audio * SDLCALL MIX_LoadAudio(MIX_Mixer *mixer, const ch
  * - `MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN`: true if SDL_mixer should fully
  *   decode and decompress the data before returning. Otherwise it will be
  *   stored in its original state and decompressed on demand.
+ * - `MIX_PROP_AUDIO_LOAD_PREDECODE_MIXER_FORMAT_BOOLEAN`: true if SDL_mixer
+ *   should fully decode the data, and also convert it to float32 at the
+ *   preferred mixer's sample rate and channel layout (or a reasonable default
+ *   if there's no preferred mixer), before returning. This implies
+ *   `MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN`. It can use a lot more memory,
+ *   but tracks playing this audio copy it straight from memory without any
+ *   decoding or conversion, which makes it a good fit for short, frequently
+ *   played sounds. MIX_GetAudioFormat() will report the converted format.
  * - `MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER`: a pointer to a MIX_Mixer,
  *   in case steps can be made to match its format when decoding. Optional.
  * - `MIX_PROP_AUDIO_LOAD_SKIP_METADATA_TAGS_BOOLEAN`: true to skip parsing
@@ -650,6 +975,7 @@ extern SDL_DECLSPEC MIX_Audio * SDLCALL MIX_LoadAudioWithProperties(SDL_Properti
 #define MIX_PROP_AUDIO_LOAD_IOSTREAM_POINTER "SDL_mixer.audio.load.iostream"
 #define MIX_PROP_AUDIO_LOAD_CLOSEIO_BOOLEAN "SDL_mixer.audio.load.closeio"
 #define MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN "SDL_mixer.audio.load.predecode"
+#define MIX_PROP_AUDIO_LOAD_PREDECODE_MIXER_FORMAT_BOOLEAN "SDL_mixer.audio.load.predecode_mixer_format"
 #define MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER "SDL_mixer.audio.load.preferred_mixer"
 #define MIX_PROP_AUDIO_LOAD_SKIP_METADATA_TAGS_BOOLEAN "SDL_mixer.audio.load.skip_metadata_tags"
 #define MIX_PROP_AUDIO_DECODER_STRING "SDL_mixer.audio.decoder"
@@ -1142,6 +1468,83 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackAudioStream(MIX_Track *track, SDL_A
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackIOStream(MIX_Track *track, SDL_IOStream *io, bool closeio);
 
+/**
+ * Decode a track's audio ahead of time on a background thread.
+ *
+ * Normally, a track decodes its audio on the audio device thread, exactly
+ * when the mixer needs more data. For expensive formats (MP3, Vorbis, MIDI,
+ * etc), this can take a meaningful chunk of the time the device allows for
+ * each buffer, and many such tracks playing at once can cause audio dropouts.
+ *
+ * With decode-ahead enabled, a shared pool of worker threads keeps a buffer
+ * of up to `frames` sample frames decoded in advance, and the mixer just
+ * copies from it. If the workers fall behind, the mixer will not wait for
+ * them; the track will simply produce less audio for that buffer, and the
+ * track's underrun count (see MIX_GetTrackDecodeUnderruns) increases.
+ *
+ * The buffer size is rounded up to a power of two. A few thousand sample
+ * frames is usually plenty; larger values use more memory and make seeking
+ * or changing inputs more expensive, as the buffer has to be refilled.
+ *
+ * This setting stays with the track when its input changes, but only applies
+ * while the input is a MIX_Audio (or an SDL_IOStream from
+ * MIX_SetTrackIOStream); tracks fed by MIX_SetTrackAudioStream() always pull
+ * from their stream directly.
+ *
+ * \param track the track to change.
+ * \param frames the number of sample frames to decode ahead, or <= 0 to
+ *               disable decode-ahead for this track.
+ * \returns true on success, false on error; call SDL_GetError() for details.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrackDecodeAhead
+ * \sa MIX_GetTrackDecodeUnderruns
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackDecodeAhead(MIX_Track *track, Sint64 frames);
+
+/**
+ * Query how many sample frames a track decodes ahead of time.
+ *
+ * This reports the value last set with MIX_SetTrackDecodeAhead(), before it
+ * was rounded up to a power of two.
+ *
+ * \param track the track to query.
+ * \returns the number of sample frames requested, zero if decode-ahead is
+ *          disabled for this track, or -1 on error.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackDecodeAhead
+ */
+extern SDL_DECLSPEC Sint64 SDLCALL MIX_GetTrackDecodeAhead(MIX_Track *track);
+
+/**
+ * Query how many times a track's decode-ahead buffer ran dry.
+ *
+ * Each time the mixer wanted more audio from a decode-ahead track and the
+ * worker threads had not produced it yet, this count increases by one. A
+ * steadily increasing count suggests the decode-ahead buffer is too small, or
+ * the system can't decode fast enough.
+ *
+ * The count is not reset when the track is played again or its input
+ * changes; it resets to zero when decode-ahead is disabled for the track.
+ *
+ * \param track the track to query.
+ * \returns the number of underruns, or -1 on error.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackDecodeAhead
+ */
+extern SDL_DECLSPEC Sint64 SDLCALL MIX_GetTrackDecodeUnderruns(MIX_Track *track);
+
 /**
  * Assign an arbitrary tag to a track.
  *
@@ -1492,6 +1895,23 @@ extern SDL_DECLSPEC Sint64 SDLCALL MIX_FramesToMS(int sample_rate, Sint64 frames
 
 /* operations that deal with actual mixing/playback... */
 
+/**
+ * The shape of a fade-in or fade-out.
+ *
+ * These are used with the MIX_PROP_PLAY_FADE_IN_CURVE_NUMBER and
+ * MIX_PROP_PLAY_FADE_OUT_CURVE_NUMBER properties in MIX_PlayTrack().
+ *
+ * \since This enum is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_PlayTrack
+ */
+typedef enum MIX_FadeCurve
+{
+    MIX_FADE_CURVE_LINEAR,       /**< gain changes at a constant rate. This is the default. */
+    MIX_FADE_CURVE_EQUAL_POWER,  /**< gain follows a quarter sine wave; crossfading two tracks this way keeps the total power steady. */
+    MIX_FADE_CURVE_EXPONENTIAL   /**< gain changes at a roughly constant rate in decibels, which the ear hears as more even. */
+} MIX_FadeCurve;
+
 /**
  * Start (or restart) mixing a track for playback.
  *
@@ -1550,6 +1970,11 @@ extern SDL_DECLSPEC Sint64 SDLCALL MIX_FramesToMS(int sample_rate, Sint64 frames
  *   MIX_PROP_PLAY_FADE_IN_FRAMES_NUMBER property, but the value is specified
  *   in milliseconds instead of sample frames. If both properties are
  *   specified, the sample frames value is favored. Default 0.
+ * - `MIX_PROP_PLAY_FADE_IN_CURVE_NUMBER`: The MIX_FadeCurve to use for the
+ *   fade-in, if there is one. Default MIX_FADE_CURVE_LINEAR.
+ * - `MIX_PROP_PLAY_FADE_OUT_CURVE_NUMBER`: The MIX_FadeCurve to use if this
+ *   track is later faded out by MIX_StopTrack() (or MIX_StopTag, etc).
+ *   Default MIX_FADE_CURVE_LINEAR.
  * - `MIX_PROP_PLAY_APPEND_SILENCE_FRAMES_NUMBER`: At the end of mixing this
  *   track, after all loops are complete, append this many sample frames of
  *   silence as if it were part of the audio file. This allows for apps to
@@ -1591,6 +2016,8 @@ extern SDL_DECLSPEC bool SDLCALL MIX_PlayTrack(MIX_Track *track, SDL_PropertiesI
 #define MIX_PROP_PLAY_LOOP_START_MILLISECOND_NUMBER "SDL_mixer.play.loop_start_millisecond"
 #define MIX_PROP_PLAY_FADE_IN_FRAMES_NUMBER "SDL_mixer.play.fade_in_frames"
 #define MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER "SDL_mixer.play.fade_in_milliseconds"
+#define MIX_PROP_PLAY_FADE_IN_CURVE_NUMBER "SDL_mixer.play.fade_in_curve"
+#define MIX_PROP_PLAY_FADE_OUT_CURVE_NUMBER "SDL_mixer.play.fade_out_curve"
 #define MIX_PROP_PLAY_APPEND_SILENCE_FRAMES_NUMBER "SDL_mixer.play.append_silence_frames"
 #define MIX_PROP_PLAY_APPEND_SILENCE_MILLISECONDS_NUMBER "SDL_mixer.play.append_silence_milliseconds"
 
@@ -1673,6 +2100,9 @@ extern SDL_DECLSPEC bool SDLCALL MIX_PlayAudio(MIX_Mixer *mixer, MIX_Audio *audi
  * sample-perfect mixing. MIX_TrackMSToFrames() can be used to convert
  * milliseconds to an appropriate value here.
  *
+ * The shape of the fade is set by the MIX_PROP_PLAY_FADE_OUT_CURVE_NUMBER
+ * property when the track was started with MIX_PlayTrack().
+ *
  * If the track ends normally while the fade-out is still in progress, the
  * audio stops there; the fade is not adjusted to be shorter if it will last
  * longer than the audio remaining.
@@ -1962,125 +2392,333 @@ extern SDL_DECLSPEC bool SDLCALL MIX_TrackPlaying(MIX_Track *track);
 extern SDL_DECLSPEC bool SDLCALL MIX_TrackPaused(MIX_Track *track);
 
 
-/* volume control... */
+/* voice limiting... */
 
 /**
- * Set a mixer's master gain control.
+ * Set the maximum number of tracks a mixer will actually decode and mix.
+ *
+ * Games often have far more sounds playing than anyone can hear. When a
+ * mixer has a voice budget, each time it generates audio it ranks its playing
+ * tracks by priority (see MIX_SetTrackPriority), then by how loud they are
+ * likely to be, and only that many of them become "real" voices that are
+ * decoded, resampled and mixed. The rest become "virtual": they don't use any
+ * CPU time for audio, but their playback position keeps moving (including
+ * loops, fades and appended silence) as if they were playing, and they can
+ * still finish and fire their MIX_TrackStoppedCallback.
+ *
+ * When a virtual track becomes a real voice again, it seeks to where it would
+ * have been and resumes with a short fade-in, so it doesn't pop.
+ *
+ * How loud a track is likely to be is estimated from its gain
+ * (MIX_SetTrackGain), its distance attenuation if it has a 3D position
+ * (MIX_SetTrack3DPosition), or its loudest channel if it has stereo gains
+ * (MIX_SetTrackStereo). The actual audio data is not examined.
+ *
+ * Tracks that can't be seeked to an arbitrary point in time are never made
+ * virtual, but still count against the budget. These are tracks playing from
+ * an SDL_AudioStream (MIX_SetTrackAudioStream), tracks with decode-ahead
+ * enabled (MIX_SetTrackDecodeAhead), and tracks whose audio has an unknown
+ * duration.
+ *
+ * A mixer's voice budget defaults to zero, which means there's no limit.
+ *
+ * \param mixer the mixer to change.
+ * \param voices the maximum number of real voices, or zero for no limit.
+ * \returns true on success, false on error; call SDL_GetError() for details.
  *
- * Each mixer has a master gain, to adjust the volume of the entire mix. Each
- * sample passing through the pipeline is modulated by this gain value. A gain
- * of zero will generate silence, 1.0f will not change the mixed volume, and
- * larger than 1.0f will increase the volume. Negative values are illegal.
- * There is no maximum gain specified, but this can quickly get extremely
- * loud, so please be careful with this setting.
+ * \threadsafety It is safe to call this function from any thread.
  *
- * A mixer's master gain defaults to 1.0f.
+ * \since This function is available since SDL_mixer 3.0.0.
  *
- * This value can be changed at any time to adjust the future mix.
+ * \sa MIX_GetMixerMaxVoices
+ * \sa MIX_SetMixerAudibilityThreshold
+ * \sa MIX_SetTrackPriority
+ * \sa MIX_TrackVirtual
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerMaxVoices(MIX_Mixer *mixer, int voices);
+
+/**
+ * Query the maximum number of tracks a mixer will actually decode and mix.
  *
- * \param mixer the mixer to adjust.
- * \param gain the new gain value.
- * \returns true on success or false on failure; call SDL_GetError() for more
- *          information.
+ * \param mixer the mixer to query.
+ * \returns the maximum number of real voices, zero for no limit, or -1 on
+ *          error.
  *
  * \threadsafety It is safe to call this function from any thread.
  *
  * \since This function is available since SDL_mixer 3.0.0.
  *
- * \sa MIX_GetMasterGain
- * \sa MIX_SetTrackGain
+ * \sa MIX_SetMixerMaxVoices
  */
-extern SDL_DECLSPEC bool SDLCALL MIX_SetMasterGain(MIX_Mixer *mixer, float gain);
+extern SDL_DECLSPEC int SDLCALL MIX_GetMixerMaxVoices(MIX_Mixer *mixer);
 
 /**
- * Get a mixer's master gain control.
+ * Set how quiet a track has to be before a mixer stops mixing it.
+ *
+ * Playing tracks whose estimated loudness is below this value become virtual
+ * (see MIX_SetMixerMaxVoices for what that means), regardless of priority
+ * and whether the mixer has a voice budget. Estimated loudness is the track's
+ * gain multiplied by its distance attenuation, so a track with a gain of
+ * 1.0f, 10 units away from the listener, is about 0.1f.
+ *
+ * The threshold defaults to zero, which means tracks are never made virtual
+ * for being too quiet. Individual tracks can override it with
+ * MIX_SetTrackAudibilityThreshold(). MIX_GetMixerStats() reports how many
+ * tracks are currently culled this way, to help tune it.
+ *
+ * \param mixer the mixer to change.
+ * \param threshold the audibility threshold. Negative values are clamped to
+ *                  zero.
+ * \returns true on success, false on error; call SDL_GetError() for details.
  *
- * This returns the last value set through MIX_SetMasterGain(), or 1.0f if no
- * value has ever been explicitly set.
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerAudibilityThreshold
+ * \sa MIX_SetMixerMaxVoices
+ * \sa MIX_SetTrackAudibilityThreshold
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerAudibilityThreshold(MIX_Mixer *mixer, float threshold);
+
+/**
+ * Query how quiet a track has to be before a mixer stops mixing it.
  *
  * \param mixer the mixer to query.
- * \returns the mixer's current master gain.
+ * \returns the audibility threshold, or -1.0f on error.
  *
  * \threadsafety It is safe to call this function from any thread.
  *
  * \since This function is available since SDL_mixer 3.0.0.
  *
- * \sa MIX_SetMasterGain
- * \sa MIX_GetTrackGain
+ * \sa MIX_SetMixerAudibilityThreshold
  */
-extern SDL_DECLSPEC float SDLCALL MIX_GetMasterGain(MIX_Mixer *mixer);
+extern SDL_DECLSPEC float SDLCALL MIX_GetMixerAudibilityThreshold(MIX_Mixer *mixer);
 
 /**
- * Set a track's gain control.
- *
- * Each track has its own gain, to adjust its overall volume. Each sample from
- * this track is modulated by this gain value. A gain of zero will generate
- * silence, 1.0f will not change the mixed volume, and larger than 1.0f will
- * increase the volume. Negative values are illegal. There is no maximum gain
- * specified, but this can quickly get extremely loud, so please be careful
- * with this setting.
+ * Set a track's priority for voice limiting.
  *
- * A track's gain defaults to 1.0f.
+ * When a mixer has more playing tracks than its voice budget allows (see
+ * MIX_SetMixerMaxVoices), tracks with a higher priority are always picked to
+ * be real voices before tracks with a lower priority, no matter how loud
+ * they are. Among tracks with the same priority, louder ones win.
  *
- * This value can be changed at any time to adjust the future mix.
+ * A track's priority defaults to zero. Negative values are allowed.
  *
- * \param track the track to adjust.
- * \param gain the new gain value.
- * \returns true on success or false on failure; call SDL_GetError() for more
- *          information.
+ * \param track the track to change.
+ * \param priority the new priority.
+ * \returns true on success, false on error; call SDL_GetError() for details.
  *
  * \threadsafety It is safe to call this function from any thread.
  *
  * \since This function is available since SDL_mixer 3.0.0.
  *
- * \sa MIX_GetTrackGain
- * \sa MIX_SetMasterGain
+ * \sa MIX_GetTrackPriority
+ * \sa MIX_SetMixerMaxVoices
  */
-extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackGain(MIX_Track *track, float gain);
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackPriority(MIX_Track *track, int priority);
 
 /**
- * Get a track's gain control.
- *
- * This returns the last value set through MIX_SetTrackGain(), or 1.0f if no
- * value has ever been explicitly set.
+ * Query a track's priority for voice limiting.
  *
  * \param track the track to query.
- * \returns the track's current gain.
+ * \returns the track's priority, or zero on error.
  *
  * \threadsafety It is safe to call this function from any thread.
  *
  * \since This function is available since SDL_mixer 3.0.0.
  *
- * \sa MIX_SetTrackGain
- * \sa MIX_GetMasterGain
+ * \sa MIX_SetTrackPriority
  */
-extern SDL_DECLSPEC float SDLCALL MIX_GetTrackGain(MIX_Track *track);
+extern SDL_DECLSPEC int SDLCALL MIX_GetTrackPriority(MIX_Track *track);
 
 /**
- * Set the gain control of all tracks with a specific tag.
+ * Set how quiet a specific track has to be before its mixer stops mixing it.
  *
- * Each track has its own gain, to adjust its overall volume. Each sample from
- * this track is modulated by this gain value. A gain of zero will generate
- * silence, 1.0f will not change the mixed volume, and larger than 1.0f will
- * increase the volume. Negative values are illegal. There is no maximum gain
- * specified, but this can quickly get extremely loud, so please be careful
- * with this setting.
+ * This overrides the mixer's audibility threshold (see
+ * MIX_SetMixerAudibilityThreshold) for this track. This is useful for sounds
+ * that should keep playing even when quiet, like dialogue, or for sounds
+ * that aren't worth mixing until they're fairly loud, like distant ambience.
  *
- * A track's gain defaults to 1.0f.
+ * A track's threshold defaults to -1.0f, which means it uses the mixer's.
  *
- * This will change the gain control on tracks on the specified mixer that
- * have the specified tag.
+ * \param track the track to change.
+ * \param threshold the audibility threshold, or a negative value to use the
+ *                  mixer's.
+ * \returns true on success, false on error; call SDL_GetError() for details.
  *
- * From the point of view of the mixing process, all tracks that successfully
- * change gain values will do so at the exact same moment.
+ * \threadsafety It is safe to call this function from any thread.
  *
- * This value can be changed at any time to adjust the future mix.
+ * \since This function is available since SDL_mixer 3.0.0.
  *
- * \param mixer the mixer on which to look for tagged tracks.
- * \param tag the tag to use when searching for tracks.
- * \param gain the new gain value.
- * \returns true on success or false on failure; call SDL_GetError() for more
- *          information.
+ * \sa MIX_GetTrackAudibilityThreshold
+ * \sa MIX_SetMixerAudibilityThreshold
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackAudibilityThreshold(MIX_Track *track, float threshold);
+
+/**
+ * Query how quiet a specific track has to be before its mixer stops mixing
+ * it.
+ *
+ * \param track the track to query.
+ * \returns the track's audibility threshold, or -1.0f if it uses the mixer's
+ *          (or on error).
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackAudibilityThreshold
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetTrackAudibilityThreshold(MIX_Track *track);
+
+/**
+ * Query if a track is currently virtual.
+ *
+ * A virtual track is playing (MIX_TrackPlaying() returns true for it), but
+ * the mixer has decided it's too quiet or too unimportant to decode and mix
+ * right now. See MIX_SetMixerMaxVoices for details.
+ *
+ * Tracks are reevaluated every time the mixer generates audio, so this can
+ * change at any time.
+ *
+ * \param track the track to query.
+ * \returns true if virtual, false otherwise.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerMaxVoices
+ * \sa MIX_TrackPlaying
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_TrackVirtual(MIX_Track *track);
+
+
+/* volume control... */
+
+/**
+ * Set a mixer's master gain control.
+ *
+ * Each mixer has a master gain, to adjust the volume of the entire mix. Each
+ * sample passing through the pipeline is modulated by this gain value. A gain
+ * of zero will generate silence, 1.0f will not change the mixed volume, and
+ * larger than 1.0f will increase the volume. Negative values are illegal.
+ * There is no maximum gain specified, but this can quickly get extremely
+ * loud, so please be careful with this setting.
+ *
+ * A mixer's master gain defaults to 1.0f.
+ *
+ * This value can be changed at any time to adjust the future mix.
+ *
+ * \param mixer the mixer to adjust.
+ * \param gain the new gain value.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMasterGain
+ * \sa MIX_SetTrackGain
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMasterGain(MIX_Mixer *mixer, float gain);
+
+/**
+ * Get a mixer's master gain control.
+ *
+ * This returns the last value set through MIX_SetMasterGain(), or 1.0f if no
+ * value has ever been explicitly set.
+ *
+ * \param mixer the mixer to query.
+ * \returns the mixer's current master gain.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMasterGain
+ * \sa MIX_GetTrackGain
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetMasterGain(MIX_Mixer *mixer);
+
+/**
+ * Set a track's gain control.
+ *
+ * Each track has its own gain, to adjust its overall volume. Each sample from
+ * this track is modulated by this gain value. A gain of zero will generate
+ * silence, 1.0f will not change the mixed volume, and larger than 1.0f will
+ * increase the volume. Negative values are illegal. There is no maximum gain
+ * specified, but this can quickly get extremely loud, so please be careful
+ * with this setting.
+ *
+ * A track's gain defaults to 1.0f.
+ *
+ * This value can be changed at any time to adjust the future mix.
+ *
+ * Setting a track's gain locks it, which means waiting if the mixer is in
+ * the middle of mixing it. An app that changes many tracks every frame can
+ * avoid that by recording the changes with MIX_BeginBatch().
+ *
+ * \param track the track to adjust.
+ * \param gain the new gain value.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrackGain
+ * \sa MIX_SetMasterGain
+ * \sa MIX_BeginBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackGain(MIX_Track *track, float gain);
+
+/**
+ * Get a track's gain control.
+ *
+ * This returns the last value set through MIX_SetTrackGain(), or 1.0f if no
+ * value has ever been explicitly set.
+ *
+ * \param track the track to query.
+ * \returns the track's current gain.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackGain
+ * \sa MIX_GetMasterGain
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetTrackGain(MIX_Track *track);
+
+/**
+ * Set the gain control of all tracks with a specific tag.
+ *
+ * Each track has its own gain, to adjust its overall volume. Each sample from
+ * this track is modulated by this gain value. A gain of zero will generate
+ * silence, 1.0f will not change the mixed volume, and larger than 1.0f will
+ * increase the volume. Negative values are illegal. There is no maximum gain
+ * specified, but this can quickly get extremely loud, so please be careful
+ * with this setting.
+ *
+ * A track's gain defaults to 1.0f.
+ *
+ * This will change the gain control on tracks on the specified mixer that
+ * have the specified tag.
+ *
+ * From the point of view of the mixing process, all tracks that successfully
+ * change gain values will do so at the exact same moment.
+ *
+ * This value can be changed at any time to adjust the future mix.
+ *
+ * \param mixer the mixer on which to look for tagged tracks.
+ * \param tag the tag to use when searching for tracks.
+ * \param gain the new gain value.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
  *
  * \threadsafety It is safe to call this function from any thread.
  *
@@ -2109,6 +2747,13 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTagGain(MIX_Mixer *mixer, const char *ta
  *
  * This value can be changed at any time to adjust the future mix.
  *
+ * Tracks in 3D positional mode also get a doppler shift from their velocity
+ * (see MIX_SetTrack3DVelocity()), which is applied on top of this ratio.
+ *
+ * This locks the track, so it waits if the mixer is mixing it at that
+ * moment; see MIX_BeginBatch() to change many tracks every frame without
+ * waiting.
+ *
  * \param track the track on which to change the frequency ratio.
  * \param ratio the frequency ratio. Must be between 0.01f and 100.0f.
  * \returns true on success or false on failure; call SDL_GetError() for more
@@ -2119,6 +2764,7 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTagGain(MIX_Mixer *mixer, const char *ta
  * \since This function is available since SDL_mixer 3.0.0.
  *
  * \sa MIX_GetTrackFrequencyRatio
+ * \sa MIX_BeginBatch
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackFrequencyRatio(MIX_Track *track, float ratio);
 
@@ -2133,6 +2779,9 @@ extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackFrequencyRatio(MIX_Track *track, fl
  *
  * The default value is 1.0f.
  *
+ * This is the value set with MIX_SetTrackFrequencyRatio(); it doesn't include
+ * any doppler shift.
+ *
  * On various errors (MIX_Init() was not called, the track is NULL), this
  * returns 0.0f. Since this is not a valid value to set, this can be seen as
  * an error state.
@@ -2236,6 +2885,10 @@ typedef struct MIX_StereoGains
  * The track's 3D position, reported by MIX_GetTrack3DPosition(), will be
  * reset to (0, 0, 0).
  *
+ * This locks the track, so it waits if the mixer is mixing it at that
+ * moment; see MIX_BeginBatch() to change many tracks every frame without
+ * waiting.
+ *
  * \param track the track to adjust.
  * \param gains the per-channel gains, or NULL to disable spatialization.
  * \returns true on success or false on failure; call SDL_GetError() for more
@@ -2246,6 +2899,7 @@ typedef struct MIX_StereoGains
  * \since This function is available since SDL_mixer 3.0.0.
  *
  * \sa MIX_SetTrack3DPosition
+ * \sa MIX_BeginBatch
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackStereo(MIX_Track *track, const MIX_StereoGains *gains);
 
@@ -2272,7 +2926,7 @@ typedef struct MIX_Point3D
  *
  * (Please note that SDL_mixer is not intended to be a extremely powerful 3D
  * API. It lacks 3D features that other APIs like OpenAL offer: there's no
- * doppler effect, distance models, rolloff, etc. This is meant to be Good
+ * choice of distance models, rolloff, etc. This is meant to be Good
  * Enough for games that can use some positional sounds and can even take
  * advantage of surround-sound configurations.)
  *
@@ -2294,13 +2948,423 @@ typedef struct MIX_Point3D
  * The coordinate system operates like OpenGL or OpenAL: a "right-handed"
  * coordinate system. See MIX_Point3D for the details.
  *
- * The listener is always at coordinate (0,0,0) and can't be changed.
+ * By default, the listener is at coordinate (0,0,0), facing forward (towards
+ * negative Z). Use MIX_SetListener3D() to move it.
+ *
+ * The track's input will be converted to mono (1 channel) so it can be
+ * rendered across the correct speakers.
+ *
+ * This locks the track, so it waits if the mixer is mixing it at that
+ * moment. To move many tracks every frame, MIX_SetTracks3DPositions() is
+ * cheaper, and recording the changes with MIX_BeginBatch() doesn't wait at
+ * all.
+ *
+ * \param track the track for which to set 3D position.
+ * \param position the new 3D position for the track. May be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrack3DPosition
+ * \sa MIX_SetTrackStereo
+ * \sa MIX_BeginBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrack3DPosition(MIX_Track *track, const MIX_Point3D *position);
+
+/**
+ * Get a track's current position in 3D space.
+ *
+ * If 3D positioning isn't enabled for this track, through a call to
+ * MIX_SetTrack3DPosition(), this will return (0,0,0).
+ *
+ * \param track the track to query.
+ * \param position on successful return, will contain the track's position.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrack3DPosition
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetTrack3DPosition(MIX_Track *track, MIX_Point3D *position);
+
+/**
+ * Set a track's velocity in 3D space, for the doppler effect.
+ *
+ * A track in 3D positional mode that moves toward the listener plays at a
+ * higher pitch, and one moving away plays lower, depending on how fast each
+ * is moving along the line between them (the listener's velocity is set with
+ * MIX_SetListener3D()) compared to the speed of sound (see
+ * MIX_SetMixerSpeedOfSound()). Velocity is in the same units as positions,
+ * per second. It doesn't move the track; the app still does that with
+ * MIX_SetTrack3DPosition().
+ *
+ * The doppler shift is calculated by the mixer, for all tracks together, and
+ * applied on top of the track's frequency ratio (see
+ * MIX_SetTrackFrequencyRatio()). When it changes, the pitch glides to the new
+ * value over the next several mixes instead of jumping.
+ *
+ * Velocity has no effect on tracks that aren't in 3D positional mode, but it
+ * is remembered if they switch to it later.
+ *
+ * This locks the track, so it waits if the mixer is mixing it at that
+ * moment; see MIX_SetTracks3DVelocities() and MIX_BeginBatch() to update
+ * many tracks every frame.
+ *
+ * \param track the track for which to set 3D velocity.
+ * \param velocity the new 3D velocity for the track. NULL is the same as
+ *                 (0,0,0).
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrack3DVelocity
+ * \sa MIX_SetTracks3DVelocities
+ * \sa MIX_SetTrack3DPosition
+ * \sa MIX_BeginBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrack3DVelocity(MIX_Track *track, const MIX_Point3D *velocity);
+
+/**
+ * Get a track's current velocity in 3D space.
+ *
+ * \param track the track to query.
+ * \param velocity on successful return, will contain the track's velocity.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrack3DVelocity
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetTrack3DVelocity(MIX_Track *track, MIX_Point3D *velocity);
+
+/**
+ * Set how much of a track's sound is blocked on its way to the listener.
+ *
+ * Occlusion is for a sound that has to pass through something, like a wall
+ * or a closed door: it gets muffled and quieter. Obstruction is for a sound
+ * whose direct path is blocked, but that still reaches the listener around
+ * the obstacle: it gets muffled, but not quieter. Both range from 0.0f
+ * (nothing in the way, the default) to 1.0f (completely blocked); values
+ * outside that range are clamped. The more is blocked, the lower the
+ * low-pass filter's cutoff.
+ *
+ * The app decides these values, usually by casting rays through its own
+ * level geometry; SDL_mixer doesn't know anything about the world beyond
+ * positions.
+ *
+ * The filter is applied as the track is mixed, so it costs very little over
+ * normal 3D mixing. Occlusion and obstruction have no effect on tracks that
+ * aren't in 3D positional mode, but are remembered if they switch to it
+ * later.
+ *
+ * This locks the track, so it waits if the mixer is mixing it at that
+ * moment; see MIX_BeginBatch() to change many tracks every frame without
+ * waiting.
+ *
+ * \param track the track to change.
+ * \param occlusion how occluded the track is, from 0.0f to 1.0f.
+ * \param obstruction how obstructed the track is, from 0.0f to 1.0f.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrackOcclusion
+ * \sa MIX_SetTrack3DPosition
+ * \sa MIX_BeginBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackOcclusion(MIX_Track *track, float occlusion, float obstruction);
+
+/**
+ * Get how much of a track's sound is blocked on its way to the listener.
+ *
+ * \param track the track to query.
+ * \param occlusion on successful return, will contain the track's occlusion.
+ *                  May be NULL.
+ * \param obstruction on successful return, will contain the track's
+ *                    obstruction. May be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackOcclusion
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetTrackOcclusion(MIX_Track *track, float *occlusion, float *obstruction);
+
+/**
+ * Set the 3D positions of several tracks at once.
+ *
+ * This does the same thing as calling MIX_SetTrack3DPosition() on each track,
+ * but it's cheaper when moving lots of tracks every frame: the positions are
+ * stored and spatialized together, several tracks at a time, when the mixer
+ * next runs, instead of one at a time as each position arrives.
+ *
+ * All tracks must belong to the same mixer. A track can appear more than
+ * once; the last position listed for it wins. Positions can't be NULL here;
+ * use MIX_SetTrack3DPosition() to turn off a track's 3D positioning.
+ *
+ * MIX_GetTrack3DPosition() reports the new position as soon as this function
+ * returns, even though the mixer hasn't spatialized it yet.
+ *
+ * If this thread has a batch open with MIX_BeginBatch(), the positions are
+ * recorded in the batch, like MIX_SetTrack3DPosition() would, and take effect
+ * when the batch is committed.
+ *
+ * \param tracks an array of `count` tracks to move.
+ * \param positions an array of `count` positions, one for each track.
+ * \param count the number of elements in `tracks` and `positions`.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrack3DPosition
+ * \sa MIX_GetTrack3DPosition
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTracks3DPositions(MIX_Track **tracks, const MIX_Point3D *positions, int count);
+
+/**
+ * Set the 3D velocities of several tracks at once.
+ *
+ * This does the same thing as calling MIX_SetTrack3DVelocity() on each track,
+ * but the doppler shift for every track is calculated together when the mixer
+ * next runs, alongside any positions from MIX_SetTracks3DPositions(), instead
+ * of one at a time.
+ *
+ * All tracks must belong to the same mixer. Velocities can't be NULL here.
+ *
+ * If this thread has a batch open with MIX_BeginBatch(), the velocities are
+ * recorded in the batch, like MIX_SetTrack3DVelocity() would, and take effect
+ * when the batch is committed.
+ *
+ * \param tracks an array of `count` tracks to change.
+ * \param velocities an array of `count` velocities, one for each track.
+ * \param count the number of elements in `tracks` and `velocities`.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrack3DVelocity
+ * \sa MIX_SetTracks3DPositions
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTracks3DVelocities(MIX_Track **tracks, const MIX_Point3D *velocities, int count);
+
+/**
+ * Set the position, orientation, and velocity of a mixer's 3D listener.
+ *
+ * All tracks using MIX_SetTrack3DPosition() are heard relative to the
+ * listener. Moving the listener, instead of moving every track into listener
+ * space, lets an app only update tracks that actually moved.
+ *
+ * `orientation` is an array of two points, like OpenAL's `AL_ORIENTATION`:
+ * the first is the "at" vector (the direction the listener faces), the second
+ * is the "up" vector. Neither needs to be unit length, but they can't be zero
+ * or parallel to each other. If "up" isn't perpendicular to "at", it's
+ * adjusted to be.
+ *
+ * Any parameter may be NULL to reset that piece to its default: position and
+ * velocity of (0,0,0), facing (0,0,-1) with up being (0,1,0).
+ *
+ * The listener's velocity is used, along with each track's, for the doppler
+ * effect; see MIX_SetTrack3DVelocity().
+ *
+ * Tracks are respatialized all at once, the next time the mixer runs, so
+ * calling this several times between mixes costs no more than calling it
+ * once. This isn't recorded in batches made with MIX_BeginBatch(); it takes
+ * effect at the next mix either way.
+ *
+ * \param mixer the mixer whose listener should change.
+ * \param position the listener's new position. May be NULL.
+ * \param orientation an array of two points, "at" and "up". May be NULL.
+ * \param velocity the listener's new velocity. May be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetListener3D
+ * \sa MIX_SetTrack3DPosition
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetListener3D(MIX_Mixer *mixer, const MIX_Point3D *position, const MIX_Point3D *orientation, const MIX_Point3D *velocity);
+
+/**
+ * Get the position, orientation, and velocity of a mixer's 3D listener.
+ *
+ * The orientation reported is normalized, with "up" made perpendicular to
+ * "at", so it might not exactly match what was passed to MIX_SetListener3D().
+ *
+ * \param mixer the mixer to query.
+ * \param position on successful return, the listener's position. May be
+ *                 NULL.
+ * \param orientation an array of two points, filled with "at" and "up" on
+ *                    successful return. May be NULL.
+ * \param velocity on successful return, the listener's velocity. May be NULL.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetListener3D
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetListener3D(MIX_Mixer *mixer, MIX_Point3D *position, MIX_Point3D *orientation, MIX_Point3D *velocity);
+
+/**
+ * Set the speed of sound used for a mixer's doppler effect.
+ *
+ * This is in the same units as 3D positions, per second. The default is
+ * 343.3, the speed of sound in meters per second, so apps that use other
+ * units should change it. Lower values exaggerate the doppler effect.
+ *
+ * Whatever the speed of sound, the doppler effect treats the listener and
+ * tracks as moving no faster than half of it, so the pitch never goes higher
+ * than 3 times or lower than a third of normal.
+ *
+ * \param mixer the mixer to change.
+ * \param speed the speed of sound, or 0.0f to turn off the doppler effect.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetMixerSpeedOfSound
+ * \sa MIX_SetTrack3DVelocity
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerSpeedOfSound(MIX_Mixer *mixer, float speed);
+
+/**
+ * Query the speed of sound used for a mixer's doppler effect.
+ *
+ * \param mixer the mixer to query.
+ * \returns the speed of sound, 0.0f if the doppler effect is off, or -1.0f
+ *          on error; call SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerSpeedOfSound
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetMixerSpeedOfSound(MIX_Mixer *mixer);
+
+/**
+ * A head-related impulse response, for binaural rendering.
+ *
+ * This describes how a sound arriving from one direction reaches each ear.
+ * The angles use the same convention as SOFA files, so data loaded with a
+ * SOFA library can be passed through unchanged.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetMixerHRTF
+ */
+typedef struct MIX_HRIR
+{
+    float azimuth;       /**< Direction in degrees, counterclockwise: 0 is straight ahead, 90 is to the left. */
+    float elevation;     /**< Direction in degrees: 0 is level with the ears, 90 is straight up. */
+    const float *left;   /**< Impulse response for the left ear. */
+    const float *right;  /**< Impulse response for the right ear. */
+} MIX_HRIR;
+
+/**
+ * Render 3D tracks binaurally, for headphones.
+ *
+ * By default, tracks using MIX_SetTrack3DPosition() are panned between a pair
+ * of speakers. That works for speakers, but not very well for headphones.
+ * With a set of head-related impulse responses (an "HRTF"), a mixer with
+ * stereo output instead filters each 3D track through the impulse response
+ * closest to its direction, which sounds much more like it's coming from
+ * somewhere outside the listener's head.
+ *
+ * SDL_mixer doesn't read HRTF files itself; load the impulse responses with
+ * something like libmysofa and pass them here. They are copied, so the app
+ * can free its data when this function returns. Each impulse response must be
+ * `frames` sample frames long, and may be at most 4096 frames after being
+ * resampled to the mixer's sample rate.
+ *
+ * SDL_mixer only positions sounds in the horizontal plane, so for each
+ * direction, the impulse response closest to zero elevation is used. When a
+ * track moves far enough to need a different impulse response, the two are
+ * crossfaded.
+ *
+ * Binaural rendering adds 128 sample frames of latency to 3D tracks. It is
+ * only used while the mixer's output is stereo; otherwise 3D tracks are
+ * panned across speakers as usual.
+ *
+ * Each 3D track needs some memory to be rendered this way, which is allocated
+ * here and when a track is first given a 3D position, never while generating
+ * audio. A track that couldn't get it is panned instead.
+ *
+ * \param mixer the mixer to change.
+ * \param hrirs an array of `num_hrirs` impulse responses, or NULL to turn off
+ *              binaural rendering.
+ * \param num_hrirs the number of elements in `hrirs`.
+ * \param frames the length, in sample frames, of each impulse response.
+ * \param freq the sample rate of the impulse responses.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
  *
- * The track's input will be converted to mono (1 channel) so it can be
- * rendered across the correct speakers.
+ * \since This function is available since SDL_mixer 3.0.0.
  *
- * \param track the track for which to set 3D position.
- * \param position the new 3D position for the track. May be NULL.
+ * \sa MIX_SetTrack3DPosition
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerHRTF(MIX_Mixer *mixer, const MIX_HRIR *hrirs, int num_hrirs, int frames, int freq);
+
+/**
+ * Spatialize 3D tracks through an ambisonic sound field.
+ *
+ * By default, each track using MIX_SetTrack3DPosition() is panned to the
+ * output speakers by itself. With an ambisonic order set, 3D tracks in a
+ * group are instead encoded into a shared sound field, which is decoded to
+ * the speakers once per group. This costs a little more per track, but the
+ * decoding cost doesn't grow with the number of tracks, and sounds move
+ * around the listener more smoothly than they do with pairwise panning.
+ *
+ * Higher orders are more precise about direction but cost more; order 1
+ * encodes 3 channels per track and order 3 encodes 7. Since SDL_mixer only
+ * positions sounds in the horizontal plane, the sound field is horizontal,
+ * too.
+ *
+ * If the mixer has an HRTF (see MIX_SetMixerHRTF()) and stereo output, the
+ * sound field is decoded to a small ring of virtual speakers that are
+ * rendered binaurally, so the HRTF is applied a fixed number of times per
+ * group no matter how many tracks are playing.
+ *
+ * Each group's 3D tracks are decoded before the group's postmix callback
+ * runs, so the callback sees them like any other track.
+ *
+ * \param mixer the mixer to change.
+ * \param order the ambisonic order to use, from 1 to 3, or 0 to pan 3D tracks
+ *              straight to the speakers.
  * \returns true on success or false on failure; call SDL_GetError() for more
  *          information.
  *
@@ -2308,29 +3372,26 @@ typedef struct MIX_Point3D
  *
  * \since This function is available since SDL_mixer 3.0.0.
  *
- * \sa MIX_GetTrack3DPosition
- * \sa MIX_SetTrackStereo
+ * \sa MIX_GetMixerAmbisonicOrder
+ * \sa MIX_SetTrack3DPosition
  */
-extern SDL_DECLSPEC bool SDLCALL MIX_SetTrack3DPosition(MIX_Track *track, const MIX_Point3D *position);
+extern SDL_DECLSPEC bool SDLCALL MIX_SetMixerAmbisonicOrder(MIX_Mixer *mixer, int order);
 
 /**
- * Get a track's current position in 3D space.
+ * Query the ambisonic order a mixer uses for 3D tracks.
  *
- * If 3D positioning isn't enabled for this track, through a call to
- * MIX_SetTrack3DPosition(), this will return (0,0,0).
- *
- * \param track the track to query.
- * \param position on successful return, will contain the track's position.
- * \returns true on success or false on failure; call SDL_GetError() for more
+ * \param mixer the mixer to query.
+ * \returns the ambisonic order, 0 if 3D tracks are panned straight to the
+ *          speakers, or -1 on error; call SDL_GetError() for more
  *          information.
  *
  * \threadsafety It is safe to call this function from any thread.
  *
  * \since This function is available since SDL_mixer 3.0.0.
  *
- * \sa MIX_SetTrack3DPosition
+ * \sa MIX_SetMixerAmbisonicOrder
  */
-extern SDL_DECLSPEC bool SDLCALL MIX_GetTrack3DPosition(MIX_Track *track, MIX_Point3D *position);
+extern SDL_DECLSPEC int SDLCALL MIX_GetMixerAmbisonicOrder(MIX_Mixer *mixer);
 
 
 /* Mix groups... */
@@ -2670,6 +3731,460 @@ typedef void (SDLCALL *MIX_GroupMixCallback)(void *userdata, MIX_Group *group, c
  */
 extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupPostMixCallback(MIX_Group *group, MIX_GroupMixCallback cb, void *userdata);
 
+/**
+ * The number of parametric EQ bands each mixer group has.
+ *
+ * \since This macro is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupEQBand
+ */
+#define MIX_MAX_EQ_BANDS 4
+
+/**
+ * The shape of a group's EQ band.
+ *
+ * \since This enum is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupEQBand
+ */
+typedef enum MIX_EQBandType
+{
+    MIX_EQ_NONE,       /**< the band is off. This is the default. */
+    MIX_EQ_PEAKING,    /**< boost or cut around `frequency`; `q` sets how wide. */
+    MIX_EQ_LOWSHELF,   /**< boost or cut everything below `frequency`. */
+    MIX_EQ_HIGHSHELF,  /**< boost or cut everything above `frequency`. */
+    MIX_EQ_LOWPASS,    /**< remove everything above `frequency`; `gain_db` is ignored. */
+    MIX_EQ_HIGHPASS    /**< remove everything below `frequency`; `gain_db` is ignored. */
+} MIX_EQBandType;
+
+/**
+ * Settings for one band of a group's parametric EQ.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupEQBand
+ */
+typedef struct MIX_EQBand
+{
+    MIX_EQBandType type;  /**< the band's shape. */
+    float frequency;      /**< the band's center or corner frequency, in Hz. */
+    float gain_db;        /**< how much to boost (positive) or cut (negative), in decibels. */
+    float q;              /**< the band's width; higher is narrower. 0.707f is a good place to start. */
+} MIX_EQBand;
+
+/**
+ * Settings for a group's compressor.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupCompressor
+ */
+typedef struct MIX_Compressor
+{
+    float threshold_db;  /**< the level, in decibels below full scale, where compression starts. */
+    float ratio;         /**< how hard to compress above the threshold; 4.0f turns 4 dB over into 1 dB over. Must be at least 1.0f. */
+    float attack_ms;     /**< how quickly, in milliseconds, compression kicks in when the level rises. */
+    float release_ms;    /**< how quickly, in milliseconds, compression lets go when the level falls. */
+    float makeup_db;     /**< gain, in decibels, added after compressing. */
+} MIX_Compressor;
+
+/**
+ * Settings for a group's limiter.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupLimiter
+ */
+typedef struct MIX_Limiter
+{
+    float ceiling_db;    /**< the group's output never goes above this level, in decibels below full scale. */
+    float lookahead_ms;  /**< how far ahead, in milliseconds, the limiter looks for peaks. This delays the group by that much. At most about 10 milliseconds is used. */
+    float release_ms;    /**< how quickly, in milliseconds, the limiter lets go after a peak. */
+} MIX_Limiter;
+
+/**
+ * Set one band of a mixer group's built-in parametric EQ.
+ *
+ * Each group has a chain of built-in effects that run after its tracks are
+ * mixed together, and before its postmix callback (see
+ * MIX_SetGroupPostMixCallback()): the EQ, then the compressor (see
+ * MIX_SetGroupCompressor()), then the group's gain (see MIX_SetGroupGain()),
+ * then the limiter (see MIX_SetGroupLimiter()). Effects that aren't turned on
+ * cost nothing.
+ *
+ * The EQ has MIX_MAX_EQ_BANDS bands, which are applied in order. Changes glide
+ * to their new values over the next few mixes instead of jumping, so an app
+ * can sweep them without clicks.
+ *
+ * Tracks that aren't in an explicit MIX_Group are mixed in an internal
+ * grouping that does not have these effects.
+ *
+ * \param group the mixing group to change.
+ * \param band the band to change, from 0 to MIX_MAX_EQ_BANDS - 1.
+ * \param params the band's new settings. NULL turns the band off.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread. It never
+ *               waits for the mixer to finish mixing.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetGroupEQBand
+ * \sa MIX_SetGroupCompressor
+ * \sa MIX_SetGroupLimiter
+ * \sa MIX_SetGroupGain
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupEQBand(MIX_Group *group, int band, const MIX_EQBand *params);
+
+/**
+ * Get the settings of one band of a mixer group's built-in parametric EQ.
+ *
+ * A band that is turned off reports a `type` of MIX_EQ_NONE.
+ *
+ * \param group the mixing group to query.
+ * \param band the band to query, from 0 to MIX_MAX_EQ_BANDS - 1.
+ * \param params on successful return, will contain the band's settings.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupEQBand
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetGroupEQBand(MIX_Group *group, int band, MIX_EQBand *params);
+
+/**
+ * Set a mixer group's built-in compressor.
+ *
+ * The compressor is feed-forward, and looks at all of the group's channels
+ * together, so it doesn't shift the stereo image.
+ *
+ * \param group the mixing group to change.
+ * \param params the compressor's new settings. NULL turns the compressor off.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread. It never
+ *               waits for the mixer to finish mixing.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetGroupCompressor
+ * \sa MIX_SetGroupEQBand
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupCompressor(MIX_Group *group, const MIX_Compressor *params);
+
+/**
+ * Get the settings of a mixer group's built-in compressor.
+ *
+ * \param group the mixing group to query.
+ * \param params on successful return, will contain the compressor's settings.
+ * \returns true on success or false if the compressor is off or on failure;
+ *          call SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupCompressor
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetGroupCompressor(MIX_Group *group, MIX_Compressor *params);
+
+/**
+ * Set a mixer group's built-in limiter.
+ *
+ * The limiter is the last of the group's built-in effects, and keeps the
+ * group's output from going over its ceiling, no matter what. It looks ahead
+ * for peaks, so it can turn the group down smoothly before they arrive
+ * instead of clipping them, which delays the group's audio by the lookahead
+ * time.
+ *
+ * \param group the mixing group to change.
+ * \param params the limiter's new settings. NULL turns the limiter off.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread. It never
+ *               waits for the mixer to finish mixing.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetGroupLimiter
+ * \sa MIX_SetGroupEQBand
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupLimiter(MIX_Group *group, const MIX_Limiter *params);
+
+/**
+ * Get the settings of a mixer group's built-in limiter.
+ *
+ * \param group the mixing group to query.
+ * \param params on successful return, will contain the limiter's settings.
+ * \returns true on success or false if the limiter is off or on failure; call
+ *          SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupLimiter
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetGroupLimiter(MIX_Group *group, MIX_Limiter *params);
+
+/**
+ * Set a mixer group's gain control.
+ *
+ * This is applied after the group's EQ and compressor, and before its
+ * limiter. It works like MIX_SetTrackGain(), but for the whole group at once,
+ * and changes ramp across the next mix instead of jumping.
+ *
+ * A group's gain defaults to 1.0f.
+ *
+ * \param group the mixing group to change.
+ * \param gain the new gain value. Negative values are illegal.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread. It never
+ *               waits for the mixer to finish mixing.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetGroupGain
+ * \sa MIX_SetGroupEQBand
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetGroupGain(MIX_Group *group, float gain);
+
+/**
+ * Get a mixer group's gain control.
+ *
+ * This returns the last value set through MIX_SetGroupGain(), or 1.0f if no
+ * value has ever been explicitly set.
+ *
+ * \param group the mixing group to query.
+ * \returns the group's current gain.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetGroupGain
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetGroupGain(MIX_Group *group);
+
+/**
+ * The number of send buses each mixer has.
+ *
+ * \since This macro is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackSend
+ */
+#define MIX_MAX_SEND_BUSES 4
+
+/**
+ * A callback that fires when a mixer's send bus has collected everything sent
+ * to it.
+ *
+ * This is where an app runs an effect, like reverb, that is shared by many
+ * tracks: it runs once per bus, no matter how many tracks feed it. The data
+ * works like MIX_GroupMixCallback's: the app can change it in any way it
+ * likes, and what it leaves in `pcm` is mixed back into the final output (see
+ * MIX_SetSendBusGain()).
+ *
+ * This fires every time the mixer mixes, even if nothing was sent to the bus,
+ * so effects with a tail, like reverb, can ring out.
+ *
+ * \param userdata an opaque pointer provided by the app for its personal use.
+ * \param mixer the mixer that owns the bus.
+ * \param bus the send bus that is being mixed, from 0 to MIX_MAX_SEND_BUSES -
+ *            1.
+ * \param spec the format of the data in `pcm`.
+ * \param pcm the raw PCM data in float32 format.
+ * \param samples the number of float values pointed to by `pcm`.
+ *
+ * \since This datatype is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetSendBusPostMixCallback
+ */
+typedef void (SDLCALL *MIX_SendBusMixCallback)(void *userdata, MIX_Mixer *mixer, int bus, const SDL_AudioSpec *spec, float *pcm, int samples);
+
+/**
+ * Set how much of a track feeds one of its mixer's send buses.
+ *
+ * Each mixer has MIX_MAX_SEND_BUSES send buses. A track can feed any of them,
+ * in addition to being mixed as usual, and each bus is processed once (see
+ * MIX_SetSendBusPostMixCallback()) and mixed back into the final output after
+ * all the groups. This lets one effect, like a reverb, serve any number of
+ * tracks.
+ *
+ * The send is taken after the track's gain (and the mixer's master gain), but
+ * before 3D positioning or stereo panning, so a bus hears every track from
+ * the front. A level of 0.0f (the default) sends nothing; 1.0f sends the
+ * track at full volume.
+ *
+ * This locks the track, so it waits if the mixer is mixing it at that
+ * moment; see MIX_BeginBatch() to change many tracks every frame without
+ * waiting.
+ *
+ * \param track the track to change.
+ * \param bus the send bus to feed, from 0 to MIX_MAX_SEND_BUSES - 1.
+ * \param level how much of the track to send. Negative values are illegal.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetTrackSend
+ * \sa MIX_SetSendBusGain
+ * \sa MIX_SetSendBusPostMixCallback
+ * \sa MIX_BeginBatch
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetTrackSend(MIX_Track *track, int bus, float level);
+
+/**
+ * Get how much of a track feeds one of its mixer's send buses.
+ *
+ * \param track the track to query.
+ * \param bus the send bus to query, from 0 to MIX_MAX_SEND_BUSES - 1.
+ * \returns the track's send level, or -1.0f on failure; call SDL_GetError()
+ *          for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetTrackSend
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetTrackSend(MIX_Track *track, int bus);
+
+/**
+ * Set how much of a send bus is mixed back into the final output.
+ *
+ * A send bus's gain defaults to 1.0f.
+ *
+ * \param mixer the mixer that owns the bus.
+ * \param bus the send bus to change, from 0 to MIX_MAX_SEND_BUSES - 1.
+ * \param gain the new gain value. Negative values are illegal.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetSendBusGain
+ * \sa MIX_SetTrackSend
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetSendBusGain(MIX_Mixer *mixer, int bus, float gain);
+
+/**
+ * Get how much of a send bus is mixed back into the final output.
+ *
+ * \param mixer the mixer that owns the bus.
+ * \param bus the send bus to query, from 0 to MIX_MAX_SEND_BUSES - 1.
+ * \returns the bus's gain, or -1.0f on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetSendBusGain
+ */
+extern SDL_DECLSPEC float SDLCALL MIX_GetSendBusGain(MIX_Mixer *mixer, int bus);
+
+/**
+ * Set a callback that fires when a send bus has collected everything sent to
+ * it.
+ *
+ * Passing a NULL callback here is legal; it disables this bus's callback, and
+ * whatever was sent to the bus is mixed back into the output unchanged.
+ *
+ * \param mixer the mixer that owns the bus.
+ * \param bus the send bus to assign this callback to, from 0 to
+ *            MIX_MAX_SEND_BUSES - 1.
+ * \param cb the function to call when the bus mixes. May be NULL.
+ * \param userdata an opaque pointer provided to the callback for its own
+ *                 personal use.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SendBusMixCallback
+ * \sa MIX_SetTrackSend
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetSendBusPostMixCallback(MIX_Mixer *mixer, int bus, MIX_SendBusMixCallback cb, void *userdata);
+
+/**
+ * Settings for a send bus's built-in reverb.
+ *
+ * \since This struct is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetSendBusReverb
+ */
+typedef struct MIX_Reverb
+{
+    float room_size;     /**< from 0.0f (a small room) to 1.0f (a large hall); sets how far apart the echoes are. */
+    float decay_time;    /**< how long, in seconds, the reverb takes to fade by 60 decibels. */
+    float damping;       /**< from 0.0f to 1.0f; how much faster high frequencies fade than low ones. */
+    float predelay_ms;   /**< how long, in milliseconds, before the reverb starts. At most 100 milliseconds is used. */
+} MIX_Reverb;
+
+/**
+ * Set a send bus's built-in reverb.
+ *
+ * The reverb is a feedback delay network: it runs whatever was sent to the
+ * bus (see MIX_SetTrackSend()) through eight delay lines that feed back into
+ * each other, and replaces the bus's audio with the result, so the bus is
+ * 100% reverb. It runs once per mix, before the bus's postmix callback (see
+ * MIX_SetSendBusPostMixCallback()), no matter how many tracks feed the bus.
+ * Turn the bus's gain (see MIX_SetSendBusGain()) and each track's send level
+ * up or down to taste.
+ *
+ * The reverb's memory is allocated here, so it never allocates while mixing.
+ * When nothing is sent to the bus and its tail has faded out, it costs almost
+ * nothing.
+ *
+ * \param mixer the mixer that owns the bus.
+ * \param bus the send bus to change, from 0 to MIX_MAX_SEND_BUSES - 1.
+ * \param params the reverb's new settings. NULL turns the reverb off and frees
+ *               its memory.
+ * \returns true on success or false on failure; call SDL_GetError() for more
+ *          information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_GetSendBusReverb
+ * \sa MIX_SetTrackSend
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_SetSendBusReverb(MIX_Mixer *mixer, int bus, const MIX_Reverb *params);
+
+/**
+ * Get the settings of a send bus's built-in reverb.
+ *
+ * \param mixer the mixer that owns the bus.
+ * \param bus the send bus to query, from 0 to MIX_MAX_SEND_BUSES - 1.
+ * \param params on successful return, will contain the reverb's settings.
+ * \returns true on success or false if the bus has no reverb or on failure;
+ *          call SDL_GetError() for more information.
+ *
+ * \threadsafety It is safe to call this function from any thread.
+ *
+ * \since This function is available since SDL_mixer 3.0.0.
+ *
+ * \sa MIX_SetSendBusReverb
+ */
+extern SDL_DECLSPEC bool SDLCALL MIX_GetSendBusReverb(MIX_Mixer *mixer, int bus, MIX_Reverb *params);
+
 /**
  * A callback that fires when all mixing has completed.
  *
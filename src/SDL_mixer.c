@@ -93,6 +93,23 @@ static MIX_Audio *all_audios = NULL;
 static MIX_AudioDecoder *all_audiodecoders = NULL;
 static SDL_Mutex *global_lock = NULL;
 
+#define MIX_DEFAULT_SPEED_OF_SOUND 343.3f  // meters per second, in dry air at room temperature, like OpenAL's default.
+
+// decode-ahead worker pool, shared by all mixers. Started on first use, shut down in MIX_Quit.
+#define MIX_DECODE_AHEAD_MAX_THREADS 4
+#define MIX_DECODE_AHEAD_CHUNK_FRAMES 4096  // most frames a worker decodes before rechecking the ring.
+#define MIX_DECODE_AHEAD_MAX_FRAMES (1 << 24)
+static SDL_Thread *decode_ahead_threads[MIX_DECODE_AHEAD_MAX_THREADS];
+static int num_decode_ahead_threads = 0;
+static SDL_Mutex *decode_ahead_lock = NULL;  // protects decode_ahead_list.
+static SDL_Semaphore *decode_ahead_sem = NULL;
+static SDL_AtomicInt decode_ahead_shutdown;
+static MIX_DecodeAhead *decode_ahead_list = NULL;
+
+#if defined(SDL_AVX2_INTRINSICS)
+bool MIX_HasAVX2 = false;
+#endif
+
 #if defined(SDL_NEON_INTRINSICS) && SDL_MIXER_NEED_SCALAR_FALLBACK
 bool MIX_HasNEON = false;
 #endif
@@ -176,6 +193,22 @@ CHECKTAGPLUSPARAM(MIX_Track, Track, track)
 #undef CHECKTAGPLUSPARAM
 
 
+// Add to one of a mixer's pending stats. Safe to call from any thread.
+static void AddPendingStat(SDL_AtomicInt *stat, Uint64 amount)
+{
+    SDL_AddAtomicInt(stat, (int) SDL_min(amount, SDL_MAX_SINT32));
+}
+
+static int GetDecoderIndex(const MIX_Decoder *decoder)
+{
+    for (int i = 0; i < num_available_decoders; i++) {
+        if (available_decoders[i] == decoder) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 static bool SetTrackOutputStreamFormat(MIX_Track *track, const SDL_AudioSpec *spec)
 {
     SDL_copyp(&track->output_spec, &track->mixer->spec);
@@ -183,6 +216,17 @@ static bool SetTrackOutputStreamFormat(MIX_Track *track, const SDL_AudioSpec *sp
         track->output_spec.channels = 1;
     } else if (track->spatialization_mode == MIX_SPATIALIZATION_STEREO) {
         track->output_spec.channels = 2;
+    } else if (track->mixer->native_channels) {
+        // mono (or stereo, on surround output) stays that way until MixTrack, which puts it on the front speakers like SDL's upmixing would have.
+        SDL_AudioSpec input;
+        if (spec) {
+            SDL_copyp(&input, spec);
+        } else {
+            SDL_GetAudioStreamFormat(track->output_stream, &input, NULL);
+        }
+        if ((input.channels <= 2) && (input.channels < track->output_spec.channels)) {
+            track->output_spec.channels = input.channels;
+        }
     }
 
     const bool retval = SDL_SetAudioStreamFormat(track->output_stream, spec, &track->output_spec);   // input is `spec`, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono...if force_stereo, output_stream but stereo).
@@ -190,6 +234,284 @@ static bool SetTrackOutputStreamFormat(MIX_Track *track, const SDL_AudioSpec *sp
     return retval;
 }
 
+// Scratch buffers don't need to keep their contents when they grow, so just replace them with a new SIMD-aligned block.
+// Returns false and leaves the old buffer alone if out of memory.
+static bool GrowScratchBuffer(float **buffer, size_t *allocation, size_t len)
+{
+    if (len <= *allocation) {
+        return true;
+    }
+    float *ptr = (float *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), len);
+    if (!ptr) {
+        return false;
+    }
+    SDL_aligned_free(*buffer);
+    *buffer = ptr;
+    *allocation = len;
+    return true;
+}
+
+// How many bytes an ambisonic bus needs for `amount` bytes of mixer output. Zero if the mixer doesn't use one.
+static size_t AmbisonicBusSize(const MIX_Mixer *mixer, size_t amount)
+{
+    if (mixer->ambisonic_order == 0) {
+        return 0;
+    }
+    const size_t frames = amount / SDL_AUDIO_FRAMESIZE(mixer->spec);
+    return frames * ((mixer->ambisonic_order * 2) + 1) * sizeof (float);
+}
+
+// How many bytes the send buses need for `amount` bytes of mixer->spec audio; zero if no track has ever used them.
+static size_t SendBusSize(const MIX_Mixer *mixer, size_t amount)
+{
+    return mixer->sends_enabled ? (amount * MIX_MAX_SEND_BUSES) : 0;
+}
+
+// In real-time-safe mode, make sure every scratch buffer MixerCallback might need for `realtime_frames` of audio is
+//  already allocated, so it never has to do it on the audio thread. Call this whenever something those sizes depend on
+//  changes (tracks or groups created, render threads, the mixer's format).
+// this assumes LockMixer(mixer) was called before this.
+static bool ReserveRealtimeBuffers(MIX_Mixer *mixer)
+{
+    if (mixer->realtime_frames <= 0) {
+        return true;  // not in real-time-safe mode, buffers grow as needed.
+    }
+
+    const size_t amount = ((size_t) mixer->realtime_frames) * SDL_AUDIO_FRAMESIZE(mixer->spec);
+
+    int total_tracks = 0;
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        total_tracks++;
+    }
+
+    int total_groups = 0;
+    for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+        total_groups++;
+    }
+
+    // each group can leave one partially-filled job, so this is the most PrepareRenderJobs can need, no matter how tracks are grouped.
+    const int total_jobs = (total_tracks / MIX_RENDER_TRACKS_PER_JOB) + total_groups;
+
+    if (!GrowScratchBuffer(&mixer->mix_buffer, &mixer->mix_buffer_allocation, amount * 3)) {  // MixerCallback needs up to 3 buffers' worth.
+        return false;
+    } else if (!GrowScratchBuffer(&mixer->ambisonic_buffer, &mixer->ambisonic_buffer_allocation, AmbisonicBusSize(mixer, amount))) {
+        return false;
+    } else if (!GrowScratchBuffer(&mixer->send_buffer, &mixer->send_buffer_allocation, SendBusSize(mixer, amount))) {
+        return false;
+    }
+
+    if (total_tracks > mixer->voice_tracks_allocation) {
+        void *ptr = SDL_realloc(mixer->voice_tracks, total_tracks * sizeof (MIX_Track *));
+        if (!ptr) {
+            return false;
+        }
+        mixer->voice_tracks = (MIX_Track **) ptr;
+        mixer->voice_tracks_allocation = total_tracks;
+    }
+
+    if (mixer->num_render_threads > 0) {
+        if (total_tracks > mixer->render_tracks_allocation) {
+            void *ptr = SDL_realloc(mixer->render_tracks, total_tracks * sizeof (MIX_Track *));
+            if (!ptr) {
+                return false;
+            }
+            mixer->render_tracks = (MIX_Track **) ptr;
+            mixer->render_tracks_allocation = total_tracks;
+        }
+
+        if (total_jobs > mixer->render_jobs_allocation) {
+            void *ptr = SDL_realloc(mixer->render_jobs, total_jobs * sizeof (MIX_RenderJob));
+            if (!ptr) {
+                return false;
+            }
+            mixer->render_jobs = (MIX_RenderJob *) ptr;
+            mixer->render_jobs_allocation = total_jobs;
+        }
+
+        if (!GrowScratchBuffer(&mixer->render_buffer, &mixer->render_buffer_allocation, amount * total_jobs)) {
+            return false;
+        } else if (!GrowScratchBuffer(&mixer->ambisonic_render_buffer, &mixer->ambisonic_render_buffer_allocation, AmbisonicBusSize(mixer, amount) * total_jobs)) {
+            return false;
+        } else if (!GrowScratchBuffer(&mixer->send_render_buffer, &mixer->send_render_buffer_allocation, SendBusSize(mixer, amount) * total_jobs)) {
+            return false;
+        }
+
+        for (int i = 0; i <= mixer->num_render_threads; i++) {
+            MIX_RenderThread *rt = &mixer->render_threads[i];
+            if (!GrowScratchBuffer(&rt->getbuf, &rt->getbuf_allocation, amount)) {
+                return false;
+            }
+        }
+    }
+
+    // TrackGetCallback works in pieces if this isn't big enough, so one mixer buffer's worth is plenty.
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        LockTrack(track);
+        const bool okay = GrowScratchBuffer(&track->input_buffer, &track->input_buffer_len, amount);
+        UnlockTrack(track);
+        if (!okay) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Drop the group's binaural decoding state, because the HRTF or the ambisonic order changed. Mixer must be locked.
+static void FreeGroupAmbisonicBinaural(MIX_Group *group)
+{
+    for (int i = 0; i < (int) SDL_arraysize(group->ambisonic_binaural); i++) {
+        MIX_DestroyBinauralState(group->ambisonic_binaural[i]);
+        group->ambisonic_binaural[i] = NULL;
+    }
+}
+
+// Build the group's binaural decoding state for the mixer's HRTF and ambisonic order. This allocates, so it's done on
+//  the app's thread whenever either of those change, never during a mix; a group without it decodes to speakers.
+// Mixer must be locked.
+static void CreateGroupAmbisonicBinaural(MIX_Mixer *mixer, MIX_Group *group)
+{
+    if (mixer->hrtf && (mixer->ambisonic_order > 0)) {
+        for (int i = 0; i < mixer->ambisonic_virtual_speakers; i++) {
+            if (!group->ambisonic_binaural[i]) {
+                group->ambisonic_binaural[i] = MIX_CreateBinauralState(mixer->hrtf);  // if this fails, the group decodes to speakers.
+            }
+        }
+    }
+}
+
+// Give a track the state it needs to render through the mixer's HRTF. This allocates, so it's done on the app's
+//  thread before the track goes 3D or when the HRTF changes, never during a mix; a 3D track without it is just panned.
+// this assumes LockMixer(mixer) and LockTrack(track) were called before this.
+static void CreateTrackBinaural(MIX_Mixer *mixer, MIX_Track *track)
+{
+    if (mixer->hrtf && !track->binaural) {
+        track->binaural = MIX_CreateBinauralState(mixer->hrtf);  // if this fails, the track is just panned.
+    }
+}
+
+// Give `track` its binaural state before it goes 3D. Batched positions are applied during a mix, which can't
+//  allocate, so this is done on the app's thread when they're recorded, too; applying them just uses what's here.
+//  It only locks the mixer (for its HRTF) if the track isn't 3D yet, not on every move.
+// this assumes neither the mixer nor the track are locked.
+static void PrepareTrackBinaural(MIX_Track *track)
+{
+    MIX_Mixer *mixer = track->mixer;
+
+    LockTrack(track);
+    const bool needed = (track->spatialization_mode != MIX_SPATIALIZATION_3D) && !track->binaural;
+    UnlockTrack(track);
+
+    if (needed) {
+        LockMixer(mixer);
+        LockTrack(track);
+        CreateTrackBinaural(mixer, track);
+        UnlockTrack(track);
+        UnlockMixer(mixer);
+    }
+}
+
+// Rebuild the ambisonic decoding matrices for the mixer's current order and speaker layout. Mixer must be locked.
+static void BuildAmbisonicDecoders(MIX_Mixer *mixer)
+{
+    if (mixer->ambisonic_order > 0) {
+        MIX_BuildAmbisonicDecoder(mixer->ambisonic_order, mixer->spec.channels, mixer->ambisonic_decoder);
+        mixer->ambisonic_virtual_speakers = MIX_BuildAmbisonicVirtualSpeakers(mixer->ambisonic_order, mixer->ambisonic_virtual_decoder, mixer->ambisonic_virtual_radians);
+    }
+}
+
+// Occlusion and obstruction both muffle a track: the more of it is blocked, the lower the low-pass cutoff, from
+//  MIX_LOWPASS_MAX_CUTOFF down MIX_LOWPASS_OCTAVES octaves. Occlusion also makes it quieter, since everything has
+//  to go through the wall; obstructed sound still gets around whatever is in the way.
+// this assumes LockTrack(track) was called before this.
+#define MIX_LOWPASS_MAX_CUTOFF 20000.0f
+#define MIX_LOWPASS_OCTAVES 7.0f
+#define MIX_OCCLUSION_MAX_ATTENUATION 0.75f
+static void UpdateTrackLowpass(const MIX_Mixer *mixer, MIX_Track *track)
+{
+    const float amount = 1.0f - ((1.0f - track->occlusion) * (1.0f - track->obstruction));
+    track->occlusion_gain = 1.0f - (track->occlusion * MIX_OCCLUSION_MAX_ATTENUATION);
+    if (amount <= 0.0f) {
+        track->lowpass_coefficient = 1.0f;
+    } else {
+        const float freq = (float) mixer->spec.freq;
+        const float cutoff = SDL_min(MIX_LOWPASS_MAX_CUTOFF * SDL_powf(2.0f, -amount * MIX_LOWPASS_OCTAVES), freq * 0.45f);
+        track->lowpass_coefficient = 1.0f - SDL_expf((-2.0f * SDL_PI_F * cutoff) / freq);
+    }
+}
+
+// The reverb's delay lines are allocated for the longest room at a given sample rate, so changing the room size never
+//  allocates. MIX_ReverbLineMs are the lines' lengths at a room_size of zero; no two share a common factor, so their
+//  echoes don't pile up on the same frames. A room_size of 1.0f makes them MIX_REVERB_MAX_ROOM_SCALE times longer.
+#define MIX_REVERB_MAX_ROOM_SCALE 4.0f
+static const float MIX_ReverbLineMs[MIX_REVERB_LINES] = { 14.9f, 18.3f, 20.3f, 22.9f, 26.1f, 29.3f, 33.1f, 37.7f };
+
+static void DestroyReverbState(MIX_ReverbState *reverb)
+{
+    if (reverb) {
+        SDL_aligned_free(reverb->lines);
+        SDL_free(reverb->predelay);
+        SDL_aligned_free(reverb);
+    }
+}
+
+static MIX_ReverbState *CreateReverbState(const MIX_Reverb *params, const int freq)
+{
+    // feedback and damping_state are loaded with aligned SIMD loads, and calloc might only align to 8 bytes.
+    MIX_ReverbState *reverb = (MIX_ReverbState *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), sizeof (*reverb));
+    if (!reverb) {
+        return NULL;
+    }
+    SDL_zerop(reverb);
+
+    SDL_copyp(&reverb->params, params);
+    reverb->changed = true;
+    reverb->idle = true;
+    reverb->freq = freq;
+    reverb->capacity = (int) SDL_ceilf((MIX_ReverbLineMs[MIX_REVERB_LINES - 1] * MIX_REVERB_MAX_ROOM_SCALE * freq) / 1000.0f);
+    reverb->predelay_capacity = ((MIX_REVERB_MAX_PREDELAY_MS * freq) / 1000) + 1;
+    reverb->lines = (float *) SDL_aligned_alloc(SDL_GetSIMDAlignment(), reverb->capacity * MIX_REVERB_LINES * sizeof (float));
+    reverb->predelay = (float *) SDL_calloc(reverb->predelay_capacity, sizeof (float));
+    if (!reverb->lines || !reverb->predelay) {
+        DestroyReverbState(reverb);
+        return NULL;
+    }
+    SDL_memset(reverb->lines, '\0', reverb->capacity * MIX_REVERB_LINES * sizeof (float));
+    return reverb;
+}
+
+// The listener, speed of sound, speaker layout and sample rate only change with the mixer locked, but the mixer is
+//  locked for a whole mix, so track setters read them without it. Writers bump spatial_sequence around their changes
+//  (a seqlock: odd while changing), and readers do their work again if it moved in the meantime.
+// this assumes LockMixer(mixer) was called before this.
+static void BeginSpatialChange(MIX_Mixer *mixer)
+{
+    SDL_SetAtomicU32(&mixer->spatial_sequence, SDL_GetAtomicU32(&mixer->spatial_sequence) + 1);
+    SDL_MemoryBarrierRelease();
+}
+
+static void EndSpatialChange(MIX_Mixer *mixer)
+{
+    SDL_MemoryBarrierRelease();
+    SDL_SetAtomicU32(&mixer->spatial_sequence, SDL_GetAtomicU32(&mixer->spatial_sequence) + 1);
+}
+
+static Uint32 BeginSpatialRead(MIX_Mixer *mixer)
+{
+    Uint32 sequence;
+    while ((sequence = SDL_GetAtomicU32(&mixer->spatial_sequence)) & 1) {
+        SDL_CPUPauseInstruction();  // a change is in progress; it's quick.
+    }
+    SDL_MemoryBarrierAcquire();
+    return sequence;
+}
+
+static bool EndSpatialRead(MIX_Mixer *mixer, Uint32 sequence)
+{
+    SDL_MemoryBarrierAcquire();
+    return (SDL_GetAtomicU32(&mixer->spatial_sequence) == sequence);
+}
+
 // catch events to see if output device format has changed. This can let us move to/from surround sound support on the fly, not to mention spend less time doing unnecessary conversions.
 static bool SDLCALL AudioDeviceChangeEventWatcher(void *userdata, SDL_Event *event)
 {
@@ -207,15 +529,56 @@ static bool SDLCALL AudioDeviceChangeEventWatcher(void *userdata, SDL_Event *eve
     LockMixer(mixer);
 
     // adjust all our output streams to the new format.
-    if (SDL_GetAudioStreamFormat(mixer->output_stream, NULL, &mixer->spec)) {
+    BeginSpatialChange(mixer);  // track setters read the sample rate and speaker layout without locking the mixer.
+    const bool changed = SDL_GetAudioStreamFormat(mixer->output_stream, NULL, &mixer->spec);
+    if (changed) {
         mixer->spec.format = SDL_AUDIO_F32;
+        MIX_VBAP2D_Init(&mixer->vbap2d, mixer->spec.channels);  // deal with channel count changing.
+    }
+    EndSpatialChange(mixer);
+
+    if (changed) {
         if (SDL_SetAudioStreamFormat(mixer->output_stream, &mixer->spec, NULL)) {
-            MIX_VBAP2D_Init(&mixer->vbap2d, mixer->spec.channels);  // deal with channel count changing.
+            BuildAmbisonicDecoders(mixer);
+            ReserveRealtimeBuffers(mixer);  // if this fails, MixerCallback will just have to grow them itself.
+            bool rebuilt_hrtf = false;
+            if (mixer->hrtf && (mixer->hrtf->freq != mixer->spec.freq)) {  // if this fails, binaural rendering is skipped until the rate matches again.
+                MIX_HRTF *hrtf = MIX_CreateHRTF(mixer->hrtf->hrirs, mixer->hrtf->num_hrirs, mixer->hrtf->hrir_frames, mixer->hrtf->hrir_freq, mixer->spec.freq);
+                if (hrtf) {
+                    MIX_DestroyHRTF(mixer->hrtf);
+                    mixer->hrtf = hrtf;
+                    rebuilt_hrtf = true;
+                }
+            }
+            if (rebuilt_hrtf) {  // the old states point to the old HRTF.
+                for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+                    FreeGroupAmbisonicBinaural(group);
+                    CreateGroupAmbisonicBinaural(mixer, group);
+                }
+            }
+            for (int bus = 0; bus < MIX_MAX_SEND_BUSES; bus++) {
+                MIX_ReverbState *reverb = mixer->send_buses[bus].reverb;
+                if (reverb && (reverb->freq != mixer->spec.freq)) {  // if this fails, the old delay lines are used, and long rooms get a little shorter.
+                    MIX_ReverbState *resized = CreateReverbState(&reverb->params, mixer->spec.freq);
+                    if (resized) {
+                        DestroyReverbState(reverb);
+                        mixer->send_buses[bus].reverb = resized;
+                    } else {
+                        reverb->changed = true;
+                    }
+                }
+            }
             for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
                 LockTrack(track);
                 SetTrackOutputStreamFormat(track, NULL);   // input is from internal_stream, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
                 if (track->spatialization_mode == MIX_SPATIALIZATION_3D) {  // deal with channel count changing.
-                    MIX_Spatialize(&track->mixer->vbap2d, track->position3d, track->spatialization_panning, track->spatialization_speakers);
+                    MIX_Spatialize(&mixer->vbap2d, &mixer->listener3d, track->position3d, track->spatialization_panning, track->spatialization_speakers, &track->spatialization_radians);
+                }
+                UpdateTrackLowpass(mixer, track);  // the cutoff depends on the sample rate.
+                if (rebuilt_hrtf && track->binaural) {  // the old state points to the old HRTF.
+                    MIX_DestroyBinauralState(track->binaural);
+                    track->binaural = NULL;
+                    CreateTrackBinaural(mixer, track);
                 }
                 UnlockTrack(track);
             }
@@ -231,62 +594,207 @@ static void TrackStopped(MIX_Track *track)
 {
     SDL_assert(track->state != MIX_STATE_STOPPED);  // shouldn't be already stopped at this point.
     track->state = MIX_STATE_STOPPED;
+    track->mixed_panning_valid = false;  // if this plays again, don't ramp from where it was last time.
+    track->mixed_ambisonic_valid = false;
+    track->lowpass_state = 0.0f;
+    if (track->binaural) {
+        track->binaural->primed = false;  // ...and don't let the end of this play bleed into the next one.
+    }
     if (track->stopped_callback) {
+        const Uint64 callback_start = SDL_GetTicksNS();
         track->stopped_callback(track->stopped_callback_userdata, track);
+        AddPendingStat(&track->mixer->pending_stats.app_callback_ns, SDL_GetTicksNS() - callback_start);
     }
     if (track->fire_and_forget) {
         SDL_assert(!track->stopped_callback);  // these shouldn't have stopped callbacks.
         SDL_assert(track->state == MIX_STATE_STOPPED);  // should not have changed, shouldn't have a stopped_callback, etc.
         SDL_assert(track->fire_and_forget_next == NULL);  // shouldn't be in the list at all right now.
-        MIX_SetTrackAudio(track, NULL);
+        // in real-time-safe mode, tearing down the decoder and audio waits for MIX_Update() or MIX_PlayAudio() on the app's thread.
+        if (track->mixer->realtime_frames == 0) {
+            MIX_SetTrackAudio(track, NULL);
+        }
+
+        // this might be running on a render thread while the device thread holds the mixer lock and waits for it,
+        //  so don't lock the mixer here. Push it on a lock-free stack that gets moved to the pool later.
         MIX_Mixer *mixer = track->mixer;
-        LockMixer(mixer);
+        MIX_Track *head;
+        do {
+            head = (MIX_Track *) SDL_GetAtomicPointer((void **) &mixer->fire_and_forget_returns);
+            track->fire_and_forget_next = head;
+        } while (!SDL_CompareAndSwapAtomicPointer((void **) &mixer->fire_and_forget_returns, head, track));
+    }
+}
+
+// this assumes LockMixer(mixer) was called before this.
+static void ReclaimFireAndForgetTracks(MIX_Mixer *mixer)
+{
+    MIX_Track *track = (MIX_Track *) SDL_SetAtomicPointer((void **) &mixer->fire_and_forget_returns, NULL);
+    while (track) {
+        MIX_Track *next = track->fire_and_forget_next;
         track->fire_and_forget_next = mixer->fire_and_forget_pool;
         mixer->fire_and_forget_pool = track;
-        UnlockMixer(mixer);
+        track = next;
     }
 }
 
-static void ApplyFade(MIX_Track *track, int channels, float *pcm, int frames)
+// Fades are applied in blocks of this many sample frames; we calculate each block's gains up front, then
+//  multiply them in with SIMD. Each block restarts the curve from its exact position, so no error builds up.
+#define MIX_FADE_BLOCK_FRAMES 64
+
+// ln(1000): the exponential curve covers ~60dB, then the last bit snaps to silence.
+#define MIX_FADE_EXPONENTIAL_RANGE 6.907755f
+
+// Fill in `gains` with the curve's value for `frames` sample frames, starting at `x` (0.0: silence, 1.0: full volume),
+//  and moving by `dx` each sample frame. No divisions or transcendental functions per sample frame.
+static void CalculateFadeGains(const MIX_FadeCurve curve, float *gains, const int frames, const float x, const float dx)
+{
+    switch (curve) {
+        case MIX_FADE_CURVE_EQUAL_POWER: {
+            // sin(x * pi/2), stepped by rotating a (sin, cos) pair.
+            const float angle = x * (SDL_PI_F / 2.0f);
+            const float step = dx * (SDL_PI_F / 2.0f);
+            const float step_sin = SDL_sinf(step);
+            const float step_cos = SDL_cosf(step);
+            float s = SDL_sinf(angle);
+            float c = SDL_cosf(angle);
+            for (int i = 0; i < frames; i++) {
+                gains[i] = s;
+                const float next_s = (s * step_cos) + (c * step_sin);
+                c = (c * step_cos) - (s * step_sin);
+                s = next_s;
+            }
+            break;
+        }
+
+        case MIX_FADE_CURVE_EXPONENTIAL: {
+            // (e^(k*x) - 1) / (e^k - 1), stepped by multiplying by e^(k*dx).
+            const float scale = 1.0f / (SDL_expf(MIX_FADE_EXPONENTIAL_RANGE) - 1.0f);
+            const float ratio = SDL_expf(MIX_FADE_EXPONENTIAL_RANGE * dx);
+            float u = SDL_expf(MIX_FADE_EXPONENTIAL_RANGE * x);
+            for (int i = 0; i < frames; i++) {
+                gains[i] = (u - 1.0f) * scale;
+                u *= ratio;
+            }
+            break;
+        }
+
+        default:
+            SDL_assert(curve == MIX_FADE_CURVE_LINEAR);
+            for (int i = 0; i < frames; i++) {
+                gains[i] = x + (dx * (float) i);
+            }
+            break;
+    }
+}
+
+static void ApplyFadeGains_scalar(float *pcm, const int channels, const float *gains, const int frames)
+{
+    for (int i = 0; i < frames; i++) {
+        const float gain = gains[i];
+        for (int j = 0; j < channels; j++) {
+            *(pcm++) *= gain;
+        }
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") ApplyFadeGains_sse(float *pcm, const int channels, const float *gains, const int frames)
+{
+    int i = 0;
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4, pcm += 4) {
+            _mm_storeu_ps(pcm, _mm_mul_ps(_mm_loadu_ps(pcm), _mm_loadu_ps(gains + i)));
+        }
+    } else if (channels == 2) {
+        for (; i + 4 <= frames; i += 4, pcm += 8) {
+            const __m128 g = _mm_loadu_ps(gains + i);
+            _mm_storeu_ps(pcm, _mm_mul_ps(_mm_loadu_ps(pcm), _mm_unpacklo_ps(g, g)));
+            _mm_storeu_ps(pcm + 4, _mm_mul_ps(_mm_loadu_ps(pcm + 4), _mm_unpackhi_ps(g, g)));
+        }
+    } else {  // one gain per sample frame, splatted across the channels.
+        const int vectors = channels / 4;
+        const int leftover = channels % 4;
+        for (; i < frames; i++) {
+            const __m128 g = _mm_set1_ps(gains[i]);
+            for (int j = 0; j < vectors; j++, pcm += 4) {
+                _mm_storeu_ps(pcm, _mm_mul_ps(_mm_loadu_ps(pcm), g));
+            }
+            for (int j = 0; j < leftover; j++) {
+                *(pcm++) *= gains[i];
+            }
+        }
+    }
+    ApplyFadeGains_scalar(pcm, channels, gains + i, frames - i);  // whatever is left over.
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void ApplyFadeGains_neon(float *pcm, const int channels, const float *gains, const int frames)
+{
+    int i = 0;
+    if (channels == 1) {
+        for (; i + 4 <= frames; i += 4, pcm += 4) {
+            vst1q_f32(pcm, vmulq_f32(vld1q_f32(pcm), vld1q_f32(gains + i)));
+        }
+    } else if (channels == 2) {
+        for (; i + 4 <= frames; i += 4, pcm += 8) {
+            const float32x4_t g = vld1q_f32(gains + i);
+            const float32x4x2_t z = vzipq_f32(g, g);
+            vst1q_f32(pcm, vmulq_f32(vld1q_f32(pcm), z.val[0]));
+            vst1q_f32(pcm + 4, vmulq_f32(vld1q_f32(pcm + 4), z.val[1]));
+        }
+    } else {  // one gain per sample frame, splatted across the channels.
+        const int vectors = channels / 4;
+        const int leftover = channels % 4;
+        for (; i < frames; i++) {
+            for (int j = 0; j < vectors; j++, pcm += 4) {
+                vst1q_f32(pcm, vmulq_n_f32(vld1q_f32(pcm), gains[i]));
+            }
+            for (int j = 0; j < leftover; j++) {
+                *(pcm++) *= gains[i];
+            }
+        }
+    }
+    ApplyFadeGains_scalar(pcm, channels, gains + i, frames - i);  // whatever is left over.
+}
+#endif
+
+static void ApplyFadeGains(float *pcm, const int channels, const float *gains, const int frames)
 {
-    // !!! FIXME: this is probably pretty naive.
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        ApplyFadeGains_sse(pcm, channels, gains, frames);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        ApplyFadeGains_neon(pcm, channels, gains, frames);
+    } else
+    #endif
+    {
+        ApplyFadeGains_scalar(pcm, channels, gains, frames);
+    }
+}
 
+static void ApplyFade(MIX_Track *track, int channels, float *pcm, int frames)
+{
     if (track->fade_direction == 0) {
         return;  // no fade is happening, early exit.
     }
 
     const int to_be_faded = (int) SDL_min(track->fade_frames, frames);
-    const int total_fade_frames = (int) track->total_fade_frames;
-    int fade_frame_position = total_fade_frames - (int) track->fade_frames;
-
-    // some hacks to avoid a branch on each sample frame. Might not be a good idea in practice.
-    const float pctmult = (track->fade_direction < 0) ? 1.0f : -1.0f;
-    const float pctsub = (track->fade_direction < 0) ? 1.0f : 0.0f;
-    const float ftotal_fade_frames = (float) total_fade_frames;
-
-    for (int i = 0; i < to_be_faded; i++) {
-        const float pct = (pctsub - (((float) fade_frame_position) / ftotal_fade_frames)) * pctmult;
-        SDL_assert(pct >= 0.0f);
-        SDL_assert(pct <= 1.0f);
-        fade_frame_position++;
-
-        // use this fade percentage for the entire sample frame.
-        switch (channels) {   // !!! FIXME: profile this and see if this is a dumb idea.
-            case 8: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 7: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 6: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 5: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 4: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 3: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 2: *(pcm++) *= pct; SDL_FALLTHROUGH;
-            case 1: *(pcm++) *= pct; break;
-
-            default:  // catch any other number of channels.
-                for (int j = 0; j < channels; j++) {
-                    *(pcm++) *= pct;
-                }
-                break;
-        }
+    const double total_fade_frames = (double) track->total_fade_frames;
+    const double fade_frame_position = (double) (track->total_fade_frames - track->fade_frames);
+
+    // x is where we are on the fade curve, from 0.0 (silence) to 1.0 (full volume); fading out walks it backwards.
+    const bool fading_in = (track->fade_direction > 0);
+    const double x = fading_in ? (fade_frame_position / total_fade_frames) : (1.0 - (fade_frame_position / total_fade_frames));
+    const double dx = (fading_in ? 1.0 : -1.0) / total_fade_frames;
+
+    float SDL_ALIGNED(16) gains[MIX_FADE_BLOCK_FRAMES];
+    for (int i = 0; i < to_be_faded; i += MIX_FADE_BLOCK_FRAMES) {
+        const int block_frames = SDL_min(to_be_faded - i, MIX_FADE_BLOCK_FRAMES);
+        CalculateFadeGains(track->fade_curve, gains, block_frames, (float) (x + (dx * i)), (float) dx);
+        ApplyFadeGains(pcm + (i * channels), channels, gains, block_frames);
     }
 
     track->fade_frames -= to_be_faded;
@@ -303,230 +811,4039 @@ static bool DecodeMore(MIX_Track *track, int bytes_needed)
 {
     SDL_assert(track->input_audio != NULL);
 
+    const int start_available = SDL_GetAudioStreamAvailable(track->input_stream);
+    if (start_available >= bytes_needed) {
+        return true;  // already have enough.
+    }
+
+    const MIX_Decoder *decoder = track->input_audio->decoder;
+    const Uint64 start_ns = SDL_GetTicksNS();
     bool retval = true;
-    while (SDL_GetAudioStreamAvailable(track->input_stream) < bytes_needed) {
-        if (!track->input_audio->decoder->decode(track->decoder_userdata, track->input_stream)) {
+    do {
+        if (!decoder->decode(track->decoder_userdata, track->input_stream)) {
             SDL_FlushAudioStream(track->input_stream);  // make sure we read _everything_ now.
             retval = false;
             break;
         }
+    } while (SDL_GetAudioStreamAvailable(track->input_stream) < bytes_needed);
+
+    MIX_PendingStats *stats = &track->mixer->pending_stats;
+    AddPendingStat(&stats->decode_ns, SDL_GetTicksNS() - start_ns);
+
+    const int decoded_bytes = SDL_GetAudioStreamAvailable(track->input_stream) - start_available;
+    const int decoder_index = GetDecoderIndex(decoder);
+    if ((decoded_bytes > 0) && (decoder_index >= 0) && (decoder_index < MIX_MAX_STATS_DECODERS)) {
+        AddPendingStat(&stats->frames_decoded[decoder_index], decoded_bytes / (SDL_AUDIO_BYTESIZE(track->raw_format) * track->input_audio->spec.channels));
     }
 
     return retval;
 }
 
-static int FillSilenceFrames(MIX_Track *track, void *buffer, int channels, int buflen)
+// zero bytes are silence for both float32 and Sint16, so this works for any raw_format.
+static int FillSilenceFrames(MIX_Track *track, void *buffer, int framesize, int buflen)
 {
     SDL_assert(track->silence_frames > 0);
     SDL_assert(buflen > 0);
-    const int max_silence_bytes = (int) (track->silence_frames * channels * sizeof (float));
+    const int max_silence_bytes = (int) (track->silence_frames * framesize);
     const int br = SDL_min(buflen, max_silence_bytes);
     if (br) {
         SDL_memset(buffer, '\0', br);
-        track->silence_frames -= br / (channels * sizeof (float));
+        track->silence_frames -= br / framesize;
     }
     return br;
 }
 
-// This is called every time we try to pull more from a track's output_stream.
-// We generate more audio here on-demand, either from a decoder, or pulling
-// from another audio stream.
-// track->output_stream is locked when calling this.
-static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, int additional_amount, int total_amount)
-{
-    MIX_Track *track = (MIX_Track *) userdata;
-    SDL_assert(stream == track->output_stream);
-
-    if (additional_amount == 0) {
-        return;  // don't need to generate more audio yet.
-    } else if (track->state != MIX_STATE_PLAYING) {
-        return;  // paused or stopped, don't make progress.
-    }
-
-    SDL_assert(track->output_spec.format == SDL_AUDIO_F32);
-    SDL_assert(track->output_spec.freq == track->mixer->spec.freq);
+// Decode-ahead: worker threads run the decoders of tracks that asked for it, so the audio device thread
+//  just copies finished float32 frames out of a ring buffer. The ring has one producer (whatever worker
+//  holds da->lock) and one consumer (the track's TrackGetCallback), so it needs no locks itself.
+// App threads take da->lock before the track lock, never while holding it: a worker can hold da->lock for
+//  a whole chunk of decoding, and the audio device thread needs the track lock to mix.
 
-    SDL_AudioSpec raw_spec;
-    if (track->input_stream) {
-        SDL_GetAudioStreamFormat(track->input_stream, NULL, &raw_spec);
+// this assumes da->lock is held.
+static bool DecodeAheadWanted(MIX_DecodeAhead *da)
+{
+    if (!SDL_GetAtomicInt(&da->active) || SDL_GetAtomicInt(&da->finished)) {
+        return false;
+    } else if (SDL_GetAtomicInt(&da->waiters)) {
+        return false;  // the app is waiting to change the track; let it in.
+    } else if ((SDL_GetAtomicU32(&da->marks_write) - SDL_GetAtomicU32(&da->marks_read)) >= MIX_DECODE_AHEAD_MAX_MARKS) {
+        return false;  // mixer has to catch up on end-of-audio marks first.
     }
+    const Uint32 used = SDL_GetAtomicU32(&da->write_pos) - SDL_GetAtomicU32(&da->read_pos);
+    return (used <= (da->ring_frames / 2));  // don't bother waking up for tiny amounts.
+}
 
-    // do we need to grow our buffer?
-    if (additional_amount > track->input_buffer_len) {
-        void *ptr = SDL_realloc(track->input_buffer, additional_amount);
-        if (!ptr) {   // uhoh.
-            TrackStopped(track);
-            return;  // not much to be done, we're out of memory!
+// this assumes da->lock is held.
+static void FillDecodeAhead(MIX_DecodeAhead *da)
+{
+    MIX_Track *track = da->track;
+    SDL_assert(track->input_audio != NULL);
+    SDL_assert(da->channels > 0);
+
+    const int framesize = da->framesize;
+    const Uint32 mask = da->ring_frames - 1;
+
+    // stop between chunks if the app wants the lock, or stopped the track; a worker will pick this up again later.
+    while (!SDL_GetAtomicInt(&decode_ahead_shutdown) && SDL_GetAtomicInt(&da->active) && !SDL_GetAtomicInt(&da->waiters)) {
+        const Uint32 write_pos = SDL_GetAtomicU32(&da->write_pos);
+        const Uint32 used = write_pos - SDL_GetAtomicU32(&da->read_pos);
+        const Uint32 marks_write = SDL_GetAtomicU32(&da->marks_write);
+        if ((used >= da->ring_frames) || ((marks_write - SDL_GetAtomicU32(&da->marks_read)) >= MIX_DECODE_AHEAD_MAX_MARKS)) {
+            break;  // full up for now.
         }
-        track->input_buffer = (float *) ptr;
-        track->input_buffer_len = additional_amount;
-    }
 
-    float *pcm = track->input_buffer;  // we always work in float32 format.
-    const int output_framesize = SDL_AUDIO_FRAMESIZE(track->output_spec);
-    int bytes_remaining = additional_amount;
+        const Uint32 offset = write_pos & mask;
+        Sint64 frames = (Sint64) SDL_min(da->ring_frames - used, da->ring_frames - offset);  // don't wrap around in a single read.
+        frames = SDL_min(frames, MIX_DECODE_AHEAD_CHUNK_FRAMES);
 
-    // Calling TrackStopped() might have a stopped_callback that restarts the track, so don't break the loop
-    //  for simply being stopped, so we can generate audio without gaps. If not restarted, track->state will no longer be PLAYING.
-    while ((track->state == MIX_STATE_PLAYING) && (bytes_remaining > 0)) {
         bool end_of_audio = false;
-        int br = 0;   // bytes read.
+        if (da->max_frame >= 0) {
+            const Sint64 remaining = da->max_frame - da->decode_position;
+            if (remaining <= frames) {
+                frames = SDL_max(remaining, 0);
+                end_of_audio = true;
+            }
+        }
 
-        // make sure we're not trying to read half a sample frame.
-        bytes_remaining = SDL_max(bytes_remaining, output_framesize);
+        if (frames > 0) {
+            const int bytes = ((int) frames) * framesize;
+            DecodeMore(track, bytes);
+            int br = SDL_GetAudioStreamData(track->input_stream, da->ring + (offset * framesize), bytes);
+            if (br < 0) {
+                br = 0;   // decoding failure, treat it like EOF.
+            }
+            const int frames_read = br / framesize;
+            da->decode_position += frames_read;
+            SDL_SetAtomicU32(&da->write_pos, write_pos + (Uint32) frames_read);
+            if (frames_read < frames) {
+                end_of_audio = true;  // DecodeMore couldn't provide everything, so the decoder is out of data.
+            }
+        }
+
+        if (end_of_audio) {
+            // tell the mixer where the end is, then loop if we're supposed to, just like TrackGetCallback would.
+            da->marks[marks_write % MIX_DECODE_AHEAD_MAX_MARKS] = SDL_GetAtomicU32(&da->write_pos);
+            SDL_SetAtomicU32(&da->marks_write, marks_write + 1);
+            SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input is removed.
+
+            bool looped = false;
+            if (da->loops_remaining != 0) {
+                if (da->loops_remaining > 0) {  // negative means infinite loops, so don't decrement for that.
+                    da->loops_remaining--;
+                }
+                if (track->input_audio->decoder->seek(track->decoder_userdata, (Uint64) da->loop_start)) {
+                    da->decode_position = da->loop_start;
+                    looped = true;
+                }
+            }
+
+            if (!looped) {
+                SDL_SetAtomicInt(&da->finished, 1);
+                break;
+            }
+        }
+    }
+}
+
+// returns a MIX_DecodeAhead with its lock held, or NULL if nothing needs decoding right now.
+static MIX_DecodeAhead *ClaimDecodeAheadWork(void)
+{
+    MIX_DecodeAhead *retval = NULL;
+    SDL_LockMutex(decode_ahead_lock);
+    for (MIX_DecodeAhead *da = decode_ahead_list; da; da = da->next) {
+        // if the lock is busy, another worker has it, or the app is changing the track; either way, skip it for now.
+        if (SDL_TryLockMutex(da->lock)) {
+            if (DecodeAheadWanted(da)) {
+                retval = da;
+                break;
+            }
+            SDL_UnlockMutex(da->lock);
+        }
+    }
+    SDL_UnlockMutex(decode_ahead_lock);
+    return retval;
+}
+
+static int SDLCALL DecodeAheadThread(void *data)
+{
+    (void) data;
+    while (!SDL_GetAtomicInt(&decode_ahead_shutdown)) {
+        SDL_WaitSemaphoreTimeout(decode_ahead_sem, 10);  // wake up now and then even without a signal, in case a ring drained without us hearing about it.
+        MIX_DecodeAhead *da;
+        while (!SDL_GetAtomicInt(&decode_ahead_shutdown) && ((da = ClaimDecodeAheadWork()) != NULL)) {
+            FillDecodeAhead(da);
+            SDL_UnlockMutex(da->lock);
+        }
+    }
+    return 0;
+}
+
+static void WakeDecodeAheadWorkers(void)
+{
+    if (SDL_GetSemaphoreValue(decode_ahead_sem) == 0) {
+        SDL_SignalSemaphore(decode_ahead_sem);
+    }
+}
+
+static void QuitDecodeAheadPool(void)
+{
+    SDL_assert(decode_ahead_list == NULL);  // all tracks should have been destroyed first.
+
+    SDL_SetAtomicInt(&decode_ahead_shutdown, 1);
+    for (int i = 0; i < num_decode_ahead_threads; i++) {
+        SDL_SignalSemaphore(decode_ahead_sem);
+    }
+    for (int i = 0; i < num_decode_ahead_threads; i++) {
+        SDL_WaitThread(decode_ahead_threads[i], NULL);
+        decode_ahead_threads[i] = NULL;
+    }
+    num_decode_ahead_threads = 0;
+
+    SDL_DestroySemaphore(decode_ahead_sem);
+    decode_ahead_sem = NULL;
+    SDL_DestroyMutex(decode_ahead_lock);
+    decode_ahead_lock = NULL;
+    SDL_SetAtomicInt(&decode_ahead_shutdown, 0);
+}
+
+static bool StartDecodeAheadPool(void)
+{
+    bool retval = true;
+
+    LockGlobal();
+    if (num_decode_ahead_threads == 0) {
+        decode_ahead_lock = SDL_CreateMutex();
+        decode_ahead_sem = SDL_CreateSemaphore(0);
+        if (!decode_ahead_lock || !decode_ahead_sem) {
+            retval = false;
+        } else {
+            // decoding is usually cheap, so we don't need a thread per core; leave room for the app and the audio device.
+            const int total = SDL_clamp(SDL_GetNumLogicalCPUCores() / 2, 1, MIX_DECODE_AHEAD_MAX_THREADS);
+            for (int i = 0; i < total; i++) {
+                char name[32];
+                SDL_snprintf(name, sizeof (name), "MIX_DecodeAhead%d", i);
+                SDL_Thread *thread = SDL_CreateThread(DecodeAheadThread, name, NULL);
+                if (!thread) {
+                    break;
+                }
+                decode_ahead_threads[num_decode_ahead_threads++] = thread;
+            }
+            retval = (num_decode_ahead_threads > 0);
+        }
+
+        if (!retval) {
+            QuitDecodeAheadPool();
+        }
+    }
+    UnlockGlobal();
+
+    return retval;
+}
+
+static MIX_DecodeAhead *GetDecodeAhead(MIX_Track *track)
+{
+    return (MIX_DecodeAhead *) SDL_GetAtomicPointer((void **) &track->decode_ahead);
+}
+
+// Call this before LockTrack(track), never after. Returns what it locked, for UnlockDecodeAhead.
+static MIX_DecodeAhead *LockDecodeAhead(MIX_Track *track)
+{
+    MIX_DecodeAhead *da = GetDecodeAhead(track);
+    if (da) {
+        SDL_AddAtomicInt(&da->waiters, 1);  // make a worker give up the lock at the end of its current chunk.
+        SDL_LockMutex(da->lock);
+        SDL_AddAtomicInt(&da->waiters, -1);
+    }
+    return da;
+}
+
+static void UnlockDecodeAhead(MIX_DecodeAhead *da)
+{
+    if (da) {
+        SDL_UnlockMutex(da->lock);
+        WakeDecodeAheadWorkers();  // in case one gave up on this ring to let us in.
+    }
+}
+
+// Throw away anything decoded ahead and start over from the track's current state.
+// If `resync` is true, the decoder is moved back to track->position first, since it has probably run ahead of it.
+// this assumes LockDecodeAhead(track) and LockTrack(track) were called before this.
+static void ResetDecodeAhead(MIX_Track *track, bool resync)
+{
+    MIX_DecodeAhead *da = track->decode_ahead;
+    if (!da) {
+        return;
+    }
+
+    const bool was_decoding = (da->channels > 0);
+    SDL_SetAtomicInt(&da->active, 0);
+    SDL_SetAtomicInt(&da->finished, 0);
+    SDL_SetAtomicU32(&da->write_pos, 0);
+    SDL_SetAtomicU32(&da->read_pos, 0);
+    SDL_SetAtomicU32(&da->marks_write, 0);
+    SDL_SetAtomicU32(&da->marks_read, 0);
+    da->channels = 0;
+
+    if (!track->input_audio) {
+        return;  // streams (or no input at all) don't decode ahead.
+    } else if (da->requested_frames == 0) {  // turned off; the mixer decodes directly again.
+        if (resync && was_decoding) {
+            // the decoder has run ahead of the mix, put it back where the mixer expects it.
+            if (track->input_audio->decoder->seek(track->decoder_userdata, (Uint64) track->position)) {
+                SDL_ClearAudioStream(track->internal_stream);
+            }
+        }
+        SDL_free(da->ring);
+        da->ring = NULL;
+        da->ring_allocation = 0;
+        return;
+    }
+
+    if (resync && !track->input_audio->decoder->seek(track->decoder_userdata, (Uint64) track->position)) {
+        return;  // uhoh, leave the ring disabled; the mixer will decode directly and figure out the problem.
+    }
+    SDL_ClearAudioStream(track->internal_stream);   // the ring is where decoded data goes now.
+
+    const int channels = track->input_audio->spec.channels;
+    const int framesize = channels * SDL_AUDIO_BYTESIZE(track->raw_format);
+    const size_t needed = ((size_t) da->ring_frames) * framesize;
+    if (needed > da->ring_allocation) {
+        void *ptr = SDL_realloc(da->ring, needed);
+        if (!ptr) {
+            return;  // out of memory, leave the ring disabled.
+        }
+        da->ring = (Uint8 *) ptr;
+        da->ring_allocation = needed;
+    }
+
+    da->channels = channels;
+    da->framesize = framesize;
+    da->decode_position = (Sint64) track->position;
+    da->max_frame = track->max_frame;
+    da->loop_start = track->loop_start;
+    da->loops_remaining = track->loops_remaining;
+
+    if (track->state != MIX_STATE_STOPPED) {
+        SDL_SetAtomicInt(&da->active, 1);
+        WakeDecodeAheadWorkers();
+    }
+}
+
+// only MIX_DestroyTrack calls this, after the track is out of the mixer; anywhere else, a MIX_DecodeAhead is just turned off.
+static void DestroyDecodeAhead(MIX_Track *track)
+{
+    MIX_DecodeAhead *da = GetDecodeAhead(track);
+    if (!da) {
+        return;
+    }
+
+    // take it out of the worker pool first, so no worker can claim it again...
+    SDL_LockMutex(decode_ahead_lock);
+    if (da->prev) {
+        da->prev->next = da->next;
+    } else {
+        decode_ahead_list = da->next;
+    }
+    if (da->next) {
+        da->next->prev = da->prev;
+    }
+    SDL_UnlockMutex(decode_ahead_lock);
+
+    // ...then wait out any worker that's decoding for it right now.
+    LockDecodeAhead(track);
+    LockTrack(track);
+    SDL_SetAtomicPointer((void **) &track->decode_ahead, NULL);
+    UnlockTrack(track);
+    SDL_UnlockMutex(da->lock);
+
+    SDL_DestroyMutex(da->lock);
+    SDL_free(da->ring);
+    SDL_free(da);
+}
+
+// Pull decoded frames out of the ring. Returns bytes read into `buffer`, zero at the end of the audio,
+//  or -1 if the workers haven't decoded anything yet (an underrun). Sets *exhausted if the workers
+//  won't produce more data (decoding failure, couldn't seek to loop, etc) until the next reset.
+// this is called from TrackGetCallback, with the track locked. It does not ever block on the workers.
+static int ReadDecodeAhead(MIX_DecodeAhead *da, void *buffer, int buflen, bool *exhausted)
+{
+    const int framesize = da->framesize;
+    const Uint32 max_frames = (Uint32) (buflen / framesize);
+
+    *exhausted = false;
+
+    if (max_frames == 0) {
+        return -1;  // not enough room for a single sample frame, try again later.
+    }
+
+    const bool finished = (SDL_GetAtomicInt(&da->finished) != 0);  // check this first: any marks pushed before this was set will be visible below.
+    const Uint32 read_pos = SDL_GetAtomicU32(&da->read_pos);
+    Uint32 available = SDL_GetAtomicU32(&da->write_pos) - read_pos;
+
+    const Uint32 marks_read = SDL_GetAtomicU32(&da->marks_read);
+    if (marks_read != SDL_GetAtomicU32(&da->marks_write)) {
+        const Uint32 until_mark = da->marks[marks_read % MIX_DECODE_AHEAD_MAX_MARKS] - read_pos;
+        if (until_mark == 0) {
+            SDL_SetAtomicU32(&da->marks_read, marks_read + 1);
+            WakeDecodeAheadWorkers();  // in case the worker was waiting on free marks.
+            return 0;  // end of audio.
+        }
+        available = SDL_min(available, until_mark);
+    }
+
+    if (available == 0) {
+        if (finished) {
+            *exhausted = true;
+            return 0;
+        }
+        SDL_AddAtomicInt(&da->underruns, 1);
+        SDL_SignalSemaphore(decode_ahead_sem);
+        return -1;
+    }
+
+    const Uint32 frames = SDL_min(available, max_frames);
+    const Uint32 offset = read_pos & (da->ring_frames - 1);
+    const Uint32 first = SDL_min(frames, da->ring_frames - offset);
+    SDL_memcpy(buffer, da->ring + (offset * framesize), first * framesize);
+    if (first < frames) {  // wrapped around the end of the ring.
+        SDL_memcpy(((Uint8 *) buffer) + (first * framesize), da->ring, (frames - first) * framesize);
+    }
+    SDL_SetAtomicU32(&da->read_pos, read_pos + frames);
+
+    if ((SDL_GetAtomicU32(&da->write_pos) - (read_pos + frames)) <= (da->ring_frames / 2)) {
+        WakeDecodeAheadWorkers();
+    }
+
+    return (int) (frames * framesize);
+}
+
+// Float32 audio sitting in memory (predecoded to the mixer's format, or loaded raw that way) doesn't need a decoder
+//  or internal_stream at all; tracks can copy it straight out of the precache, using track->position as the offset.
+static bool IsDirectAudio(const MIX_Audio *audio)
+{
+    return audio && audio->precache && (audio->decoder == &MIX_Decoder_RAW) && (audio->spec.format == SDL_AUDIO_F32);
+}
+
+// Returns a pointer to up to `buflen` bytes of `track`'s audio at its current position, and how many bytes that is in `*br`.
+static const float *ReadDirectAudio(MIX_Track *track, int buflen, int *br)
+{
+    const MIX_Audio *audio = track->input_audio;
+    const int framesize = SDL_AUDIO_FRAMESIZE(audio->spec);
+    const Uint64 total_frames = (Uint64) (audio->precachelen / framesize);
+    if (track->position >= total_frames) {
+        *br = 0;
+        return NULL;
+    }
+
+    const Uint64 frames = SDL_min((Uint64) (buflen / framesize), total_frames - track->position);
+    *br = (int) (frames * framesize);
+    return (const float *) (((const Uint8 *) audio->precache) + (track->position * framesize));
+}
+
+// Sint16 audio goes from internal_stream to output_stream untouched, so SDL converts it to float32 in the same
+//  pass that resamples it. Raw callbacks and fades still work in float32, so these convert it in place for them;
+//  `buffer` needs room for the float32 version.
+static void ConvertSint16ToFloat32(void *buffer, int samples)
+{
+    const Sint16 *src = (const Sint16 *) buffer;
+    float *dst = (float *) buffer;
+    for (int i = samples - 1; i >= 0; i--) {  // go backwards, since each float is bigger than the Sint16 it replaces.
+        dst[i] = ((float) src[i]) * (1.0f / 32768.0f);
+    }
+}
+
+static void ConvertFloat32ToSint16(void *buffer, int samples)
+{
+    const float *src = (const float *) buffer;
+    Sint16 *dst = (Sint16 *) buffer;
+    for (int i = 0; i < samples; i++) {
+        dst[i] = (Sint16) SDL_clamp(src[i] * 32768.0f, -32768.0f, 32767.0f);
+    }
+}
+
+// This is called every time we try to pull more from a track's output_stream.
+// We generate more audio here on-demand, either from a decoder, or pulling
+// from another audio stream.
+// track->output_stream is locked when calling this.
+static void SDLCALL TrackGetCallback(void *userdata, SDL_AudioStream *stream, int additional_amount, int total_amount)
+{
+    MIX_Track *track = (MIX_Track *) userdata;
+    SDL_assert(stream == track->output_stream);
+
+    if (additional_amount == 0) {
+        return;  // don't need to generate more audio yet.
+    } else if (track->state != MIX_STATE_PLAYING) {
+        return;  // paused or stopped, don't make progress.
+    }
+
+    SDL_assert(track->output_spec.format == SDL_AUDIO_F32);
+    SDL_assert(track->output_spec.freq == track->mixer->spec.freq);
+
+    SDL_AudioSpec raw_spec;
+    SDL_zero(raw_spec);
+    if (track->decode_ahead && track->input_audio && (track->decode_ahead->channels > 0)) {
+        // a worker might be feeding internal_stream right now; don't wait on its lock, we know what the format is.
+        raw_spec.format = track->raw_format;
+        raw_spec.channels = track->decode_ahead->channels;
+        raw_spec.freq = track->input_audio->spec.freq;
+    } else if (track->input_stream) {
+        SDL_GetAudioStreamFormat(track->input_stream, NULL, &raw_spec);
+    }
+
+    const bool raw_sint16 = (raw_spec.format == SDL_AUDIO_S16);
+    const int raw_samplesize = raw_sint16 ? (int) sizeof (Sint16) : (int) sizeof (float);
+    const int raw_framesize = SDL_max(raw_spec.channels, 1) * raw_samplesize;
+
+    SDL_AudioSpec callback_spec;  // raw callbacks always see float32, even if we convert it back afterwards.
+    SDL_copyp(&callback_spec, &raw_spec);
+    callback_spec.format = SDL_AUDIO_F32;
+
+    // do we need to grow our buffer? In real-time-safe mode we never allocate here; we work through it in smaller pieces below instead.
+    if ((additional_amount > track->input_buffer_len) && (track->mixer->realtime_frames == 0)) {
+        if (!GrowScratchBuffer(&track->input_buffer, &track->input_buffer_len, additional_amount)) {   // uhoh.
+            TrackStopped(track);
+            return;  // not much to be done, we're out of memory!
+        }
+        AddPendingStat(&track->mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    float *pcm = track->input_buffer;  // float32, unless it's Sint16 that nothing needs to change on the way to output_stream.
+    const int output_framesize = SDL_AUDIO_FRAMESIZE(track->output_spec);
+    int bytes_remaining = additional_amount;
+
+    // Calling TrackStopped() might have a stopped_callback that restarts the track, so don't break the loop
+    //  for simply being stopped, so we can generate audio without gaps. If not restarted, track->state will no longer be PLAYING.
+    while ((track->state == MIX_STATE_PLAYING) && (bytes_remaining > 0)) {
+        // the stopped callback might have changed the input, so check this every time through the loop.
+        const bool decoding_ahead = track->decode_ahead && track->input_audio && (track->decode_ahead->channels > 0);
+        bool input_exhausted = false;
+        bool end_of_audio = false;
+        const float *direct = NULL;  // if non-NULL, the data is here instead of `pcm`, and can't be changed.
+        int br = 0;   // bytes read.
+
+        // make sure we're not trying to read half a sample frame.
+        bytes_remaining = SDL_max(bytes_remaining, output_framesize);
+
+        // bytes_remaining is counted in float32 samples, so Sint16 input needs half as many bytes. If a raw callback or
+        //  fade needs that Sint16 as float32, though, it has to still fit in input_buffer once it doubles in size.
+        const bool convert_float32 = raw_sint16 && (track->raw_callback || (track->fade_direction != 0));
+        const size_t buffer_len = convert_float32 ? (track->input_buffer_len / 2) : track->input_buffer_len;
+        int chunk_bytes = SDL_max((bytes_remaining / (int) sizeof (float)) * raw_samplesize, raw_framesize);
+
+        // in real-time-safe mode, input_buffer might be smaller than what was asked for, so do it in pieces.
+        if ((size_t) chunk_bytes > buffer_len) {
+            chunk_bytes = (int) ((buffer_len / raw_framesize) * raw_framesize);
+            if (chunk_bytes <= 0) {
+                break;  // can't fit a single sample frame?!
+            }
+        }
 
         if (track->silence_frames > 0) {
             SDL_assert(track->input_stream != NULL);  // should have data bound if you landed here (we need raw_spec to be initialized).
-            br = FillSilenceFrames(track, pcm, raw_spec.channels, bytes_remaining);
+            br = FillSilenceFrames(track, pcm, raw_framesize, chunk_bytes);
+        } else if (decoding_ahead) {
+            br = ReadDecodeAhead(track->decode_ahead, pcm, chunk_bytes, &input_exhausted);
+            if (br < 0) {
+                break;  // the workers are behind; don't stall the device thread, just deliver what we have. This counts as an underrun.
+            }
+        } else if (IsDirectAudio(track->input_audio)) {
+            direct = ReadDirectAudio(track, chunk_bytes, &br);
+            if (direct && (track->raw_callback || (track->fade_direction != 0))) {
+                SDL_memcpy(pcm, direct, br);  // these change the data in-place, so they need a copy to work on.
+                direct = NULL;
+            }
         } else if (track->input_stream) {
             if (track->input_audio) {
-                DecodeMore(track, bytes_remaining);
+                DecodeMore(track, chunk_bytes);
+            }
+            br = SDL_GetAudioStreamData(track->input_stream, pcm, chunk_bytes);
+        }
+
+        // if input_audio and input_stream are both NULL, there's nothing to play (maybe they changed out the input on us?), br will be zero and we'll go to end_of_audio=true.
+
+        if (br <= 0) {  // if 0: EOF. if < 0: decoding/input failure, we're done by default. But maybe it'll loop and play the start again...!
+            end_of_audio = true;
+        } else {
+            SDL_assert(track->input_stream != NULL);  // should have data bound if you landed here.
+
+            // this (probably?) shouldn't be a partial read here. It's either we completely filled the buffer or exhausted the data.
+            //  as such, this does raw_callback() as likely the entire buffer, or all we're getting before a finish callback would have to fire,
+            //  even if the finish callback would restart the track. As such, the outer loop is mostly here to deal with looping tracks
+            //  and finish callbacks that restart the track.
+
+            // if this would put us past the end of maxframes, or a fadeout, clamp br and set end_of_audio=true so we can do looping, etc.
+            Sint64 maxpos = -1;
+            if (track->max_frame >= 0) {
+                maxpos = track->max_frame;
+            }
+            if (track->fade_direction < 0) {
+                const Sint64 maxfadepos = (Sint64) (track->position + track->fade_frames);
+                if ((maxpos < 0) || (maxfadepos < maxpos)) {
+                    maxpos = maxfadepos;
+                }
+            }
+
+            const int raw_channels = raw_spec.channels;
+
+            int frames_read = br / raw_framesize;
+            if (maxpos >= 0) {
+                const Sint64 newpos = (Sint64)(track->position + frames_read);
+                if (newpos >= maxpos) {  // we read past the end of the fade out or maxframes, we need to clamp.
+                    br -= (int)((newpos - maxpos) * raw_framesize);
+                    frames_read = br / raw_framesize;
+                    end_of_audio = true;
+                }
+            }
+
+            // give the app a shot at the final buffer before sending it on through transformations.
+            const int samples = frames_read * raw_channels;
+
+            if (convert_float32) {
+                ConvertSint16ToFloat32(pcm, samples);
+            }
+
+            if (track->raw_callback) {
+                const Uint64 callback_start = SDL_GetTicksNS();
+                track->raw_callback(track->raw_callback_userdata, track, &callback_spec, pcm, samples);
+                AddPendingStat(&track->mixer->pending_stats.app_callback_ns, SDL_GetTicksNS() - callback_start);
+            }
+
+            if (track->fade_direction != 0) {
+                const Uint64 fade_start = SDL_GetTicksNS();
+                ApplyFade(track, raw_channels, pcm, frames_read);
+                AddPendingStat(&track->mixer->pending_stats.mix_ns, SDL_GetTicksNS() - fade_start);
+            }
+
+            if (convert_float32) {
+                ConvertFloat32ToSint16(pcm, samples);
+            }
+
+            SDL_PutAudioStreamData(stream, direct ? direct : pcm, frames_read * raw_framesize);
+
+            track->position += frames_read;
+            bytes_remaining -= samples * (int) sizeof (float);  // this counts float32 samples, whatever raw_format is.
+        }
+
+        // remember that the callback in TrackStopped() might restart this track,
+        //  so we'll loop to see if we can fill in more audio without a gap even in that case.
+        if (end_of_audio) {
+            if (track->input_audio && !decoding_ahead) {
+                SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input is removed.
+            }
+            bool track_stopped = false;
+            if ((track->loops_remaining == 0) || input_exhausted) {
+                if (track->silence_frames < 0) {
+                    track->silence_frames = -track->silence_frames;  // time to start appending silence.
+                } else {
+                    track_stopped = true;  // out of data, no loops remain, no appended silence left, we're done.
+                }
+            } else {
+                if (track->loops_remaining > 0) {  // negative means infinite loops, so don't decrement for that.
+                    track->loops_remaining--;
+                }
+                if (!track->input_audio) {  // can't loop on a streaming input, you're done.
+                    track_stopped = true;
+                } else if (decoding_ahead) {
+                    track->position = track->loop_start;  // the worker already seeked and is decoding the next loop.
+                } else {
+                    if (!track->input_audio->decoder->seek(track->decoder_userdata, track->loop_start)) {
+                        track_stopped = true;  // uhoh, can't seek! Abandon ship!
+                    } else {
+                        track->position = track->loop_start;
+                    }
+                }
+            }
+
+            if (track_stopped) {
+                TrackStopped(track);
+            }
+        }
+    }
+}
+
+// Mono 3D tracks are panned between two speakers. panning0/panning1 already have the mixer gain applied.
+static void MixSpatializedFloat32Audio_scalar(float *dst, const float *src, const int samples, const int output_channels, const float panning0, const float panning1, const int speaker0, const int speaker1)
+{
+    if ((panning0 == 1.0f) && (panning1 == 1.0f)) {  // no modulation.
+        for (int i = 0; i < samples; i++, dst += output_channels, src++) {
+            const float sample = *src;
+            dst[speaker0] += sample;
+            dst[speaker1] += sample;
+        }
+    } else {
+        for (int i = 0; i < samples; i++, dst += output_channels, src++) {
+            const float sample = *src;
+            dst[speaker0] += sample * panning0;
+            dst[speaker1] += sample * panning1;
+        }
+    }
+}
+
+// build a gain for every output channel of a sample frame; zero for speakers this track doesn't hit.
+static void BuildSpatializedFrameGains(float *gains, const float panning0, const float panning1, const int speaker0, const int speaker1)
+{
+    SDL_memset(gains, '\0', sizeof (float) * 8);
+    gains[speaker0] += panning0;
+    gains[speaker1] += panning1;
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MixSpatializedFloat32Audio_sse(float *dst, const float *src, const int samples, const int output_channels, const float panning0, const float panning1, const int speaker0, const int speaker1)
+{
+    int i = 0;
+
+    if ((output_channels == 2) && (speaker0 != speaker1)) {  // stereo output, so speakers are 0 and 1 in some order.
+        const float left = (speaker0 == 0) ? panning0 : panning1;
+        const float right = (speaker0 == 0) ? panning1 : panning0;
+        const __m128 gains = _mm_setr_ps(left, right, left, right);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 8) {
+            const __m128 s = _mm_loadu_ps(src);
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_unpacklo_ps(s, s), gains)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), gains)));
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        float SDL_ALIGNED(16) g[8];
+        BuildSpatializedFrameGains(g, panning0, panning1, speaker0, speaker1);
+        const __m128 gains_lo = _mm_load_ps(g);
+        const __m128 gains_hi = _mm_load_ps(g + 4);
+        for (; i < samples; i++, src++, dst += 8) {
+            const __m128 s = _mm_set1_ps(*src);
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s, gains_lo)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(s, gains_hi)));
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        float SDL_ALIGNED(16) g[8];
+        BuildSpatializedFrameGains(g, panning0, panning1, speaker0, speaker1);
+        const __m128 gains_a = _mm_setr_ps(g[0], g[1], g[2], g[3]);
+        const __m128 gains_b = _mm_setr_ps(g[4], g[5], g[0], g[1]);
+        const __m128 gains_c = _mm_setr_ps(g[2], g[3], g[4], g[5]);
+        for (; i + 2 <= samples; i += 2, src += 2, dst += 12) {
+            const __m128 s0 = _mm_set1_ps(src[0]);
+            const __m128 s1 = _mm_set1_ps(src[1]);
+            const __m128 s01 = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(0, 0, 0, 0));
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s0, gains_a)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(s01, gains_b)));
+            _mm_storeu_ps(dst + 8, _mm_add_ps(_mm_loadu_ps(dst + 8), _mm_mul_ps(s1, gains_c)));
+        }
+    }
+
+    // whatever is left over (or everything, if there's no fast path for this layout).
+    MixSpatializedFloat32Audio_scalar(dst, src, samples - i, output_channels, panning0, panning1, speaker0, speaker1);
+}
+#endif
+
+#if defined(SDL_AVX2_INTRINSICS)
+static void SDL_TARGETING("avx2") MixSpatializedFloat32Audio_avx2(float *dst, const float *src, const int samples, const int output_channels, const float panning0, const float panning1, const int speaker0, const int speaker1)
+{
+    int i = 0;
+
+    if ((output_channels == 2) && (speaker0 != speaker1)) {  // stereo output, so speakers are 0 and 1 in some order.
+        const float left = (speaker0 == 0) ? panning0 : panning1;
+        const float right = (speaker0 == 0) ? panning1 : panning0;
+        const __m256 gains = _mm256_setr_ps(left, right, left, right, left, right, left, right);
+        const __m256i lo = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+        const __m256i hi = _mm256_setr_epi32(4, 4, 5, 5, 6, 6, 7, 7);
+        for (; i + 8 <= samples; i += 8, src += 8, dst += 16) {
+            const __m256 s = _mm256_loadu_ps(src);
+            _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), _mm256_mul_ps(_mm256_permutevar8x32_ps(s, lo), gains)));
+            _mm256_storeu_ps(dst + 8, _mm256_add_ps(_mm256_loadu_ps(dst + 8), _mm256_mul_ps(_mm256_permutevar8x32_ps(s, hi), gains)));
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly one register.
+        float SDL_ALIGNED(32) g[8];
+        BuildSpatializedFrameGains(g, panning0, panning1, speaker0, speaker1);
+        const __m256 gains = _mm256_load_ps(g);
+        for (; i < samples; i++, src++, dst += 8) {
+            _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), _mm256_mul_ps(_mm256_set1_ps(*src), gains)));
+        }
+    } else if (output_channels == 6) {  // 5.1: four sample frames are exactly three registers.
+        float SDL_ALIGNED(32) g[8];
+        BuildSpatializedFrameGains(g, panning0, panning1, speaker0, speaker1);
+        const __m256 gains_a = _mm256_setr_ps(g[0], g[1], g[2], g[3], g[4], g[5], g[0], g[1]);
+        const __m256 gains_b = _mm256_setr_ps(g[2], g[3], g[4], g[5], g[0], g[1], g[2], g[3]);
+        const __m256 gains_c = _mm256_setr_ps(g[4], g[5], g[0], g[1], g[2], g[3], g[4], g[5]);
+        const __m256i idx_a = _mm256_setr_epi32(0, 0, 0, 0, 0, 0, 1, 1);
+        const __m256i idx_b = _mm256_setr_epi32(1, 1, 1, 1, 2, 2, 2, 2);
+        const __m256i idx_c = _mm256_setr_epi32(2, 2, 3, 3, 3, 3, 3, 3);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 24) {
+            const __m256 s = _mm256_castps128_ps256(_mm_loadu_ps(src));
+            _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), _mm256_mul_ps(_mm256_permutevar8x32_ps(s, idx_a), gains_a)));
+            _mm256_storeu_ps(dst + 8, _mm256_add_ps(_mm256_loadu_ps(dst + 8), _mm256_mul_ps(_mm256_permutevar8x32_ps(s, idx_b), gains_b)));
+            _mm256_storeu_ps(dst + 16, _mm256_add_ps(_mm256_loadu_ps(dst + 16), _mm256_mul_ps(_mm256_permutevar8x32_ps(s, idx_c), gains_c)));
+        }
+    }
+
+    // whatever is left over (or everything, if there's no fast path for this layout).
+    MixSpatializedFloat32Audio_sse(dst, src, samples - i, output_channels, panning0, panning1, speaker0, speaker1);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MixSpatializedFloat32Audio_neon(float *dst, const float *src, const int samples, const int output_channels, const float panning0, const float panning1, const int speaker0, const int speaker1)
+{
+    int i = 0;
+
+    if ((output_channels == 2) && (speaker0 != speaker1)) {  // stereo output, so speakers are 0 and 1 in some order.
+        const float left = (speaker0 == 0) ? panning0 : panning1;
+        const float right = (speaker0 == 0) ? panning1 : panning0;
+        const float32x2_t pair = vset_lane_f32(right, vdup_n_f32(left), 1);
+        const float32x4_t gains = vcombine_f32(pair, pair);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 8) {
+            const float32x4_t s = vld1q_f32(src);
+            const float32x4x2_t z = vzipq_f32(s, s);
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), z.val[0], gains));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), z.val[1], gains));
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        float SDL_ALIGNED(16) g[8];
+        BuildSpatializedFrameGains(g, panning0, panning1, speaker0, speaker1);
+        const float32x4_t gains_lo = vld1q_f32(g);
+        const float32x4_t gains_hi = vld1q_f32(g + 4);
+        for (; i < samples; i++, src++, dst += 8) {
+            const float32x4_t s = vdupq_n_f32(*src);
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s, gains_lo));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), s, gains_hi));
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        float SDL_ALIGNED(16) g[8];
+        BuildSpatializedFrameGains(g, panning0, panning1, speaker0, speaker1);
+        const float32x4_t gains_a = vld1q_f32(g);
+        const float32x4_t gains_b = vcombine_f32(vld1_f32(g + 4), vld1_f32(g));
+        const float32x4_t gains_c = vld1q_f32(g + 2);
+        for (; i + 2 <= samples; i += 2, src += 2, dst += 12) {
+            const float32x4_t s0 = vdupq_n_f32(src[0]);
+            const float32x4_t s1 = vdupq_n_f32(src[1]);
+            const float32x4_t s01 = vcombine_f32(vget_low_f32(s0), vget_low_f32(s1));
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s0, gains_a));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), s01, gains_b));
+            vst1q_f32(dst + 8, vmlaq_f32(vld1q_f32(dst + 8), s1, gains_c));
+        }
+    }
+
+    // whatever is left over (or everything, if there's no fast path for this layout).
+    MixSpatializedFloat32Audio_scalar(dst, src, samples - i, output_channels, panning0, panning1, speaker0, speaker1);
+}
+#endif
+
+static void MixSpatializedFloat32Audio(float *dst, const float *src, const int samples, const int output_channels, const float *panning, const int *speakers, const float gain)
+{
+    const float panning0 = panning[0] * gain;
+    const float panning1 = panning[1] * gain;
+    const int speaker0 = speakers[0];
+    const int speaker1 = speakers[1];
+
+    if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
+        return;  // don't mix silence.
+    }
+
+    #if defined(SDL_AVX2_INTRINSICS)
+    if (MIX_HasAVX2) {
+        MixSpatializedFloat32Audio_avx2(dst, src, samples, output_channels, panning0, panning1, speaker0, speaker1);
+    } else
+    #endif
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MixSpatializedFloat32Audio_sse(dst, src, samples, output_channels, panning0, panning1, speaker0, speaker1);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MixSpatializedFloat32Audio_neon(dst, src, samples, output_channels, panning0, panning1, speaker0, speaker1);
+    } else
+    #endif
+    {
+        MixSpatializedFloat32Audio_scalar(dst, src, samples, output_channels, panning0, panning1, speaker0, speaker1);
+    }
+}
+
+// Moving 3D tracks: instead of jumping to new panning at the start of a block, each output channel's gain moves
+//  linearly across the block, from what was used last time to the new panning. If the speaker pair changed, this is
+//  a crossfade: the old speakers ramp down while the new ones ramp up.
+// `gains` is one gain per output channel (8 elements) for the frame before `src`, and is updated as this goes.
+//  `step` is how much each gain moves per sample frame.
+static void MixSpatializedRampFloat32Audio_scalar(float *dst, const float *src, const int samples, const int output_channels, float *gains, const float *step)
+{
+    for (int i = 0; i < samples; i++, dst += output_channels, src++) {
+        const float sample = *src;
+        for (int channel = 0; channel < output_channels; channel++) {
+            gains[channel] += step[channel];
+            dst[channel] += sample * gains[channel];
+        }
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MixSpatializedRampFloat32Audio_sse(float *dst, const float *src, const int samples, const int output_channels, float *gains, const float *step)
+{
+    int i = 0;
+
+    if (output_channels == 2) {  // two sample frames per register.
+        const __m128 step2 = _mm_setr_ps(step[0] * 2.0f, step[1] * 2.0f, step[0] * 2.0f, step[1] * 2.0f);
+        const __m128 step4 = _mm_add_ps(step2, step2);
+        __m128 g_a = _mm_setr_ps(gains[0] + step[0], gains[1] + step[1], gains[0] + (step[0] * 2.0f), gains[1] + (step[1] * 2.0f));
+        __m128 g_b = _mm_add_ps(g_a, step2);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 8) {
+            const __m128 s = _mm_loadu_ps(src);
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_unpacklo_ps(s, s), g_a)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_unpackhi_ps(s, s), g_b)));
+            g_a = _mm_add_ps(g_a, step4);
+            g_b = _mm_add_ps(g_b, step4);
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        const __m128 step_lo = _mm_load_ps(step);
+        const __m128 step_hi = _mm_load_ps(step + 4);
+        __m128 g_lo = _mm_load_ps(gains);
+        __m128 g_hi = _mm_load_ps(gains + 4);
+        for (; i < samples; i++, src++, dst += 8) {
+            const __m128 s = _mm_set1_ps(*src);
+            g_lo = _mm_add_ps(g_lo, step_lo);
+            g_hi = _mm_add_ps(g_hi, step_hi);
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s, g_lo)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(s, g_hi)));
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        const __m128 step_a = _mm_setr_ps(step[0] * 2.0f, step[1] * 2.0f, step[2] * 2.0f, step[3] * 2.0f);
+        const __m128 step_b = _mm_setr_ps(step[4] * 2.0f, step[5] * 2.0f, step[0] * 2.0f, step[1] * 2.0f);
+        const __m128 step_c = _mm_setr_ps(step[2] * 2.0f, step[3] * 2.0f, step[4] * 2.0f, step[5] * 2.0f);
+        __m128 g_a = _mm_setr_ps(gains[0] + step[0], gains[1] + step[1], gains[2] + step[2], gains[3] + step[3]);
+        __m128 g_b = _mm_setr_ps(gains[4] + step[4], gains[5] + step[5], gains[0] + (step[0] * 2.0f), gains[1] + (step[1] * 2.0f));
+        __m128 g_c = _mm_setr_ps(gains[2] + (step[2] * 2.0f), gains[3] + (step[3] * 2.0f), gains[4] + (step[4] * 2.0f), gains[5] + (step[5] * 2.0f));
+        for (; i + 2 <= samples; i += 2, src += 2, dst += 12) {
+            const __m128 s0 = _mm_set1_ps(src[0]);
+            const __m128 s1 = _mm_set1_ps(src[1]);
+            const __m128 s01 = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(0, 0, 0, 0));
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s0, g_a)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(s01, g_b)));
+            _mm_storeu_ps(dst + 8, _mm_add_ps(_mm_loadu_ps(dst + 8), _mm_mul_ps(s1, g_c)));
+            g_a = _mm_add_ps(g_a, step_a);
+            g_b = _mm_add_ps(g_b, step_b);
+            g_c = _mm_add_ps(g_c, step_c);
+        }
+    }
+
+    // catch the gains up to where the SIMD loops left off, then do whatever is left over.
+    for (int channel = 0; channel < output_channels; channel++) {
+        gains[channel] += step[channel] * (float) i;
+    }
+    MixSpatializedRampFloat32Audio_scalar(dst, src, samples - i, output_channels, gains, step);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MixSpatializedRampFloat32Audio_neon(float *dst, const float *src, const int samples, const int output_channels, float *gains, const float *step)
+{
+    int i = 0;
+
+    if (output_channels == 2) {  // two sample frames per register.
+        const float32x2_t step_pair = vld1_f32(step);
+        const float32x4_t step1 = vcombine_f32(step_pair, step_pair);
+        const float32x4_t step2 = vaddq_f32(step1, step1);
+        const float32x4_t step4 = vaddq_f32(step2, step2);
+        const float32x2_t gains_pair = vld1_f32(gains);
+        float32x4_t g_a = vaddq_f32(vcombine_f32(gains_pair, gains_pair), vcombine_f32(step_pair, vadd_f32(step_pair, step_pair)));
+        float32x4_t g_b = vaddq_f32(g_a, step2);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 8) {
+            const float32x4_t s = vld1q_f32(src);
+            const float32x4x2_t z = vzipq_f32(s, s);
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), z.val[0], g_a));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), z.val[1], g_b));
+            g_a = vaddq_f32(g_a, step4);
+            g_b = vaddq_f32(g_b, step4);
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        const float32x4_t step_lo = vld1q_f32(step);
+        const float32x4_t step_hi = vld1q_f32(step + 4);
+        float32x4_t g_lo = vld1q_f32(gains);
+        float32x4_t g_hi = vld1q_f32(gains + 4);
+        for (; i < samples; i++, src++, dst += 8) {
+            const float32x4_t s = vdupq_n_f32(*src);
+            g_lo = vaddq_f32(g_lo, step_lo);
+            g_hi = vaddq_f32(g_hi, step_hi);
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s, g_lo));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), s, g_hi));
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        const float32x4_t step_a1 = vld1q_f32(step);
+        const float32x4_t step_b1 = vcombine_f32(vld1_f32(step + 4), vld1_f32(step));
+        const float32x4_t step_c1 = vld1q_f32(step + 2);
+        const float32x4_t step_a = vaddq_f32(step_a1, step_a1);
+        const float32x4_t step_b = vaddq_f32(step_b1, step_b1);
+        const float32x4_t step_c = vaddq_f32(step_c1, step_c1);
+        float32x4_t g_a = vaddq_f32(vld1q_f32(gains), step_a1);
+        float32x4_t g_b = vaddq_f32(vcombine_f32(vld1_f32(gains + 4), vld1_f32(gains)), vcombine_f32(vld1_f32(step + 4), vget_low_f32(step_a)));
+        float32x4_t g_c = vaddq_f32(vld1q_f32(gains + 2), step_c);
+        for (; i + 2 <= samples; i += 2, src += 2, dst += 12) {
+            const float32x4_t s0 = vdupq_n_f32(src[0]);
+            const float32x4_t s1 = vdupq_n_f32(src[1]);
+            const float32x4_t s01 = vcombine_f32(vget_low_f32(s0), vget_low_f32(s1));
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s0, g_a));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), s01, g_b));
+            vst1q_f32(dst + 8, vmlaq_f32(vld1q_f32(dst + 8), s1, g_c));
+            g_a = vaddq_f32(g_a, step_a);
+            g_b = vaddq_f32(g_b, step_b);
+            g_c = vaddq_f32(g_c, step_c);
+        }
+    }
+
+    // catch the gains up to where the SIMD loops left off, then do whatever is left over.
+    for (int channel = 0; channel < output_channels; channel++) {
+        gains[channel] += step[channel] * (float) i;
+    }
+    MixSpatializedRampFloat32Audio_scalar(dst, src, samples - i, output_channels, gains, step);
+}
+#endif
+
+// fill in the starting gains (8 elements) and per-frame steps (8 elements) to move from one panning to another over `samples` frames. Returns false if it's silent the whole way.
+static bool BuildSpatializedRamp(float *gains, float *step, const int samples, const float *from_panning, const int *from_speakers, const float *to_panning, const int *to_speakers, const float gain)
+{
+    float SDL_ALIGNED(16) end[8];
+
+    BuildSpatializedFrameGains(gains, from_panning[0] * gain, from_panning[1] * gain, from_speakers[0], from_speakers[1]);
+    BuildSpatializedFrameGains(end, to_panning[0] * gain, to_panning[1] * gain, to_speakers[0], to_speakers[1]);
+
+    bool audible = false;
+    for (int i = 0; i < 8; i++) {
+        step[i] = (end[i] - gains[i]) / (float) samples;
+        if ((gains[i] != 0.0f) || (end[i] != 0.0f)) {
+            audible = true;
+        }
+    }
+    return audible;
+}
+
+static void MixSpatializedRampFloat32Audio(float *dst, const float *src, const int samples, const int output_channels, const float *from_panning, const int *from_speakers, const float *to_panning, const int *to_speakers, const float gain)
+{
+    float SDL_ALIGNED(16) gains[8];
+    float SDL_ALIGNED(16) step[8];
+
+    if (samples <= 0) {
+        return;
+    } else if (!BuildSpatializedRamp(gains, step, samples, from_panning, from_speakers, to_panning, to_speakers, gain)) {
+        return;  // don't mix silence.
+    }
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MixSpatializedRampFloat32Audio_sse(dst, src, samples, output_channels, gains, step);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MixSpatializedRampFloat32Audio_neon(dst, src, samples, output_channels, gains, step);
+    } else
+    #endif
+    {
+        MixSpatializedRampFloat32Audio_scalar(dst, src, samples, output_channels, gains, step);
+    }
+}
+
+// Occlusion and obstruction run a 3D track's mono signal through a one-pole low-pass: y[n] = y[n-1] + a * (x[n] - y[n-1]).
+//  That's a recurrence, but it unrolls: four outputs in a row are the last output scaled by powers of (1 - a), plus a
+//  weighted sum of the four inputs. So the SIMD versions do four samples at once with a few multiply-adds.
+typedef struct MIX_LowpassTaps
+{
+    float SDL_ALIGNED(16) feedback[4];  // how much the previous output contributes to each of the next four.
+    float SDL_ALIGNED(16) input[4][4];  // input[j][k] is how much input sample j contributes to output sample k.
+} MIX_LowpassTaps;
+
+static void BuildLowpassTaps(MIX_LowpassTaps *taps, const float a)
+{
+    const float b = 1.0f - a;
+    float feedback = 1.0f;
+    for (int k = 0; k < 4; k++) {
+        feedback *= b;
+        taps->feedback[k] = feedback;
+    }
+
+    for (int j = 0; j < 4; j++) {
+        float weight = a;
+        for (int k = 0; k < 4; k++) {
+            if (k < j) {
+                taps->input[j][k] = 0.0f;
+            } else {
+                taps->input[j][k] = weight;
+                weight *= b;
+            }
+        }
+    }
+}
+
+static void LowpassFloat32Audio_scalar(float *dst, const float *src, const int samples, const float a, float *state)
+{
+    float y = *state;
+    for (int i = 0; i < samples; i++) {
+        y += a * (src[i] - y);
+        dst[i] = y;
+    }
+    *state = y;
+}
+
+// The low-pass fused into spatialized mixing, so filtering doesn't need its own pass over the data. `gains` and `step` work like MixSpatializedRampFloat32Audio.
+static void MixSpatializedLowpassFloat32Audio_scalar(float *dst, const float *src, const int samples, const int output_channels, float *gains, const float *step, const float a, float *state)
+{
+    float y = *state;
+    for (int i = 0; i < samples; i++, dst += output_channels, src++) {
+        y += a * (*src - y);
+        for (int channel = 0; channel < output_channels; channel++) {
+            gains[channel] += step[channel];
+            dst[channel] += y * gains[channel];
+        }
+    }
+    *state = y;
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+// filter four samples. `taps` is feedback, then input[0] through input[3], loaded into registers. `previous` is the last output in every lane.
+static __m128 SDL_TARGETING("sse") LowpassFrames_sse(const __m128 *taps, const __m128 x, const __m128 previous)
+{
+    __m128 y = _mm_mul_ps(previous, taps[0]);
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0)), taps[1]));
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 1, 1, 1)), taps[2]));
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 2, 2, 2)), taps[3]));
+    y = _mm_add_ps(y, _mm_mul_ps(_mm_shuffle_ps(x, x, _MM_SHUFFLE(3, 3, 3, 3)), taps[4]));
+    return y;
+}
+
+static void SDL_TARGETING("sse") LoadLowpassTaps_sse(const float a, __m128 *taps)
+{
+    MIX_LowpassTaps t;
+    BuildLowpassTaps(&t, a);
+    taps[0] = _mm_load_ps(t.feedback);
+    for (int j = 0; j < 4; j++) {
+        taps[j + 1] = _mm_load_ps(t.input[j]);
+    }
+}
+
+static void SDL_TARGETING("sse") LowpassFloat32Audio_sse(float *dst, const float *src, const int samples, const float a, float *state)
+{
+    int i = 0;
+    __m128 taps[5];
+    LoadLowpassTaps_sse(a, taps);
+    __m128 previous = _mm_set1_ps(*state);
+    for (; i + 4 <= samples; i += 4) {
+        const __m128 y = LowpassFrames_sse(taps, _mm_loadu_ps(src + i), previous);
+        _mm_storeu_ps(dst + i, y);
+        previous = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    *state = _mm_cvtss_f32(previous);
+    LowpassFloat32Audio_scalar(dst + i, src + i, samples - i, a, state);
+}
+
+// one 7.1 sample frame, with the filtered sample already in every lane of `s`.
+static void SDL_TARGETING("sse") MixLowpassFrame8_sse(float *dst, const __m128 s, __m128 *g_lo, __m128 *g_hi, const __m128 step_lo, const __m128 step_hi)
+{
+    *g_lo = _mm_add_ps(*g_lo, step_lo);
+    *g_hi = _mm_add_ps(*g_hi, step_hi);
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s, *g_lo)));
+    _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(s, *g_hi)));
+}
+
+// two 5.1 sample frames, with the filtered samples already in every lane of `s0` and `s1`.
+static void SDL_TARGETING("sse") MixLowpassFramePair6_sse(float *dst, const __m128 s0, const __m128 s1, __m128 *g, const __m128 *step)
+{
+    const __m128 s01 = _mm_shuffle_ps(s0, s1, _MM_SHUFFLE(0, 0, 0, 0));
+    _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(s0, g[0])));
+    _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(s01, g[1])));
+    _mm_storeu_ps(dst + 8, _mm_add_ps(_mm_loadu_ps(dst + 8), _mm_mul_ps(s1, g[2])));
+    g[0] = _mm_add_ps(g[0], step[0]);
+    g[1] = _mm_add_ps(g[1], step[1]);
+    g[2] = _mm_add_ps(g[2], step[2]);
+}
+
+static void SDL_TARGETING("sse") MixSpatializedLowpassFloat32Audio_sse(float *dst, const float *src, const int samples, const int output_channels, float *gains, const float *step, const float a, float *state)
+{
+    int i = 0;
+    __m128 taps[5];
+    LoadLowpassTaps_sse(a, taps);
+    __m128 previous = _mm_set1_ps(*state);
+
+    if (output_channels == 2) {  // two sample frames per register.
+        const __m128 step2 = _mm_setr_ps(step[0] * 2.0f, step[1] * 2.0f, step[0] * 2.0f, step[1] * 2.0f);
+        const __m128 step4 = _mm_add_ps(step2, step2);
+        __m128 g_a = _mm_setr_ps(gains[0] + step[0], gains[1] + step[1], gains[0] + (step[0] * 2.0f), gains[1] + (step[1] * 2.0f));
+        __m128 g_b = _mm_add_ps(g_a, step2);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 8) {
+            const __m128 y = LowpassFrames_sse(taps, _mm_loadu_ps(src), previous);
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_unpacklo_ps(y, y), g_a)));
+            _mm_storeu_ps(dst + 4, _mm_add_ps(_mm_loadu_ps(dst + 4), _mm_mul_ps(_mm_unpackhi_ps(y, y), g_b)));
+            g_a = _mm_add_ps(g_a, step4);
+            g_b = _mm_add_ps(g_b, step4);
+            previous = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3));
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        const __m128 step_lo = _mm_load_ps(step);
+        const __m128 step_hi = _mm_load_ps(step + 4);
+        __m128 g_lo = _mm_load_ps(gains);
+        __m128 g_hi = _mm_load_ps(gains + 4);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 32) {
+            const __m128 y = LowpassFrames_sse(taps, _mm_loadu_ps(src), previous);
+            MixLowpassFrame8_sse(dst, _mm_shuffle_ps(y, y, _MM_SHUFFLE(0, 0, 0, 0)), &g_lo, &g_hi, step_lo, step_hi);
+            MixLowpassFrame8_sse(dst + 8, _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1)), &g_lo, &g_hi, step_lo, step_hi);
+            MixLowpassFrame8_sse(dst + 16, _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 2, 2, 2)), &g_lo, &g_hi, step_lo, step_hi);
+            previous = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3));
+            MixLowpassFrame8_sse(dst + 24, previous, &g_lo, &g_hi, step_lo, step_hi);
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        const __m128 steps[3] = {
+            _mm_setr_ps(step[0] * 2.0f, step[1] * 2.0f, step[2] * 2.0f, step[3] * 2.0f),
+            _mm_setr_ps(step[4] * 2.0f, step[5] * 2.0f, step[0] * 2.0f, step[1] * 2.0f),
+            _mm_setr_ps(step[2] * 2.0f, step[3] * 2.0f, step[4] * 2.0f, step[5] * 2.0f)
+        };
+        __m128 g[3] = {
+            _mm_setr_ps(gains[0] + step[0], gains[1] + step[1], gains[2] + step[2], gains[3] + step[3]),
+            _mm_setr_ps(gains[4] + step[4], gains[5] + step[5], gains[0] + (step[0] * 2.0f), gains[1] + (step[1] * 2.0f)),
+            _mm_setr_ps(gains[2] + (step[2] * 2.0f), gains[3] + (step[3] * 2.0f), gains[4] + (step[4] * 2.0f), gains[5] + (step[5] * 2.0f))
+        };
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 24) {
+            const __m128 y = LowpassFrames_sse(taps, _mm_loadu_ps(src), previous);
+            previous = _mm_shuffle_ps(y, y, _MM_SHUFFLE(3, 3, 3, 3));
+            MixLowpassFramePair6_sse(dst, _mm_shuffle_ps(y, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(y, y, _MM_SHUFFLE(1, 1, 1, 1)), g, steps);
+            MixLowpassFramePair6_sse(dst + 12, _mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 2, 2, 2)), previous, g, steps);
+        }
+    }
+
+    // catch the gains and the filter up to where the SIMD loops left off, then do whatever is left over.
+    for (int channel = 0; channel < output_channels; channel++) {
+        gains[channel] += step[channel] * (float) i;
+    }
+    *state = _mm_cvtss_f32(previous);
+    MixSpatializedLowpassFloat32Audio_scalar(dst, src, samples - i, output_channels, gains, step, a, state);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+// filter four samples. `taps` is feedback, then input[0] through input[3], loaded into registers. `previous` is the last output in every lane.
+static float32x4_t LowpassFrames_neon(const float32x4_t *taps, const float32x4_t x, const float32x4_t previous)
+{
+    const float32x2_t lo = vget_low_f32(x);
+    const float32x2_t hi = vget_high_f32(x);
+    float32x4_t y = vmulq_f32(previous, taps[0]);
+    y = vmlaq_f32(y, vdupq_lane_f32(lo, 0), taps[1]);
+    y = vmlaq_f32(y, vdupq_lane_f32(lo, 1), taps[2]);
+    y = vmlaq_f32(y, vdupq_lane_f32(hi, 0), taps[3]);
+    y = vmlaq_f32(y, vdupq_lane_f32(hi, 1), taps[4]);
+    return y;
+}
+
+static void LoadLowpassTaps_neon(const float a, float32x4_t *taps)
+{
+    MIX_LowpassTaps t;
+    BuildLowpassTaps(&t, a);
+    taps[0] = vld1q_f32(t.feedback);
+    for (int j = 0; j < 4; j++) {
+        taps[j + 1] = vld1q_f32(t.input[j]);
+    }
+}
+
+static void LowpassFloat32Audio_neon(float *dst, const float *src, const int samples, const float a, float *state)
+{
+    int i = 0;
+    float32x4_t taps[5];
+    LoadLowpassTaps_neon(a, taps);
+    float32x4_t previous = vdupq_n_f32(*state);
+    for (; i + 4 <= samples; i += 4) {
+        const float32x4_t y = LowpassFrames_neon(taps, vld1q_f32(src + i), previous);
+        vst1q_f32(dst + i, y);
+        previous = vdupq_lane_f32(vget_high_f32(y), 1);
+    }
+    *state = vgetq_lane_f32(previous, 0);
+    LowpassFloat32Audio_scalar(dst + i, src + i, samples - i, a, state);
+}
+
+// one 7.1 sample frame, with the filtered sample already in every lane of `s`.
+static void MixLowpassFrame8_neon(float *dst, const float32x4_t s, float32x4_t *g_lo, float32x4_t *g_hi, const float32x4_t step_lo, const float32x4_t step_hi)
+{
+    *g_lo = vaddq_f32(*g_lo, step_lo);
+    *g_hi = vaddq_f32(*g_hi, step_hi);
+    vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s, *g_lo));
+    vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), s, *g_hi));
+}
+
+// two 5.1 sample frames: the filtered samples are `pair` (first in lane 0, second in lane 1).
+static void MixLowpassFramePair6_neon(float *dst, const float32x2_t pair, float32x4_t *g, const float32x4_t *step)
+{
+    const float32x4_t s0 = vdupq_lane_f32(pair, 0);
+    const float32x4_t s1 = vdupq_lane_f32(pair, 1);
+    const float32x4_t s01 = vcombine_f32(vget_low_f32(s0), vget_low_f32(s1));
+    vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), s0, g[0]));
+    vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), s01, g[1]));
+    vst1q_f32(dst + 8, vmlaq_f32(vld1q_f32(dst + 8), s1, g[2]));
+    g[0] = vaddq_f32(g[0], step[0]);
+    g[1] = vaddq_f32(g[1], step[1]);
+    g[2] = vaddq_f32(g[2], step[2]);
+}
+
+static void MixSpatializedLowpassFloat32Audio_neon(float *dst, const float *src, const int samples, const int output_channels, float *gains, const float *step, const float a, float *state)
+{
+    int i = 0;
+    float32x4_t taps[5];
+    LoadLowpassTaps_neon(a, taps);
+    float32x4_t previous = vdupq_n_f32(*state);
+
+    if (output_channels == 2) {  // two sample frames per register.
+        const float32x2_t step_pair = vld1_f32(step);
+        const float32x4_t step1 = vcombine_f32(step_pair, step_pair);
+        const float32x4_t step2 = vaddq_f32(step1, step1);
+        const float32x4_t step4 = vaddq_f32(step2, step2);
+        const float32x2_t gains_pair = vld1_f32(gains);
+        float32x4_t g_a = vaddq_f32(vcombine_f32(gains_pair, gains_pair), vcombine_f32(step_pair, vadd_f32(step_pair, step_pair)));
+        float32x4_t g_b = vaddq_f32(g_a, step2);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 8) {
+            const float32x4_t y = LowpassFrames_neon(taps, vld1q_f32(src), previous);
+            const float32x4x2_t z = vzipq_f32(y, y);
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), z.val[0], g_a));
+            vst1q_f32(dst + 4, vmlaq_f32(vld1q_f32(dst + 4), z.val[1], g_b));
+            g_a = vaddq_f32(g_a, step4);
+            g_b = vaddq_f32(g_b, step4);
+            previous = vdupq_lane_f32(vget_high_f32(y), 1);
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        const float32x4_t step_lo = vld1q_f32(step);
+        const float32x4_t step_hi = vld1q_f32(step + 4);
+        float32x4_t g_lo = vld1q_f32(gains);
+        float32x4_t g_hi = vld1q_f32(gains + 4);
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 32) {
+            const float32x4_t y = LowpassFrames_neon(taps, vld1q_f32(src), previous);
+            const float32x2_t lo = vget_low_f32(y);
+            const float32x2_t hi = vget_high_f32(y);
+            MixLowpassFrame8_neon(dst, vdupq_lane_f32(lo, 0), &g_lo, &g_hi, step_lo, step_hi);
+            MixLowpassFrame8_neon(dst + 8, vdupq_lane_f32(lo, 1), &g_lo, &g_hi, step_lo, step_hi);
+            MixLowpassFrame8_neon(dst + 16, vdupq_lane_f32(hi, 0), &g_lo, &g_hi, step_lo, step_hi);
+            previous = vdupq_lane_f32(hi, 1);
+            MixLowpassFrame8_neon(dst + 24, previous, &g_lo, &g_hi, step_lo, step_hi);
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        const float32x4_t step_a1 = vld1q_f32(step);
+        const float32x4_t step_b1 = vcombine_f32(vld1_f32(step + 4), vld1_f32(step));
+        const float32x4_t step_c1 = vld1q_f32(step + 2);
+        const float32x4_t steps[3] = { vaddq_f32(step_a1, step_a1), vaddq_f32(step_b1, step_b1), vaddq_f32(step_c1, step_c1) };
+        float32x4_t g[3] = {
+            vaddq_f32(vld1q_f32(gains), step_a1),
+            vaddq_f32(vcombine_f32(vld1_f32(gains + 4), vld1_f32(gains)), vcombine_f32(vld1_f32(step + 4), vget_low_f32(steps[0]))),
+            vaddq_f32(vld1q_f32(gains + 2), steps[2])
+        };
+        for (; i + 4 <= samples; i += 4, src += 4, dst += 24) {
+            const float32x4_t y = LowpassFrames_neon(taps, vld1q_f32(src), previous);
+            MixLowpassFramePair6_neon(dst, vget_low_f32(y), g, steps);
+            MixLowpassFramePair6_neon(dst + 12, vget_high_f32(y), g, steps);
+            previous = vdupq_lane_f32(vget_high_f32(y), 1);
+        }
+    }
+
+    // catch the gains and the filter up to where the SIMD loops left off, then do whatever is left over.
+    for (int channel = 0; channel < output_channels; channel++) {
+        gains[channel] += step[channel] * (float) i;
+    }
+    *state = vgetq_lane_f32(previous, 0);
+    MixSpatializedLowpassFloat32Audio_scalar(dst, src, samples - i, output_channels, gains, step, a, state);
+}
+#endif
+
+// filter a 3D track's audio on its own, for mixing paths that can't have the filter fused in. `dst` may be `src`.
+static void LowpassFloat32Audio(float *dst, const float *src, const int samples, const float a, float *state)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        LowpassFloat32Audio_sse(dst, src, samples, a, state);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        LowpassFloat32Audio_neon(dst, src, samples, a, state);
+    } else
+    #endif
+    {
+        LowpassFloat32Audio_scalar(dst, src, samples, a, state);
+    }
+}
+
+static void MixSpatializedLowpassFloat32Audio(float *dst, const float *src, const int samples, const int output_channels, const float *from_panning, const int *from_speakers, const float *to_panning, const int *to_speakers, const float gain, const float a, float *state)
+{
+    float SDL_ALIGNED(16) gains[8];
+    float SDL_ALIGNED(16) step[8];
+
+    if (samples <= 0) {
+        return;
+    } else if (!BuildSpatializedRamp(gains, step, samples, from_panning, from_speakers, to_panning, to_speakers, gain)) {
+        for (int i = 0; i < samples; i++) {  // don't mix silence, but keep the filter moving, so it doesn't pop when this gets loud again.
+            *state += a * (src[i] - *state);
+        }
+        return;
+    }
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MixSpatializedLowpassFloat32Audio_sse(dst, src, samples, output_channels, gains, step, a, state);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MixSpatializedLowpassFloat32Audio_neon(dst, src, samples, output_channels, gains, step, a, state);
+    } else
+    #endif
+    {
+        MixSpatializedLowpassFloat32Audio_scalar(dst, src, samples, output_channels, gains, step, a, state);
+    }
+}
+
+// dst += src * gain, with `gain` moving by `step` every sample (before it's applied). Ambisonic channels are planar, so
+//  encoding a track into the bus is one of these per channel.
+static void MixRampFloat32Audio_scalar(float *dst, const float *src, const int samples, float gain, const float step)
+{
+    for (int i = 0; i < samples; i++) {
+        gain += step;
+        dst[i] += src[i] * gain;
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MixRampFloat32Audio_sse(float *dst, const float *src, const int samples, const float gain, const float step)
+{
+    int i = 0;
+    const __m128 step4 = _mm_set1_ps(step * 4.0f);
+    __m128 g = _mm_setr_ps(gain + step, gain + (step * 2.0f), gain + (step * 3.0f), gain + (step * 4.0f));
+    for (; i + 4 <= samples; i += 4) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), g)));
+        g = _mm_add_ps(g, step4);
+    }
+    MixRampFloat32Audio_scalar(dst + i, src + i, samples - i, gain + (step * (float) i), step);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MixRampFloat32Audio_neon(float *dst, const float *src, const int samples, const float gain, const float step)
+{
+    int i = 0;
+    const float SDL_ALIGNED(16) first[4] = { gain + step, gain + (step * 2.0f), gain + (step * 3.0f), gain + (step * 4.0f) };
+    const float32x4_t step4 = vdupq_n_f32(step * 4.0f);
+    float32x4_t g = vld1q_f32(first);
+    for (; i + 4 <= samples; i += 4) {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), g));
+        g = vaddq_f32(g, step4);
+    }
+    MixRampFloat32Audio_scalar(dst + i, src + i, samples - i, gain + (step * (float) i), step);
+}
+#endif
+
+static void MixRampFloat32Audio(float *dst, const float *src, const int samples, const float gain, const float step)
+{
+    if ((gain == 0.0f) && (step == 0.0f)) {
+        return;  // don't mix silence.
+    }
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MixRampFloat32Audio_sse(dst, src, samples, gain, step);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MixRampFloat32Audio_neon(dst, src, samples, gain, step);
+    } else
+    #endif
+    {
+        MixRampFloat32Audio_scalar(dst, src, samples, gain, step);
+    }
+}
+
+// Decode a planar ambisonic bus into interleaved speaker output. `matrix` has a row of MIX_AMBISONIC_MAX_CHANNELS gains per output channel.
+static void DecodeAmbisonicFloat32Audio_scalar(float *dst, const float *bus, const int bus_frames, const int start_frame, const int ambisonic_channels, const int output_channels, const float *matrix)
+{
+    dst += start_frame * output_channels;
+    for (int i = start_frame; i < bus_frames; i++, dst += output_channels) {
+        for (int channel = 0; channel < output_channels; channel++) {
+            const float *row = &matrix[channel * MIX_AMBISONIC_MAX_CHANNELS];
+            float sample = 0.0f;
+            for (int j = 0; j < ambisonic_channels; j++) {
+                sample += bus[(j * bus_frames) + i] * row[j];
+            }
+            dst[channel] += sample;
+        }
+    }
+}
+
+// get column `j` of the decoding matrix (every output channel's gain for ambisonic channel `j`), padded out to 8 with zeros.
+static void GetAmbisonicDecoderColumn(const float *matrix, const int output_channels, const int j, float *column)
+{
+    SDL_memset(column, '\0', sizeof (float) * 8);
+    for (int channel = 0; channel < output_channels; channel++) {
+        column[channel] = matrix[(channel * MIX_AMBISONIC_MAX_CHANNELS) + j];
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") DecodeAmbisonicFloat32Audio_sse(float *dst, const float *bus, const int bus_frames, const int ambisonic_channels, const int output_channels, const float *matrix)
+{
+    int i = 0;
+    __m128 columns_a[MIX_AMBISONIC_MAX_CHANNELS];
+    __m128 columns_b[MIX_AMBISONIC_MAX_CHANNELS];
+    __m128 columns_c[MIX_AMBISONIC_MAX_CHANNELS];
+    float SDL_ALIGNED(16) c[8];
+
+    if (output_channels == 2) {  // stereo output: two sample frames per register.
+        for (int j = 0; j < ambisonic_channels; j++) {
+            GetAmbisonicDecoderColumn(matrix, output_channels, j, c);
+            columns_a[j] = _mm_setr_ps(c[0], c[1], c[0], c[1]);
+        }
+        for (; i + 4 <= bus_frames; i += 4) {
+            __m128 lo = _mm_setzero_ps();
+            __m128 hi = _mm_setzero_ps();
+            for (int j = 0; j < ambisonic_channels; j++) {
+                const __m128 s = _mm_loadu_ps(bus + (j * bus_frames) + i);
+                lo = _mm_add_ps(lo, _mm_mul_ps(_mm_unpacklo_ps(s, s), columns_a[j]));
+                hi = _mm_add_ps(hi, _mm_mul_ps(_mm_unpackhi_ps(s, s), columns_a[j]));
+            }
+            float *out = dst + (i * 2);
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), lo));
+            _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), hi));
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        for (int j = 0; j < ambisonic_channels; j++) {
+            GetAmbisonicDecoderColumn(matrix, output_channels, j, c);
+            columns_a[j] = _mm_load_ps(c);
+            columns_b[j] = _mm_load_ps(c + 4);
+        }
+        for (; i < bus_frames; i++) {
+            __m128 lo = _mm_setzero_ps();
+            __m128 hi = _mm_setzero_ps();
+            for (int j = 0; j < ambisonic_channels; j++) {
+                const __m128 s = _mm_set1_ps(bus[(j * bus_frames) + i]);
+                lo = _mm_add_ps(lo, _mm_mul_ps(s, columns_a[j]));
+                hi = _mm_add_ps(hi, _mm_mul_ps(s, columns_b[j]));
+            }
+            float *out = dst + (i * 8);
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), lo));
+            _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), hi));
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        for (int j = 0; j < ambisonic_channels; j++) {
+            GetAmbisonicDecoderColumn(matrix, output_channels, j, c);
+            columns_a[j] = _mm_setr_ps(c[0], c[1], c[2], c[3]);
+            columns_b[j] = _mm_setr_ps(c[4], c[5], c[0], c[1]);
+            columns_c[j] = _mm_setr_ps(c[2], c[3], c[4], c[5]);
+        }
+        for (; i + 2 <= bus_frames; i += 2) {
+            __m128 a = _mm_setzero_ps();
+            __m128 b = _mm_setzero_ps();
+            __m128 cc = _mm_setzero_ps();
+            for (int j = 0; j < ambisonic_channels; j++) {
+                const float *in = bus + (j * bus_frames) + i;
+                const __m128 s0 = _mm_set1_ps(in[0]);
+                const __m128 s1 = _mm_set1_ps(in[1]);
+                a = _mm_add_ps(a, _mm_mul_ps(s0, columns_a[j]));
+                b = _mm_add_ps(b, _mm_mul_ps(_mm_shuffle_ps(s0, s1, _MM_SHUFFLE(0, 0, 0, 0)), columns_b[j]));
+                cc = _mm_add_ps(cc, _mm_mul_ps(s1, columns_c[j]));
+            }
+            float *out = dst + (i * 6);
+            _mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), a));
+            _mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), b));
+            _mm_storeu_ps(out + 8, _mm_add_ps(_mm_loadu_ps(out + 8), cc));
+        }
+    }
+
+    // whatever is left over (or everything, if there's no fast path for this layout).
+    DecodeAmbisonicFloat32Audio_scalar(dst, bus, bus_frames, i, ambisonic_channels, output_channels, matrix);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void DecodeAmbisonicFloat32Audio_neon(float *dst, const float *bus, const int bus_frames, const int ambisonic_channels, const int output_channels, const float *matrix)
+{
+    int i = 0;
+    float32x4_t columns_a[MIX_AMBISONIC_MAX_CHANNELS];
+    float32x4_t columns_b[MIX_AMBISONIC_MAX_CHANNELS];
+    float32x4_t columns_c[MIX_AMBISONIC_MAX_CHANNELS];
+    float SDL_ALIGNED(16) c[8];
+
+    if (output_channels == 2) {  // stereo output: two sample frames per register.
+        for (int j = 0; j < ambisonic_channels; j++) {
+            GetAmbisonicDecoderColumn(matrix, output_channels, j, c);
+            columns_a[j] = vcombine_f32(vld1_f32(c), vld1_f32(c));
+        }
+        for (; i + 4 <= bus_frames; i += 4) {
+            float32x4_t lo = vdupq_n_f32(0.0f);
+            float32x4_t hi = vdupq_n_f32(0.0f);
+            for (int j = 0; j < ambisonic_channels; j++) {
+                const float32x4_t s = vld1q_f32(bus + (j * bus_frames) + i);
+                const float32x4x2_t z = vzipq_f32(s, s);
+                lo = vmlaq_f32(lo, z.val[0], columns_a[j]);
+                hi = vmlaq_f32(hi, z.val[1], columns_a[j]);
+            }
+            float *out = dst + (i * 2);
+            vst1q_f32(out, vaddq_f32(vld1q_f32(out), lo));
+            vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), hi));
+        }
+    } else if (output_channels == 8) {  // 7.1: one sample frame is exactly two registers.
+        for (int j = 0; j < ambisonic_channels; j++) {
+            GetAmbisonicDecoderColumn(matrix, output_channels, j, c);
+            columns_a[j] = vld1q_f32(c);
+            columns_b[j] = vld1q_f32(c + 4);
+        }
+        for (; i < bus_frames; i++) {
+            float32x4_t lo = vdupq_n_f32(0.0f);
+            float32x4_t hi = vdupq_n_f32(0.0f);
+            for (int j = 0; j < ambisonic_channels; j++) {
+                const float32x4_t s = vdupq_n_f32(bus[(j * bus_frames) + i]);
+                lo = vmlaq_f32(lo, s, columns_a[j]);
+                hi = vmlaq_f32(hi, s, columns_b[j]);
+            }
+            float *out = dst + (i * 8);
+            vst1q_f32(out, vaddq_f32(vld1q_f32(out), lo));
+            vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), hi));
+        }
+    } else if (output_channels == 6) {  // 5.1: two sample frames are exactly three registers.
+        for (int j = 0; j < ambisonic_channels; j++) {
+            GetAmbisonicDecoderColumn(matrix, output_channels, j, c);
+            columns_a[j] = vld1q_f32(c);
+            columns_b[j] = vcombine_f32(vld1_f32(c + 4), vld1_f32(c));
+            columns_c[j] = vld1q_f32(c + 2);
+        }
+        for (; i + 2 <= bus_frames; i += 2) {
+            float32x4_t a = vdupq_n_f32(0.0f);
+            float32x4_t b = vdupq_n_f32(0.0f);
+            float32x4_t cc = vdupq_n_f32(0.0f);
+            for (int j = 0; j < ambisonic_channels; j++) {
+                const float *in = bus + (j * bus_frames) + i;
+                const float32x4_t s0 = vdupq_n_f32(in[0]);
+                const float32x4_t s1 = vdupq_n_f32(in[1]);
+                a = vmlaq_f32(a, s0, columns_a[j]);
+                b = vmlaq_f32(b, vcombine_f32(vget_low_f32(s0), vget_low_f32(s1)), columns_b[j]);
+                cc = vmlaq_f32(cc, s1, columns_c[j]);
+            }
+            float *out = dst + (i * 6);
+            vst1q_f32(out, vaddq_f32(vld1q_f32(out), a));
+            vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), b));
+            vst1q_f32(out + 8, vaddq_f32(vld1q_f32(out + 8), cc));
+        }
+    }
+
+    // whatever is left over (or everything, if there's no fast path for this layout).
+    DecodeAmbisonicFloat32Audio_scalar(dst, bus, bus_frames, i, ambisonic_channels, output_channels, matrix);
+}
+#endif
+
+static void DecodeAmbisonicFloat32Audio(float *dst, const float *bus, const int bus_frames, const int ambisonic_channels, const int output_channels, const float *matrix)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        DecodeAmbisonicFloat32Audio_sse(dst, bus, bus_frames, ambisonic_channels, output_channels, matrix);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        DecodeAmbisonicFloat32Audio_neon(dst, bus, bus_frames, ambisonic_channels, output_channels, matrix);
+    } else
+    #endif
+    {
+        DecodeAmbisonicFloat32Audio_scalar(dst, bus, bus_frames, 0, ambisonic_channels, output_channels, matrix);
+    }
+}
+
+// Stereo tracks forced to the front left/right speakers. panning0/panning1 already have the mixer gain applied.
+static void MixForcedStereoFloat32Audio_scalar(float *dst, const float *src, const int sample_frames, const int output_channels, const float panning0, const float panning1)
+{
+    if ((panning0 == 1.0f) && (panning1 == 1.0f)) {  // no modulation.
+        for (int i = 0; i < sample_frames; i++, dst += output_channels, src += 2) {
+            dst[0] += src[0];
+            dst[1] += src[1];
+        }
+    } else {
+        for (int i = 0; i < sample_frames; i++, dst += output_channels, src += 2) {
+            dst[0] += src[0] * panning0;
+            dst[1] += src[1] * panning1;
+        }
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") MixForcedStereoFloat32Audio_sse(float *dst, const float *src, const int sample_frames, const int output_channels, const float panning0, const float panning1)
+{
+    const __m128 gains = _mm_setr_ps(panning0, panning1, panning0, panning1);
+    int i = 0;
+
+    if (output_channels == 2) {  // input and output are both interleaved stereo, so this is a straight multiply-add.
+        for (; i + 2 <= sample_frames; i += 2, src += 4, dst += 4) {
+            _mm_storeu_ps(dst, _mm_add_ps(_mm_loadu_ps(dst), _mm_mul_ps(_mm_loadu_ps(src), gains)));
+        }
+    } else {  // surround output: do two input frames at once, and scatter each half to its own output frame.
+        const __m128 zero = _mm_setzero_ps();
+        for (; i + 2 <= sample_frames; i += 2, src += 4, dst += output_channels * 2) {
+            const __m128 s = _mm_mul_ps(_mm_loadu_ps(src), gains);
+            float *dst1 = dst + output_channels;
+            _mm_storel_pi((__m64 *) dst, _mm_add_ps(_mm_loadl_pi(zero, (const __m64 *) dst), s));
+            _mm_storeh_pi((__m64 *) dst1, _mm_add_ps(_mm_loadh_pi(zero, (const __m64 *) dst1), s));
+        }
+    }
+
+    MixForcedStereoFloat32Audio_scalar(dst, src, sample_frames - i, output_channels, panning0, panning1);  // whatever is left over.
+}
+#endif
+
+#if defined(SDL_AVX2_INTRINSICS)
+static void SDL_TARGETING("avx2") MixForcedStereoFloat32Audio_avx2(float *dst, const float *src, const int sample_frames, const int output_channels, const float panning0, const float panning1)
+{
+    int i = 0;
+
+    if (output_channels == 2) {  // input and output are both interleaved stereo, so this is a straight multiply-add.
+        const __m256 gains = _mm256_setr_ps(panning0, panning1, panning0, panning1, panning0, panning1, panning0, panning1);
+        for (; i + 4 <= sample_frames; i += 4, src += 8, dst += 8) {
+            _mm256_storeu_ps(dst, _mm256_add_ps(_mm256_loadu_ps(dst), _mm256_mul_ps(_mm256_loadu_ps(src), gains)));
+        }
+    }
+
+    // surround output only touches two floats per frame, so wider registers don't help there; let SSE handle it.
+    MixForcedStereoFloat32Audio_sse(dst, src, sample_frames - i, output_channels, panning0, panning1);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void MixForcedStereoFloat32Audio_neon(float *dst, const float *src, const int sample_frames, const int output_channels, const float panning0, const float panning1)
+{
+    const float32x2_t pair = vset_lane_f32(panning1, vdup_n_f32(panning0), 1);
+    int i = 0;
+
+    if (output_channels == 2) {  // input and output are both interleaved stereo, so this is a straight multiply-add.
+        const float32x4_t gains = vcombine_f32(pair, pair);
+        for (; i + 2 <= sample_frames; i += 2, src += 4, dst += 4) {
+            vst1q_f32(dst, vmlaq_f32(vld1q_f32(dst), vld1q_f32(src), gains));
+        }
+    } else {
+        for (; i < sample_frames; i++, src += 2, dst += output_channels) {
+            vst1_f32(dst, vmla_f32(vld1_f32(dst), vld1_f32(src), pair));
+        }
+    }
+
+    MixForcedStereoFloat32Audio_scalar(dst, src, sample_frames - i, output_channels, panning0, panning1);  // whatever is left over.
+}
+#endif
+
+static void MixForcedStereoFloat32Audio(float *dst, const float *src, const int sample_frames, const int output_channels, const float *panning, const float gain)
+{
+    const float panning0 = panning[0] * gain;
+    const float panning1 = panning[1] * gain;
+
+    if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
+        return;  // don't mix silence.
+    }
+
+    #if defined(SDL_AVX2_INTRINSICS)
+    if (MIX_HasAVX2) {
+        MixForcedStereoFloat32Audio_avx2(dst, src, sample_frames, output_channels, panning0, panning1);
+    } else
+    #endif
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        MixForcedStereoFloat32Audio_sse(dst, src, sample_frames, output_channels, panning0, panning1);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        MixForcedStereoFloat32Audio_neon(dst, src, sample_frames, output_channels, panning0, panning1);
+    } else
+    #endif
+    {
+        MixForcedStereoFloat32Audio_scalar(dst, src, sample_frames, output_channels, panning0, panning1);
+    }
+}
+
+static void MixFloat32Audio(float *dst, const float *src, const int buffer_size, const float gain)
+{
+    if (gain == 0.0f) {
+        return;  // don't mix silence.
+    } else if (!SDL_MixAudio((Uint8 *) dst, (const Uint8 *) src, SDL_AUDIO_F32, buffer_size, gain)) {
+        SDL_assert(!"This shouldn't happen.");
+    }
+}
+
+// Group effect kernels. These work on interleaved audio in place, and are vectorized across channels: each sample
+//  frame is handled four channels at a time, then two, then one, so any channel count takes the fast path.
+
+// Run `buffer` through a cascade of biquads (transposed direct form II), one per row of `coefficients`. Channels
+//  before `first_channel` are left alone, so the SIMD versions can hand off whatever channels they can't do.
+static void ProcessEQFloat32Audio_scalar(float *buffer, const int frames, const int channels, const int first_channel, const int num_bands, const float (*coefficients)[5], float (*state)[2][MIX_EFFECT_MAX_CHANNELS])
+{
+    for (int channel = first_channel; channel < channels; channel++) {
+        for (int band = 0; band < num_bands; band++) {
+            const float *c = coefficients[band];
+            float s1 = state[band][0][channel];
+            float s2 = state[band][1][channel];
+            float *ptr = buffer + channel;
+            for (int i = 0; i < frames; i++, ptr += channels) {
+                const float x = *ptr;
+                const float y = (c[0] * x) + s1;
+                s1 = (c[1] * x) - (c[3] * y) + s2;
+                s2 = (c[2] * x) - (c[4] * y);
+                *ptr = y;
+            }
+            state[band][0][channel] = s1;
+            state[band][1][channel] = s2;
+        }
+    }
+}
+
+// the loudest sample in each frame, for the compressor and limiter to look at.
+static void FramePeaksFloat32Audio_scalar(const float *src, const int frames, const int channels, float *peaks)
+{
+    for (int i = 0; i < frames; i++, src += channels) {
+        float peak = 0.0f;
+        for (int channel = 0; channel < channels; channel++) {
+            peak = SDL_max(peak, SDL_fabsf(src[channel]));
+        }
+        peaks[i] = peak;
+    }
+}
+
+// scale every sample in each frame by that frame's gain.
+static void ApplyFrameGainsFloat32Audio_scalar(float *buffer, const int frames, const int channels, const float *gains)
+{
+    for (int i = 0; i < frames; i++, buffer += channels) {
+        const float gain = gains[i];
+        for (int channel = 0; channel < channels; channel++) {
+            buffer[channel] *= gain;
+        }
+    }
+}
+
+// push `buffer` through the limiter's delay line, replacing it with the delayed audio scaled by `gains` and clamped to `ceiling`.
+//  `ring_in` and `ring_out` are where this run of frames goes into and comes out of the delay line; neither wraps here.
+static void ApplyLimiterFloat32Audio_scalar(float *buffer, float *ring_in, const float *ring_out, const int frames, const int channels, const float *gains, const float ceiling)
+{
+    for (int i = 0; i < frames; i++, buffer += channels, ring_in += channels, ring_out += channels) {
+        const float gain = gains[i];
+        for (int channel = 0; channel < channels; channel++) {
+            const float delayed = ring_out[channel] * gain;
+            ring_in[channel] = buffer[channel];
+            buffer[channel] = SDL_clamp(delayed, -ceiling, ceiling);
+        }
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+// load four channels, or two (with the other lanes zeroed) if `pair`.
+static __m128 SDL_TARGETING("sse") LoadChannels_sse(const float *src, const bool pair)
+{
+    return pair ? _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *) src) : _mm_loadu_ps(src);
+}
+
+static void SDL_TARGETING("sse") StoreChannels_sse(float *dst, const __m128 value, const bool pair)
+{
+    if (pair) {
+        _mm_storel_pi((__m64 *) dst, value);
+    } else {
+        _mm_storeu_ps(dst, value);
+    }
+}
+
+static void SDL_TARGETING("sse") ProcessEQFloat32Audio_sse(float *buffer, const int frames, const int channels, const int num_bands, const float (*coefficients)[5], float (*state)[2][MIX_EFFECT_MAX_CHANNELS])
+{
+    int channel = 0;
+    while ((channels - channel) >= 2) {
+        const bool pair = ((channels - channel) < 4);
+        __m128 c[MIX_MAX_EQ_BANDS][5];
+        __m128 s1[MIX_MAX_EQ_BANDS];
+        __m128 s2[MIX_MAX_EQ_BANDS];
+        for (int band = 0; band < num_bands; band++) {
+            for (int i = 0; i < 5; i++) {
+                c[band][i] = _mm_set1_ps(coefficients[band][i]);
+            }
+            s1[band] = LoadChannels_sse(&state[band][0][channel], pair);
+            s2[band] = LoadChannels_sse(&state[band][1][channel], pair);
+        }
+
+        float *ptr = buffer + channel;
+        for (int i = 0; i < frames; i++, ptr += channels) {
+            __m128 x = LoadChannels_sse(ptr, pair);
+            for (int band = 0; band < num_bands; band++) {
+                const __m128 y = _mm_add_ps(_mm_mul_ps(c[band][0], x), s1[band]);
+                s1[band] = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(c[band][1], x), _mm_mul_ps(c[band][3], y)), s2[band]);
+                s2[band] = _mm_sub_ps(_mm_mul_ps(c[band][2], x), _mm_mul_ps(c[band][4], y));
+                x = y;
+            }
+            StoreChannels_sse(ptr, x, pair);
+        }
+
+        for (int band = 0; band < num_bands; band++) {
+            StoreChannels_sse(&state[band][0][channel], s1[band], pair);
+            StoreChannels_sse(&state[band][1][channel], s2[band], pair);
+        }
+        channel += pair ? 2 : 4;
+    }
+
+    ProcessEQFloat32Audio_scalar(buffer, frames, channels, channel, num_bands, coefficients, state);  // an odd channel left over.
+}
+
+static void SDL_TARGETING("sse") FramePeaksFloat32Audio_sse(const float *src, const int frames, const int channels, float *peaks)
+{
+    const __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    for (int i = 0; i < frames; i++, src += channels) {
+        __m128 peak = _mm_setzero_ps();
+        int channel = 0;
+        for (; (channels - channel) >= 4; channel += 4) {
+            peak = _mm_max_ps(peak, _mm_and_ps(_mm_loadu_ps(src + channel), absmask));
+        }
+        if ((channels - channel) >= 2) {
+            peak = _mm_max_ps(peak, _mm_and_ps(LoadChannels_sse(src + channel, true), absmask));
+            channel += 2;
+        }
+        if (channel < channels) {
+            peak = _mm_max_ps(peak, _mm_and_ps(_mm_load_ss(src + channel), absmask));
+        }
+        peak = _mm_max_ps(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(1, 0, 3, 2)));
+        peak = _mm_max_ps(peak, _mm_shuffle_ps(peak, peak, _MM_SHUFFLE(2, 3, 0, 1)));
+        _mm_store_ss(peaks + i, peak);
+    }
+}
+
+static void SDL_TARGETING("sse") ApplyFrameGainsFloat32Audio_sse(float *buffer, const int frames, const int channels, const float *gains)
+{
+    if (channels == 1) {  // one gain per sample; no need to go frame by frame.
+        int i = 0;
+        for (; i + 4 <= frames; i += 4) {
+            _mm_storeu_ps(buffer + i, _mm_mul_ps(_mm_loadu_ps(buffer + i), _mm_loadu_ps(gains + i)));
+        }
+        ApplyFrameGainsFloat32Audio_scalar(buffer + i, frames - i, channels, gains + i);
+        return;
+    }
+
+    for (int i = 0; i < frames; i++, buffer += channels) {
+        const __m128 gain = _mm_set1_ps(gains[i]);
+        int channel = 0;
+        for (; (channels - channel) >= 4; channel += 4) {
+            _mm_storeu_ps(buffer + channel, _mm_mul_ps(_mm_loadu_ps(buffer + channel), gain));
+        }
+        if ((channels - channel) >= 2) {
+            StoreChannels_sse(buffer + channel, _mm_mul_ps(LoadChannels_sse(buffer + channel, true), gain), true);
+            channel += 2;
+        }
+        if (channel < channels) {
+            buffer[channel] *= gains[i];
+        }
+    }
+}
+
+static void SDL_TARGETING("sse") ApplyLimiterFloat32Audio_sse(float *buffer, float *ring_in, const float *ring_out, const int frames, const int channels, const float *gains, const float ceiling)
+{
+    const __m128 upper = _mm_set1_ps(ceiling);
+    const __m128 lower = _mm_set1_ps(-ceiling);
+    for (int i = 0; i < frames; i++, buffer += channels, ring_in += channels, ring_out += channels) {
+        const __m128 gain = _mm_set1_ps(gains[i]);
+        int channel = 0;
+        while ((channels - channel) >= 2) {
+            const bool pair = ((channels - channel) < 4);
+            const __m128 delayed = _mm_mul_ps(LoadChannels_sse(ring_out + channel, pair), gain);
+            StoreChannels_sse(ring_in + channel, LoadChannels_sse(buffer + channel, pair), pair);
+            StoreChannels_sse(buffer + channel, _mm_min_ps(_mm_max_ps(delayed, lower), upper), pair);
+            channel += pair ? 2 : 4;
+        }
+        if (channel < channels) {
+            const float delayed = ring_out[channel] * gains[i];
+            ring_in[channel] = buffer[channel];
+            buffer[channel] = SDL_clamp(delayed, -ceiling, ceiling);
+        }
+    }
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+// load four channels, or two (with the other lanes zeroed) if `pair`.
+static float32x4_t LoadChannels_neon(const float *src, const bool pair)
+{
+    return pair ? vcombine_f32(vld1_f32(src), vdup_n_f32(0.0f)) : vld1q_f32(src);
+}
+
+static void StoreChannels_neon(float *dst, const float32x4_t value, const bool pair)
+{
+    if (pair) {
+        vst1_f32(dst, vget_low_f32(value));
+    } else {
+        vst1q_f32(dst, value);
+    }
+}
+
+static void ProcessEQFloat32Audio_neon(float *buffer, const int frames, const int channels, const int num_bands, const float (*coefficients)[5], float (*state)[2][MIX_EFFECT_MAX_CHANNELS])
+{
+    int channel = 0;
+    while ((channels - channel) >= 2) {
+        const bool pair = ((channels - channel) < 4);
+        float32x4_t c[MIX_MAX_EQ_BANDS][5];
+        float32x4_t s1[MIX_MAX_EQ_BANDS];
+        float32x4_t s2[MIX_MAX_EQ_BANDS];
+        for (int band = 0; band < num_bands; band++) {
+            for (int i = 0; i < 5; i++) {
+                c[band][i] = vdupq_n_f32(coefficients[band][i]);
+            }
+            s1[band] = LoadChannels_neon(&state[band][0][channel], pair);
+            s2[band] = LoadChannels_neon(&state[band][1][channel], pair);
+        }
+
+        float *ptr = buffer + channel;
+        for (int i = 0; i < frames; i++, ptr += channels) {
+            float32x4_t x = LoadChannels_neon(ptr, pair);
+            for (int band = 0; band < num_bands; band++) {
+                const float32x4_t y = vmlaq_f32(s1[band], c[band][0], x);
+                s1[band] = vmlsq_f32(vmlaq_f32(s2[band], c[band][1], x), c[band][3], y);
+                s2[band] = vmlsq_f32(vmulq_f32(c[band][2], x), c[band][4], y);
+                x = y;
+            }
+            StoreChannels_neon(ptr, x, pair);
+        }
+
+        for (int band = 0; band < num_bands; band++) {
+            StoreChannels_neon(&state[band][0][channel], s1[band], pair);
+            StoreChannels_neon(&state[band][1][channel], s2[band], pair);
+        }
+        channel += pair ? 2 : 4;
+    }
+
+    ProcessEQFloat32Audio_scalar(buffer, frames, channels, channel, num_bands, coefficients, state);  // an odd channel left over.
+}
+
+static void FramePeaksFloat32Audio_neon(const float *src, const int frames, const int channels, float *peaks)
+{
+    for (int i = 0; i < frames; i++, src += channels) {
+        float32x4_t peak = vdupq_n_f32(0.0f);
+        int channel = 0;
+        for (; (channels - channel) >= 4; channel += 4) {
+            peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(src + channel)));
+        }
+        if ((channels - channel) >= 2) {
+            peak = vmaxq_f32(peak, vabsq_f32(LoadChannels_neon(src + channel, true)));
+            channel += 2;
+        }
+        if (channel < channels) {
+            peak = vmaxq_f32(peak, vabsq_f32(vsetq_lane_f32(src[channel], vdupq_n_f32(0.0f), 0)));
+        }
+        const float32x2_t folded = vpmax_f32(vget_low_f32(peak), vget_high_f32(peak));
+        peaks[i] = vget_lane_f32(vpmax_f32(folded, folded), 0);
+    }
+}
+
+static void ApplyFrameGainsFloat32Audio_neon(float *buffer, const int frames, const int channels, const float *gains)
+{
+    if (channels == 1) {  // one gain per sample; no need to go frame by frame.
+        int i = 0;
+        for (; i + 4 <= frames; i += 4) {
+            vst1q_f32(buffer + i, vmulq_f32(vld1q_f32(buffer + i), vld1q_f32(gains + i)));
+        }
+        ApplyFrameGainsFloat32Audio_scalar(buffer + i, frames - i, channels, gains + i);
+        return;
+    }
+
+    for (int i = 0; i < frames; i++, buffer += channels) {
+        const float gain = gains[i];
+        int channel = 0;
+        for (; (channels - channel) >= 4; channel += 4) {
+            vst1q_f32(buffer + channel, vmulq_n_f32(vld1q_f32(buffer + channel), gain));
+        }
+        if ((channels - channel) >= 2) {
+            vst1_f32(buffer + channel, vmul_n_f32(vld1_f32(buffer + channel), gain));
+            channel += 2;
+        }
+        if (channel < channels) {
+            buffer[channel] *= gain;
+        }
+    }
+}
+
+static void ApplyLimiterFloat32Audio_neon(float *buffer, float *ring_in, const float *ring_out, const int frames, const int channels, const float *gains, const float ceiling)
+{
+    const float32x4_t upper = vdupq_n_f32(ceiling);
+    const float32x4_t lower = vdupq_n_f32(-ceiling);
+    for (int i = 0; i < frames; i++, buffer += channels, ring_in += channels, ring_out += channels) {
+        const float gain = gains[i];
+        int channel = 0;
+        while ((channels - channel) >= 2) {
+            const bool pair = ((channels - channel) < 4);
+            const float32x4_t delayed = vmulq_n_f32(LoadChannels_neon(ring_out + channel, pair), gain);
+            StoreChannels_neon(ring_in + channel, LoadChannels_neon(buffer + channel, pair), pair);
+            StoreChannels_neon(buffer + channel, vminq_f32(vmaxq_f32(delayed, lower), upper), pair);
+            channel += pair ? 2 : 4;
+        }
+        if (channel < channels) {
+            const float delayed = ring_out[channel] * gain;
+            ring_in[channel] = buffer[channel];
+            buffer[channel] = SDL_clamp(delayed, -ceiling, ceiling);
+        }
+    }
+}
+#endif
+
+static void ProcessEQFloat32Audio(float *buffer, const int frames, const int channels, const int num_bands, const float (*coefficients)[5], float (*state)[2][MIX_EFFECT_MAX_CHANNELS])
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        ProcessEQFloat32Audio_sse(buffer, frames, channels, num_bands, coefficients, state);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        ProcessEQFloat32Audio_neon(buffer, frames, channels, num_bands, coefficients, state);
+    } else
+    #endif
+    {
+        ProcessEQFloat32Audio_scalar(buffer, frames, channels, 0, num_bands, coefficients, state);
+    }
+}
+
+static void FramePeaksFloat32Audio(const float *src, const int frames, const int channels, float *peaks)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        FramePeaksFloat32Audio_sse(src, frames, channels, peaks);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        FramePeaksFloat32Audio_neon(src, frames, channels, peaks);
+    } else
+    #endif
+    {
+        FramePeaksFloat32Audio_scalar(src, frames, channels, peaks);
+    }
+}
+
+static void ApplyFrameGainsFloat32Audio(float *buffer, const int frames, const int channels, const float *gains)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        ApplyFrameGainsFloat32Audio_sse(buffer, frames, channels, gains);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        ApplyFrameGainsFloat32Audio_neon(buffer, frames, channels, gains);
+    } else
+    #endif
+    {
+        ApplyFrameGainsFloat32Audio_scalar(buffer, frames, channels, gains);
+    }
+}
+
+static void ApplyLimiterFloat32Audio(float *buffer, float *ring_in, const float *ring_out, const int frames, const int channels, const float *gains, const float ceiling)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        ApplyLimiterFloat32Audio_sse(buffer, ring_in, ring_out, frames, channels, gains, ceiling);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        ApplyLimiterFloat32Audio_neon(buffer, ring_in, ring_out, frames, channels, gains, ceiling);
+    } else
+    #endif
+    {
+        ApplyLimiterFloat32Audio_scalar(buffer, ring_in, ring_out, frames, channels, gains, ceiling);
+    }
+}
+
+// The send buses' reverb is a feedback delay network. Every frame, each delay line's output is damped by a one-pole
+//  low-pass, scaled by how much that line decays per trip, and mixed with all the others through a Householder matrix
+//  (subtract 2/N of their sum from each), which scatters every echo into every line without adding or losing energy.
+//  That goes back into the lines along with the new input. Left and right tap the lines with orthogonal sign patterns,
+//  so they come out decorrelated. The lines are interleaved, so the feedback runs on all of them at once as vectors;
+//  only reading their outputs (each line is a different length) is a gather.
+static const float SDL_ALIGNED(16) MIX_ReverbInputGains[MIX_REVERB_LINES] = { 0.35f, 0.35f, -0.35f, -0.35f, 0.35f, 0.35f, -0.35f, -0.35f };
+static const float SDL_ALIGNED(16) MIX_ReverbLeftGains[MIX_REVERB_LINES] = { 0.35f, 0.35f, 0.35f, 0.35f, -0.35f, -0.35f, -0.35f, -0.35f };
+static const float SDL_ALIGNED(16) MIX_ReverbRightGains[MIX_REVERB_LINES] = { 0.35f, -0.35f, 0.35f, -0.35f, 0.35f, -0.35f, 0.35f, -0.35f };
+
+// downmix one frame to mono and push it through the pre-delay.
+static float ReverbInput(MIX_ReverbState *reverb, const float *frame, const int channels, const float downmix)
+{
+    float input = 0.0f;
+    for (int channel = 0; channel < channels; channel++) {
+        input += frame[channel];
+    }
+
+    reverb->predelay[reverb->predelay_position] = input * downmix;
+    int index = reverb->predelay_position - reverb->predelay_length;
+    if (index < 0) {
+        index += reverb->predelay_capacity;
+    }
+    if (++reverb->predelay_position == reverb->predelay_capacity) {
+        reverb->predelay_position = 0;
+    }
+    return reverb->predelay[index];
+}
+
+// gather what comes out of each delay line this frame.
+static void ReverbTaps(const MIX_ReverbState *reverb, float *taps)
+{
+    for (int i = 0; i < MIX_REVERB_LINES; i++) {
+        int index = reverb->position - reverb->lengths[i];
+        if (index < 0) {
+            index += reverb->capacity;
+        }
+        taps[i] = reverb->lines[(index * MIX_REVERB_LINES) + i];
+    }
+}
+
+// How much of the reverb's left and right each output channel gets, in SDL's channel order for each channel count:
+//  left-side speakers get the left, right-side ones get the right, center speakers (front, and back center in 6.1)
+//  get the mean of both, and the LFE gets nothing.
+static const float MIX_ReverbOutputLeft[MIX_EFFECT_MAX_CHANNELS][MIX_EFFECT_MAX_CHANNELS] = {
+    { 0.5f },                                          // mono: FC
+    { 1.0f, 0.0f },                                    // stereo: FL FR
+    { 1.0f, 0.0f, 0.0f },                              // 2.1: FL FR LFE
+    { 1.0f, 0.0f, 1.0f, 0.0f },                        // quad: FL FR BL BR
+    { 1.0f, 0.0f, 0.0f, 1.0f, 0.0f },                  // 4.1: FL FR LFE BL BR
+    { 1.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.0f },            // 5.1: FL FR FC LFE BL BR
+    { 1.0f, 0.0f, 0.5f, 0.0f, 0.5f, 1.0f, 0.0f },      // 6.1: FL FR FC LFE BC SL SR
+    { 1.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f } // 7.1: FL FR FC LFE BL BR SL SR
+};
+static const float MIX_ReverbOutputRight[MIX_EFFECT_MAX_CHANNELS][MIX_EFFECT_MAX_CHANNELS] = {
+    { 0.5f },
+    { 0.0f, 1.0f },
+    { 0.0f, 1.0f, 0.0f },
+    { 0.0f, 1.0f, 0.0f, 1.0f },
+    { 0.0f, 1.0f, 0.0f, 0.0f, 1.0f },
+    { 0.0f, 1.0f, 0.5f, 0.0f, 0.0f, 1.0f },
+    { 0.0f, 1.0f, 0.5f, 0.0f, 0.5f, 0.0f, 1.0f },
+    { 0.0f, 1.0f, 0.5f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f }
+};
+
+// spread the reverb's left and right over the output channels.
+static void ReverbOutput(float *frame, const int channels, const float left, const float right)
+{
+    const int layout = SDL_min(channels, MIX_EFFECT_MAX_CHANNELS) - 1;
+    const float *lgains = MIX_ReverbOutputLeft[layout];
+    const float *rgains = MIX_ReverbOutputRight[layout];
+    for (int channel = 0; channel < channels; channel++) {
+        if (channel < MIX_EFFECT_MAX_CHANNELS) {
+            frame[channel] = (left * lgains[channel]) + (right * rgains[channel]);
+        } else {
+            frame[channel] = 0.0f;  // SDL doesn't define a layout past 7.1, so don't guess where these are.
+        }
+    }
+}
+
+// replace `buffer` with the reverb of it. Returns the loudest sample that came out, so the caller can tell when the tail has faded.
+static float ProcessReverbFloat32Audio_scalar(MIX_ReverbState *reverb, float *buffer, const int frames, const int channels)
+{
+    const float downmix = 1.0f / channels;
+    const float damping = reverb->damping;
+    float *state = reverb->damping_state;
+    float peak = 0.0f;
+
+    for (int i = 0; i < frames; i++, buffer += channels) {
+        const float input = ReverbInput(reverb, buffer, channels, downmix);
+        float taps[MIX_REVERB_LINES];
+        float feedback[MIX_REVERB_LINES];
+        float sum = 0.0f;
+        float left = 0.0f;
+        float right = 0.0f;
+
+        ReverbTaps(reverb, taps);
+        for (int line = 0; line < MIX_REVERB_LINES; line++) {
+            state[line] = taps[line] + (damping * (state[line] - taps[line]));
+            feedback[line] = state[line] * reverb->feedback[line];
+            sum += feedback[line];
+            left += taps[line] * MIX_ReverbLeftGains[line];
+            right += taps[line] * MIX_ReverbRightGains[line];
+        }
+
+        sum *= 2.0f / MIX_REVERB_LINES;
+        float *slot = reverb->lines + (reverb->position * MIX_REVERB_LINES);
+        for (int line = 0; line < MIX_REVERB_LINES; line++) {
+            slot[line] = (feedback[line] - sum) + (input * MIX_ReverbInputGains[line]);
+        }
+        if (++reverb->position == reverb->capacity) {
+            reverb->position = 0;
+        }
+
+        ReverbOutput(buffer, channels, left, right);
+        peak = SDL_max(peak, SDL_max(SDL_fabsf(left), SDL_fabsf(right)));
+    }
+
+    return peak;
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static float SDL_TARGETING("sse") ProcessReverbFloat32Audio_sse(MIX_ReverbState *reverb, float *buffer, const int frames, const int channels)
+{
+    const float downmix = 1.0f / channels;
+    const __m128 damping = _mm_set1_ps(reverb->damping);
+    const __m128 decay0 = _mm_load_ps(reverb->feedback);
+    const __m128 decay1 = _mm_load_ps(reverb->feedback + 4);
+    const __m128 input0 = _mm_load_ps(MIX_ReverbInputGains);
+    const __m128 input1 = _mm_load_ps(MIX_ReverbInputGains + 4);
+    const __m128 left0 = _mm_load_ps(MIX_ReverbLeftGains);
+    const __m128 left1 = _mm_load_ps(MIX_ReverbLeftGains + 4);
+    const __m128 right0 = _mm_load_ps(MIX_ReverbRightGains);
+    const __m128 right1 = _mm_load_ps(MIX_ReverbRightGains + 4);
+    const __m128 householder = _mm_set1_ps(2.0f / MIX_REVERB_LINES);
+    __m128 state0 = _mm_load_ps(reverb->damping_state);
+    __m128 state1 = _mm_load_ps(reverb->damping_state + 4);
+    float SDL_ALIGNED(16) taps[MIX_REVERB_LINES];
+    float SDL_ALIGNED(16) totals[4];
+    float peak = 0.0f;
+
+    for (int i = 0; i < frames; i++, buffer += channels) {
+        const __m128 input = _mm_set1_ps(ReverbInput(reverb, buffer, channels, downmix));
+        ReverbTaps(reverb, taps);
+        const __m128 tap0 = _mm_load_ps(taps);
+        const __m128 tap1 = _mm_load_ps(taps + 4);
+
+        state0 = _mm_add_ps(tap0, _mm_mul_ps(damping, _mm_sub_ps(state0, tap0)));
+        state1 = _mm_add_ps(tap1, _mm_mul_ps(damping, _mm_sub_ps(state1, tap1)));
+        const __m128 feedback0 = _mm_mul_ps(state0, decay0);
+        const __m128 feedback1 = _mm_mul_ps(state1, decay1);
+
+        // sum the feedback, left and right across all the lines at once: transpose them and add the rows.
+        __m128 sum = _mm_add_ps(feedback0, feedback1);
+        __m128 left = _mm_add_ps(_mm_mul_ps(tap0, left0), _mm_mul_ps(tap1, left1));
+        __m128 right = _mm_add_ps(_mm_mul_ps(tap0, right0), _mm_mul_ps(tap1, right1));
+        __m128 unused = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(sum, left, right, unused);
+        const __m128 total = _mm_add_ps(_mm_add_ps(sum, left), _mm_add_ps(right, unused));  // { feedback, left, right, 0 }
+        const __m128 scatter = _mm_mul_ps(_mm_shuffle_ps(total, total, _MM_SHUFFLE(0, 0, 0, 0)), householder);
+
+        float *slot = reverb->lines + (reverb->position * MIX_REVERB_LINES);
+        _mm_store_ps(slot, _mm_add_ps(_mm_sub_ps(feedback0, scatter), _mm_mul_ps(input, input0)));
+        _mm_store_ps(slot + 4, _mm_add_ps(_mm_sub_ps(feedback1, scatter), _mm_mul_ps(input, input1)));
+        if (++reverb->position == reverb->capacity) {
+            reverb->position = 0;
+        }
+
+        _mm_store_ps(totals, total);
+        ReverbOutput(buffer, channels, totals[1], totals[2]);
+        peak = SDL_max(peak, SDL_max(SDL_fabsf(totals[1]), SDL_fabsf(totals[2])));
+    }
+
+    _mm_store_ps(reverb->damping_state, state0);
+    _mm_store_ps(reverb->damping_state + 4, state1);
+    return peak;
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static float ProcessReverbFloat32Audio_neon(MIX_ReverbState *reverb, float *buffer, const int frames, const int channels)
+{
+    const float downmix = 1.0f / channels;
+    const float32x4_t damping = vdupq_n_f32(reverb->damping);
+    const float32x4_t decay0 = vld1q_f32(reverb->feedback);
+    const float32x4_t decay1 = vld1q_f32(reverb->feedback + 4);
+    const float32x4_t input0 = vld1q_f32(MIX_ReverbInputGains);
+    const float32x4_t input1 = vld1q_f32(MIX_ReverbInputGains + 4);
+    const float32x4_t left0 = vld1q_f32(MIX_ReverbLeftGains);
+    const float32x4_t left1 = vld1q_f32(MIX_ReverbLeftGains + 4);
+    const float32x4_t right0 = vld1q_f32(MIX_ReverbRightGains);
+    const float32x4_t right1 = vld1q_f32(MIX_ReverbRightGains + 4);
+    float32x4_t state0 = vld1q_f32(reverb->damping_state);
+    float32x4_t state1 = vld1q_f32(reverb->damping_state + 4);
+    float SDL_ALIGNED(16) taps[MIX_REVERB_LINES];
+    float peak = 0.0f;
+
+    for (int i = 0; i < frames; i++, buffer += channels) {
+        const float input = ReverbInput(reverb, buffer, channels, downmix);
+        ReverbTaps(reverb, taps);
+        const float32x4_t tap0 = vld1q_f32(taps);
+        const float32x4_t tap1 = vld1q_f32(taps + 4);
+
+        state0 = vmlaq_f32(tap0, damping, vsubq_f32(state0, tap0));
+        state1 = vmlaq_f32(tap1, damping, vsubq_f32(state1, tap1));
+        const float32x4_t feedback0 = vmulq_f32(state0, decay0);
+        const float32x4_t feedback1 = vmulq_f32(state1, decay1);
+
+        // fold each sum down to two lanes, then pairwise-add those into { left, right } and { feedback, feedback }.
+        const float32x4_t sum = vaddq_f32(feedback0, feedback1);
+        const float32x4_t left = vmlaq_f32(vmulq_f32(tap0, left0), tap1, left1);
+        const float32x4_t right = vmlaq_f32(vmulq_f32(tap0, right0), tap1, right1);
+        const float32x2_t sum2 = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+        const float32x2_t stereo = vpadd_f32(vadd_f32(vget_low_f32(left), vget_high_f32(left)), vadd_f32(vget_low_f32(right), vget_high_f32(right)));
+        const float32x4_t scatter = vdupq_lane_f32(vmul_n_f32(vpadd_f32(sum2, sum2), 2.0f / MIX_REVERB_LINES), 0);
+
+        float *slot = reverb->lines + (reverb->position * MIX_REVERB_LINES);
+        vst1q_f32(slot, vmlaq_n_f32(vsubq_f32(feedback0, scatter), input0, input));
+        vst1q_f32(slot + 4, vmlaq_n_f32(vsubq_f32(feedback1, scatter), input1, input));
+        if (++reverb->position == reverb->capacity) {
+            reverb->position = 0;
+        }
+
+        const float l = vget_lane_f32(stereo, 0);
+        const float r = vget_lane_f32(stereo, 1);
+        ReverbOutput(buffer, channels, l, r);
+        peak = SDL_max(peak, SDL_max(SDL_fabsf(l), SDL_fabsf(r)));
+    }
+
+    vst1q_f32(reverb->damping_state, state0);
+    vst1q_f32(reverb->damping_state + 4, state1);
+    return peak;
+}
+#endif
+
+static float ProcessReverbFloat32Audio(MIX_ReverbState *reverb, float *buffer, const int frames, const int channels)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        return ProcessReverbFloat32Audio_sse(reverb, buffer, frames, channels);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        return ProcessReverbFloat32Audio_neon(reverb, buffer, frames, channels);
+    } else
+    #endif
+    {
+        return ProcessReverbFloat32Audio_scalar(reverb, buffer, frames, channels);
+    }
+}
+
+// Voice limiting: when there are more playing tracks than the mixer's voice budget, or tracks too quiet to matter,
+//  the extras become "virtual." They don't decode or mix anything, but their position moves along as if they did,
+//  so they can come back at the right spot when they're worth hearing again.
+
+// How long a virtual track takes to fade back in when it becomes a real voice again, so it doesn't pop.
+#define MIX_VIRTUAL_RESUME_FADE_MS 10
+
+// this assumes LockTrack(track) was called before this.
+static bool CanVirtualizeTrack(const MIX_Track *track)
+{
+    if (!track->input_audio) {
+        return false;  // streaming input, we can't skip ahead in it.
+    } else if (track->decode_ahead && (track->decode_ahead->channels > 0)) {
+        return false;  // the decoder belongs to a worker thread, we can't seek it from here.
+    } else if ((track->input_audio->duration_frames == MIX_DURATION_UNKNOWN) && (track->max_frame < 0)) {
+        return false;  // we wouldn't know when it ends.
+    }
+    return true;
+}
+
+// Move a virtual track along by `mixer_frames` of the mixer's output, handling loops, fades, appended silence, and stopping.
+// this is called from MixTrack, so the mixer is locked (by the device thread).
+static void AdvanceVirtualTrack(MIX_Mixer *mixer, MIX_Track *track, int mixer_frames)
+{
+    LockTrack(track);
+
+    if (!track->virtualized || (track->state != MIX_STATE_PLAYING) || !track->input_audio) {
+        UnlockTrack(track);
+        return;
+    }
+
+    const double ratio = (double) SDL_GetAudioStreamFrequencyRatio(track->output_stream);
+    track->virtual_frames += (((double) mixer_frames) * ratio * ((double) track->input_audio->spec.freq)) / ((double) mixer->spec.freq);
+    Sint64 frames = (Sint64) track->virtual_frames;
+    track->virtual_frames -= (double) frames;
+
+    // this mirrors what TrackGetCallback does with real data. The stopped callback might restart the track, so check state every time.
+    bool looped_without_progress = false;
+    while ((frames > 0) && track->virtualized && (track->state == MIX_STATE_PLAYING)) {
+        if (track->silence_frames > 0) {
+            const Sint64 silence = SDL_min(frames, track->silence_frames);
+            track->silence_frames -= silence;
+            frames -= silence;
+            if (track->silence_frames == 0) {
+                TrackStopped(track);
+            }
+            continue;
+        }
+
+        Sint64 maxpos = track->max_frame;
+        const Sint64 duration = track->input_audio->duration_frames;
+        if ((duration >= 0) && ((maxpos < 0) || (duration < maxpos))) {
+            maxpos = duration;
+        }
+        if (track->fade_direction < 0) {
+            const Sint64 maxfadepos = (Sint64) (track->position + track->fade_frames);
+            if ((maxpos < 0) || (maxfadepos < maxpos)) {
+                maxpos = maxfadepos;
+            }
+        }
+
+        Sint64 step = frames;
+        bool end_of_audio = false;
+        if (maxpos >= 0) {
+            const Sint64 available = SDL_max(maxpos - (Sint64) track->position, 0);
+            if (available <= frames) {
+                step = available;
+                end_of_audio = true;
+            }
+        }
+
+        track->position += step;
+        frames -= step;
+
+        if (track->fade_direction != 0) {
+            track->fade_frames -= SDL_min(step, track->fade_frames);
+            if (track->fade_frames == 0) {  // fade is done.
+                if (track->fade_direction < 0) {
+                    track->loops_remaining = 0;  // we were fading out, don't loop anymore.
+                }
+                track->fade_direction = 0;
+            }
+        }
+
+        if (end_of_audio) {
+            if (track->loops_remaining == 0) {
+                if (track->silence_frames < 0) {
+                    track->silence_frames = -track->silence_frames;  // time to start appending silence.
+                } else {
+                    TrackStopped(track);
+                }
+            } else if ((step == 0) && looped_without_progress) {
+                TrackStopped(track);  // the loop has nothing in it; don't spin here forever.
+            } else {
+                if (track->loops_remaining > 0) {  // negative means infinite loops, so don't decrement for that.
+                    track->loops_remaining--;
+                }
+                track->position = track->loop_start;
+                looped_without_progress = (step == 0);
+            }
+        }
+    }
+
+    UnlockTrack(track);
+}
+
+// Returns false if this track can't be virtual, in which case it stays a real voice.
+static bool VirtualizeTrack(MIX_Track *track)
+{
+    LockTrack(track);
+    const bool retval = CanVirtualizeTrack(track);
+    if (retval) {
+        track->virtualized = true;
+        track->virtual_frames = 0.0;
+        SDL_ClearAudioStream(track->output_stream);  // drop anything already converted; we're not going to mix it.
+    }
+    UnlockTrack(track);
+    return retval;
+}
+
+static void DevirtualizeTrack(MIX_Track *track)
+{
+    LockTrack(track);
+    track->virtualized = false;
+    if ((track->state == MIX_STATE_PLAYING) && track->input_audio && (track->silence_frames <= 0)) {
+        // the decoder is wherever we left it, so catch it up to where we should be now.
+        if (!track->input_audio->decoder->seek(track->decoder_userdata, track->position)) {
+            TrackStopped(track);  // uhoh, can't seek! Abandon ship!
+        } else {
+            SDL_ClearAudioStream(track->input_stream);
+            if (track->fade_direction == 0) {  // if the app had a fade going, just let it continue instead.
+                track->total_fade_frames = SDL_max(1, MIX_MSToFrames(track->input_audio->spec.freq, MIX_VIRTUAL_RESUME_FADE_MS));
+                track->fade_frames = track->total_fade_frames;
+                track->fade_direction = 1;
+                track->fade_curve = MIX_FADE_CURVE_LINEAR;
+            }
+        }
+    }
+    UnlockTrack(track);
+}
+
+static int SDLCALL CompareVoices(const void *a, const void *b)
+{
+    const MIX_Track *track_a = *(const MIX_Track * const *) a;
+    const MIX_Track *track_b = *(const MIX_Track * const *) b;
+    if (track_a->priority != track_b->priority) {
+        return (track_a->priority > track_b->priority) ? -1 : 1;
+    } else if (track_a->audibility != track_b->audibility) {
+        return (track_a->audibility > track_b->audibility) ? -1 : 1;
+    } else if (track_a->virtualized != track_b->virtualized) {
+        return track_a->virtualized ? 1 : -1;  // on a tie, favor what's already real, so voices don't flap back and forth.
+    }
+    return 0;
+}
+
+// Rank all the playing tracks, and decide which ones are real voices for this callback.
+// this is only called from MixerCallback, so the mixer is locked and nothing else touches mixer->voice_tracks.
+static void UpdateVoices(MIX_Mixer *mixer)
+{
+    const int max_voices = mixer->max_voices;
+    const float threshold = mixer->audibility_threshold;
+    if ((max_voices <= 0) && (threshold <= 0.0f) && (mixer->num_track_audibility_thresholds == 0) && (mixer->num_virtual_tracks == 0)) {
+        return;  // voice limiting is off, and nothing is left over from when it was on.
+    }
+
+    int total_tracks = 0;
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        total_tracks++;
+    }
+
+    if (total_tracks > mixer->voice_tracks_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);  // ReserveRealtimeBuffers should have taken care of this.
+        void *ptr = SDL_realloc(mixer->voice_tracks, total_tracks * sizeof (MIX_Track *));
+        if (!ptr) {
+            return;  // leave everything as it was; we'll try again next time.
+        }
+        mixer->voice_tracks = (MIX_Track **) ptr;
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+        mixer->voice_tracks_allocation = total_tracks;
+    }
+
+    int num_virtual = 0;
+    int num_voices = 0;
+    MIX_Track **voices = mixer->voice_tracks;
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        if (track->state == MIX_STATE_PLAYING) {
+            track->audibility = track->gain * track->attenuation;
+            if (track->spatialization_mode == MIX_SPATIALIZATION_3D) {
+                track->audibility *= track->occlusion_gain;
+            }
+            voices[num_voices++] = track;
+        } else if (track->virtualized) {
+            num_virtual++;  // paused tracks stay virtual, so they get their decoder caught up when resumed.
+        }
+    }
+
+    SDL_qsort(voices, num_voices, sizeof (*voices), CompareVoices);
+
+    int num_real = 0;
+    for (int i = 0; i < num_voices; i++) {
+        MIX_Track *track = voices[i];
+        const float track_threshold = (track->audibility_threshold >= 0.0f) ? track->audibility_threshold : threshold;
+        const bool audible = (track->audibility >= track_threshold);
+        bool real = audible && ((max_voices <= 0) || (num_real < max_voices));
+        if (real) {
+            if (track->virtualized) {
+                DevirtualizeTrack(track);
+            }
+        } else if (!track->virtualized && !VirtualizeTrack(track)) {
+            real = true;  // can't skip this one, it has to stay real.
+        }
+        track->culled = !real && !audible;
+
+        if (real) {
+            num_real++;
+        } else {
+            num_virtual++;
+        }
+    }
+
+    mixer->num_virtual_tracks = num_virtual;
+}
+
+// Is the mixer set up to render binaurally right now?
+static bool BinauralAvailable(const MIX_Mixer *mixer)
+{
+    return mixer->hrtf && (mixer->spec.channels == 2) && (mixer->hrtf->freq == mixer->spec.freq);
+}
+
+// Encode a 3D track into an ambisonic bus. Like panning, the encoding gains ramp across the block when they change.
+static void EncodeAmbisonicTrackAudio(MIX_Mixer *mixer, MIX_Track *track, MIX_AmbisonicBus *bus, const float *src, int samples, float gain)
+{
+    const int channels = (mixer->ambisonic_order * 2) + 1;
+    float gains[MIX_AMBISONIC_MAX_CHANNELS];
+    MIX_AmbisonicEncodingGains(mixer->ambisonic_order, gain * track->attenuation, track->spatialization_radians, gains);
+
+    const float *from = track->mixed_ambisonic_valid ? track->mixed_ambisonic_gains : gains;
+    samples = SDL_min(samples, bus->frames);
+    if (samples > 0) {
+        for (int i = 0; i < channels; i++) {
+            MixRampFloat32Audio(bus->buffer + (i * bus->frames), src, samples, from[i], (gains[i] - from[i]) / (float) samples);
+        }
+        bus->used = true;
+    }
+
+    SDL_memcpy(track->mixed_ambisonic_gains, gains, sizeof (float) * channels);
+    track->mixed_ambisonic_valid = true;
+}
+
+// Render a 3D track through the mixer's HRTF, if there is one and the output is stereo. Returns false to pan it across speakers instead.
+// this is called from the audio device thread, or a render thread, with the mixer locked (by the device thread), so mixer->hrtf can't change here.
+static bool MixBinauralTrackAudio(MIX_Mixer *mixer, MIX_Track *track, float *mixbuf, const float *src, int samples, float gain)
+{
+    const MIX_HRTF *hrtf = mixer->hrtf;
+    if (!BinauralAvailable(mixer)) {
+        return false;
+    } else if (!track->binaural) {
+        return false;  // it couldn't be allocated on the app's thread; just pan it like usual. We don't allocate here.
+    }
+
+    MIX_RenderBinaural(hrtf, track->binaural, src, samples, track->spatialization_radians, gain * track->attenuation, mixbuf);
+    return true;
+}
+
+// Mix `br` bytes of a track's output_spec audio from `src` into `mixbuf` as-is, with no positioning or panning, applying `gain` in the same pass.
+//  Mono goes to the front left and right speakers. Returns the number of bytes of `mixbuf` that were touched.
+static int MixUnspatializedTrackAudio(MIX_Mixer *mixer, MIX_Track *track, float *mixbuf, const float *src, int br, float gain)
+{
+    if (track->output_spec.channels == mixer->spec.channels) {
+        MixFloat32Audio(mixbuf, src, br, gain);
+        return br;
+    } else if (track->output_spec.channels == 1) {  // MIX_SetMixerNativeChannels kept this mono; expand it here.
+        static const float front_gains[2] = { 1.0f, 1.0f };
+        static const int front_speakers[2] = { 0, 1 };
+        MixSpatializedFloat32Audio(mixbuf, src, br / sizeof (float), mixer->spec.channels, front_gains, front_speakers, gain);
+        return br * mixer->spec.channels;
+    }
+
+    // MIX_SetMixerNativeChannels kept this stereo on surround output; expand it here.
+    static const float front_gains[2] = { 1.0f, 1.0f };
+    SDL_assert(track->output_spec.channels == 2);
+    MixForcedStereoFloat32Audio(mixbuf, src, br / (sizeof (float) * 2), mixer->spec.channels, front_gains, gain);
+    return (br / 2) * mixer->spec.channels;
+}
+
+// Mix `br` bytes of a track's output_spec audio from `src` into `mixbuf`, applying `gain` in the same pass. Returns the number of bytes of `mixbuf` that were touched.
+// If `ambisonic` isn't NULL, 3D tracks are encoded there instead of mixbuf.
+// `filterbuf` must hold `br` bytes; occluded 3D tracks that can't filter as they mix are low-passed there first. It may be `src`.
+static int MixTrackAudio(MIX_Mixer *mixer, MIX_Track *track, float *mixbuf, MIX_AmbisonicBus *ambisonic, float *filterbuf, const float *src, int br, float gain)
+{
+    int mixed_bytes = 0;
+
+    if (track->spatialization_mode != MIX_SPATIALIZATION_3D) {
+        track->mixed_panning_valid = false;  // if this goes 3D later, start fresh instead of ramping from wherever it used to be.
+        track->mixed_ambisonic_valid = false;
+    }
+
+    switch (track->spatialization_mode) {
+        case MIX_SPATIALIZATION_NONE:
+            mixed_bytes = MixUnspatializedTrackAudio(mixer, track, mixbuf, src, br, gain);
+            break;
+
+        case MIX_SPATIALIZATION_3D: {
+            SDL_assert(track->output_spec.channels == 1);
+            const int samples = br / sizeof (float);
+            const float lowpass = track->lowpass_coefficient;
+            bool filtered = false;
+            gain *= track->occlusion_gain;
+            if (lowpass >= 1.0f) {
+                if (samples > 0) {
+                    track->lowpass_state = src[samples - 1];  // so the filter picks up seamlessly if it turns on later.
+                }
+            } else if (ambisonic || BinauralAvailable(mixer)) {
+                LowpassFloat32Audio(filterbuf, src, samples, lowpass, &track->lowpass_state);
+                src = filterbuf;
+                filtered = true;
+            }
+
+            if (ambisonic) {
+                EncodeAmbisonicTrackAudio(mixer, track, ambisonic, src, br / sizeof (float), gain);
+                track->mixed_panning_valid = false;
+                break;  // nothing touched mixbuf yet; the bus gets decoded into it once all the tracks are encoded.
+            }
+
+            track->mixed_ambisonic_valid = false;
+            if (MixBinauralTrackAudio(mixer, track, mixbuf, src, br / sizeof (float), gain)) {
+                track->mixed_panning_valid = false;
+                mixed_bytes = br * mixer->spec.channels;
+                break;
+            }
+
+            const float *panning = track->spatialization_panning;
+            const int *speakers = track->spatialization_speakers;
+            if ((lowpass < 1.0f) && !filtered) {  // filter while we mix, in one pass.
+                const float *from_panning = track->mixed_panning_valid ? track->mixed_panning : panning;
+                const int *from_speakers = track->mixed_panning_valid ? track->mixed_speakers : speakers;
+                MixSpatializedLowpassFloat32Audio(mixbuf, src, samples, mixer->spec.channels, from_panning, from_speakers, panning, speakers, gain, lowpass, &track->lowpass_state);
+            } else if (track->mixed_panning_valid &&
+                ((track->mixed_panning[0] != panning[0]) || (track->mixed_panning[1] != panning[1]) ||
+                 (track->mixed_speakers[0] != speakers[0]) || (track->mixed_speakers[1] != speakers[1]))) {
+                MixSpatializedRampFloat32Audio(mixbuf, src, br / sizeof (float), mixer->spec.channels, track->mixed_panning, track->mixed_speakers, panning, speakers, gain);
+            } else {
+                MixSpatializedFloat32Audio(mixbuf, src, br / sizeof (float), mixer->spec.channels, panning, speakers, gain);
+            }
+            track->mixed_panning[0] = panning[0];
+            track->mixed_panning[1] = panning[1];
+            track->mixed_speakers[0] = speakers[0];
+            track->mixed_speakers[1] = speakers[1];
+            track->mixed_panning_valid = true;
+            mixed_bytes = br * mixer->spec.channels;
+            break;
+        }
+
+        case MIX_SPATIALIZATION_STEREO:
+            SDL_assert(track->output_spec.channels == 2);
+            MixForcedStereoFloat32Audio(mixbuf, src, br / (sizeof (float) * 2), mixer->spec.channels, track->spatialization_panning, gain);
+            mixed_bytes = (br / 2) * mixer->spec.channels;
+            break;
+
+        default:
+            SDL_assert(!"Unexpected spatialization mode");
+            break;
+    }
+    return mixed_bytes;
+}
+
+// Direct rendering: if a track's audio is float32 in memory, already at the mixer's rate and the track's output channels,
+//  and nothing needs to touch it on the way, MixTrack can mix it straight out of the precache, with the track's gain
+//  folded into the mix, instead of copying it through output_stream twice. Anything else (loop points, the end of
+//  the audio, fades, callbacks, pitch changes) goes through output_stream as usual, which picks up at track->position.
+// Returns a pointer to `frames` sample frames of the track's audio, or NULL if this track can't render directly right now.
+// this assumes LockTrack(track) was called before this.
+static const float *GetDirectRenderAudio(MIX_Mixer *mixer, MIX_Track *track, int frames)
+{
+    const MIX_Audio *audio = track->input_audio;
+    if ((track->state != MIX_STATE_PLAYING) || !IsDirectAudio(audio)) {
+        return NULL;
+    } else if ((audio->spec.freq != mixer->spec.freq) || (audio->spec.channels != track->output_spec.channels)) {
+        return NULL;  // needs conversion.
+    } else if (track->raw_callback || track->cooked_callback || (track->fade_direction != 0) || (track->silence_frames > 0)) {
+        return NULL;  // something needs to see or change the data.
+    } else if (track->decode_ahead && (track->decode_ahead->channels > 0)) {
+        return NULL;  // the ring is where this track's data comes from.
+    } else if (SDL_GetAudioStreamFrequencyRatio(track->output_stream) != 1.0f) {
+        return NULL;  // needs resampling.
+    } else if (SDL_GetAudioStreamAvailable(track->output_stream) > 0) {
+        return NULL;  // output_stream has to finish what it already has first.
+    }
+
+    const int framesize = SDL_AUDIO_FRAMESIZE(audio->spec);
+    Sint64 end = (Sint64) (audio->precachelen / framesize);
+    if ((track->max_frame >= 0) && (track->max_frame < end)) {
+        end = track->max_frame;
+    }
+    if (((Sint64) track->position) + frames > end) {
+        return NULL;  // let TrackGetCallback deal with looping, appended silence, stopping, etc.
+    }
+
+    return (const float *) (((const Uint8 *) audio->precache) + (track->position * framesize));
+}
+
+// Move the doppler shift output_stream resamples with toward what the spatializer last asked for. This moves
+//  part of the way each mix, instead of jumping, so a fast change doesn't click.
+// this is called from MixTrack, so the mixer is locked (by the device thread), which protects doppler_ratio.
+#define MIX_DOPPLER_SMOOTHING 0.5f
+#define MIX_DOPPLER_SNAP 0.0001f
+static void UpdateMixedDopplerRatio(MIX_Track *track)
+{
+    const float target = (track->spatialization_mode == MIX_SPATIALIZATION_3D) ? track->doppler_ratio : 1.0f;
+    if (track->mixed_doppler_ratio == target) {
+        return;  // the usual case: nothing to do, and nothing to lock.
+    }
+
+    LockTrack(track);
+    float ratio = track->mixed_doppler_ratio + ((target - track->mixed_doppler_ratio) * MIX_DOPPLER_SMOOTHING);
+    if (SDL_fabsf(target - ratio) < MIX_DOPPLER_SNAP) {
+        ratio = target;  // close enough; land on it exactly, so a track that stops moving can render directly again.
+    }
+    track->mixed_doppler_ratio = ratio;
+    SDL_SetAudioStreamFrequencyRatio(track->output_stream, SDL_clamp(track->frequency_ratio * ratio, 0.01f, 100.0f));
+    UnlockTrack(track);
+}
+
+// Feed a track's audio to whatever send buses it uses. This happens before positioning and panning, so every bus hears it from the front.
+// this is called from the audio device thread, or a render thread, with the mixer locked (by the device thread).
+static void MixTrackSends(MIX_Mixer *mixer, MIX_Track *track, MIX_SendBuffers *sends, const float *src, int br, float gain)
+{
+    for (int bus = 0; bus < MIX_MAX_SEND_BUSES; bus++) {
+        const float level = track->send_levels[bus];
+        if (level > 0.0f) {
+            MixUnspatializedTrackAudio(mixer, track, sends->buffer + (bus * (sends->amount / sizeof (float))), src, br, gain * level);
+            sends->used[bus] = true;
+        }
+    }
+}
+
+// Pull a track's next buffer of audio and mix it into `mixbuf`. Returns the number of bytes of `mixbuf` that were touched.
+// `getbuf` must be at least `amount` bytes; `amount` is how much mixer->spec audio we want.
+// `ambisonic` is where 3D tracks are encoded, or NULL if the mixer doesn't use an ambisonic bus.
+// `sends` is where tracks feed the send buses, or NULL if no track has used them.
+// this is called from the audio device thread, or a render thread, with the mixer locked (by the device thread).
+static int MixTrack(MIX_Mixer *mixer, MIX_Track *track, float *getbuf, float *mixbuf, MIX_AmbisonicBus *ambisonic, MIX_SendBuffers *sends, int amount)
+{
+    UpdateMixedDopplerRatio(track);
+
+    if (track->virtualized) {
+        AdvanceVirtualTrack(mixer, track, amount / SDL_AUDIO_FRAMESIZE(mixer->spec));
+        return 0;
+    }
+
+    const int frames = amount / SDL_AUDIO_FRAMESIZE(mixer->spec);
+    const int to_be_read = frames * SDL_AUDIO_FRAMESIZE(track->output_spec);
+
+    if (track->direct_render) {  // just a hint, it's checked for real with the track locked.
+        LockTrack(track);
+        const float *direct = GetDirectRenderAudio(mixer, track, frames);
+        if (direct) {
+            const Uint64 mix_start = SDL_GetTicksNS();
+            if (sends) {
+                MixTrackSends(mixer, track, sends, direct, to_be_read, mixer->gain * track->gain);
+            }
+            const int mixed_bytes = MixTrackAudio(mixer, track, mixbuf, ambisonic, getbuf, direct, to_be_read, mixer->gain * track->gain);
+            track->position += frames;
+            UnlockTrack(track);
+            AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
+            return mixed_bytes;
+        }
+        UnlockTrack(track);
+    }
+
+    int mixed_bytes = 0;
+    const int br = SDL_GetAudioStreamData(track->output_stream, getbuf, to_be_read);
+    if (br > 0) {
+        if (track->cooked_callback) {
+            const Uint64 callback_start = SDL_GetTicksNS();
+            track->cooked_callback(track->cooked_callback_userdata, track, &track->output_spec, getbuf, br / sizeof (float));
+            AddPendingStat(&mixer->pending_stats.app_callback_ns, SDL_GetTicksNS() - callback_start);
+        }
+
+        const Uint64 mix_start = SDL_GetTicksNS();
+        if (sends) {
+            MixTrackSends(mixer, track, sends, getbuf, br, mixer->gain);
+        }
+        mixed_bytes = MixTrackAudio(mixer, track, mixbuf, ambisonic, getbuf, getbuf, br, mixer->gain);
+        AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
+    }
+    return mixed_bytes;
+}
+
+static void RunRenderJobs(MIX_Mixer *mixer, MIX_RenderThread *rt)
+{
+    const int amount = mixer->render_amount;
+    int i;
+    while ((i = SDL_AddAtomicInt(&mixer->render_next_job, 1)) < mixer->num_render_jobs) {
+        MIX_RenderJob *job = &mixer->render_jobs[i];
+        MIX_AmbisonicBus *ambisonic = job->ambisonic.buffer ? &job->ambisonic : NULL;
+        MIX_SendBuffers *sends = job->sends.buffer ? &job->sends : NULL;
+        SDL_memset(job->mixbuf, '\0', amount);
+        job->mixed_bytes = 0;
+        if (ambisonic) {
+            SDL_memset(ambisonic->buffer, '\0', AmbisonicBusSize(mixer, amount));
+            ambisonic->used = false;
+        }
+        if (sends) {
+            SDL_memset(sends->buffer, '\0', SendBusSize(mixer, amount));
+            SDL_zeroa(sends->used);
+        }
+        for (int j = 0; j < job->num_tracks; j++) {
+            job->mixed_bytes = SDL_max(job->mixed_bytes, MixTrack(mixer, job->tracks[j], rt->getbuf, job->mixbuf, ambisonic, sends, amount));
+        }
+    }
+}
+
+static int SDLCALL RenderThread(void *data)
+{
+    MIX_RenderThread *rt = (MIX_RenderThread *) data;
+    MIX_Mixer *mixer = rt->mixer;
+    while (true) {
+        SDL_WaitSemaphore(mixer->render_start);
+        if (SDL_GetAtomicInt(&mixer->render_shutdown)) {
+            break;
+        }
+        RunRenderJobs(mixer, rt);
+        SDL_SignalSemaphore(mixer->render_done);
+    }
+    return 0;
+}
+
+// this assumes LockMixer(mixer) was called before this.
+static void StopRenderThreads(MIX_Mixer *mixer)
+{
+    SDL_SetAtomicInt(&mixer->render_shutdown, 1);
+    for (int i = 0; i < mixer->num_render_threads; i++) {
+        SDL_SignalSemaphore(mixer->render_start);
+    }
+    for (int i = 0; i <= mixer->num_render_threads; i++) {
+        MIX_RenderThread *rt = &mixer->render_threads[i];
+        if (rt->thread) {
+            SDL_WaitThread(rt->thread, NULL);
+        }
+        SDL_aligned_free(rt->getbuf);
+        SDL_zerop(rt);
+    }
+    mixer->num_render_threads = 0;
+    SDL_SetAtomicInt(&mixer->render_shutdown, 0);
+
+    SDL_DestroySemaphore(mixer->render_start);
+    mixer->render_start = NULL;
+    SDL_DestroySemaphore(mixer->render_done);
+    mixer->render_done = NULL;
+}
+
+// Split every group's tracks into jobs for this callback. Returns false if we're out of memory, so the caller can mix serially.
+// this assumes LockMixer(mixer) was called before this.
+static bool PrepareRenderJobs(MIX_Mixer *mixer, int amount)
+{
+    int total_tracks = 0;
+    int total_jobs = 0;
+    for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+        int group_tracks = 0;
+        for (MIX_Track *track = group->tracks; track; track = track->group_next) {
+            group_tracks++;
+        }
+        total_tracks += group_tracks;
+        total_jobs += (group_tracks + (MIX_RENDER_TRACKS_PER_JOB - 1)) / MIX_RENDER_TRACKS_PER_JOB;
+    }
+
+    // in real-time-safe mode, ReserveRealtimeBuffers should have made sure none of these need to grow.
+    if (total_tracks > mixer->render_tracks_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);
+        void *ptr = SDL_realloc(mixer->render_tracks, total_tracks * sizeof (MIX_Track *));
+        if (!ptr) {
+            return false;
+        }
+        mixer->render_tracks = (MIX_Track **) ptr;
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+        mixer->render_tracks_allocation = total_tracks;
+    }
+
+    if (total_jobs > mixer->render_jobs_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);
+        void *ptr = SDL_realloc(mixer->render_jobs, total_jobs * sizeof (MIX_RenderJob));
+        if (!ptr) {
+            return false;
+        }
+        mixer->render_jobs = (MIX_RenderJob *) ptr;
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+        mixer->render_jobs_allocation = total_jobs;
+    }
+
+    const size_t buffer_size = ((size_t) total_jobs) * amount;
+    if (buffer_size > mixer->render_buffer_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);
+        if (!GrowScratchBuffer(&mixer->render_buffer, &mixer->render_buffer_allocation, buffer_size)) {
+            return false;
+        }
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    const size_t ambisonic_size = AmbisonicBusSize(mixer, amount);
+    if ((((size_t) total_jobs) * ambisonic_size) > mixer->ambisonic_render_buffer_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);
+        if (!GrowScratchBuffer(&mixer->ambisonic_render_buffer, &mixer->ambisonic_render_buffer_allocation, ((size_t) total_jobs) * ambisonic_size)) {
+            return false;
+        }
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    const size_t send_size = SendBusSize(mixer, amount);
+    if ((((size_t) total_jobs) * send_size) > mixer->send_render_buffer_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);
+        if (!GrowScratchBuffer(&mixer->send_render_buffer, &mixer->send_render_buffer_allocation, ((size_t) total_jobs) * send_size)) {
+            return false;
+        }
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    for (int i = 0; i <= mixer->num_render_threads; i++) {
+        MIX_RenderThread *rt = &mixer->render_threads[i];
+        if ((size_t) amount > rt->getbuf_allocation) {
+            SDL_assert(mixer->realtime_frames == 0);
+            if (!GrowScratchBuffer(&rt->getbuf, &rt->getbuf_allocation, amount)) {
+                return false;
+            }
+            AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+        }
+    }
+
+    MIX_Track **tracks = mixer->render_tracks;
+    MIX_RenderJob *job = mixer->render_jobs;
+    float *mixbuf = mixer->render_buffer;
+    float *ambisonic_buffer = mixer->ambisonic_render_buffer;
+    float *send_buffer = mixer->send_render_buffer;
+    for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+        int num_tracks = 0;
+        for (MIX_Track *track = group->tracks; track; track = track->group_next) {
+            if (num_tracks == 0) {
+                job->group = group;
+                job->tracks = tracks;
+                job->mixbuf = mixbuf;
+                job->mixed_bytes = 0;
+                mixbuf += amount / sizeof (float);
+                job->ambisonic.buffer = ambisonic_size ? ambisonic_buffer : NULL;
+                job->ambisonic.frames = amount / SDL_AUDIO_FRAMESIZE(mixer->spec);
+                job->ambisonic.used = false;
+                ambisonic_buffer += ambisonic_size / sizeof (float);
+                job->sends.buffer = send_size ? send_buffer : NULL;
+                job->sends.amount = amount;
+                send_buffer += send_size / sizeof (float);
+            }
+            *(tracks++) = track;
+            if (++num_tracks == MIX_RENDER_TRACKS_PER_JOB) {
+                job->num_tracks = num_tracks;
+                job++;
+                num_tracks = 0;
+            }
+        }
+        if (num_tracks > 0) {
+            job->num_tracks = num_tracks;
+            job++;
+        }
+    }
+
+    SDL_assert((job - mixer->render_jobs) == total_jobs);
+    mixer->num_render_jobs = total_jobs;
+    mixer->render_amount = amount;
+    return true;
+}
+
+// Fold everything that happened during this callback into the mixer's stats, and publish them for MIX_GetMixerStats.
+// this is only called from MixerCallback, so the mixer is locked and nothing else writes to mixer->stats.
+static void UpdateMixerStats(MIX_Mixer *mixer, Uint64 start_ns, int buffer_bytes)
+{
+    MIX_MixerStats *stats = &mixer->stats;
+    MIX_PendingStats *pending = &mixer->pending_stats;
+    const Uint64 elapsed_ns = SDL_GetTicksNS() - start_ns;
+    const Uint64 buffer_ns = (((Uint64) (buffer_bytes / SDL_AUDIO_FRAMESIZE(mixer->spec))) * SDL_NS_PER_SECOND) / mixer->spec.freq;
+
+    stats->callback_min_ns = (stats->callbacks == 0) ? elapsed_ns : SDL_min(stats->callback_min_ns, elapsed_ns);
+    stats->callback_max_ns = SDL_max(stats->callback_max_ns, elapsed_ns);
+    stats->callbacks++;
+    mixer->stats_total_callback_ns += elapsed_ns;
+    stats->callback_avg_ns = mixer->stats_total_callback_ns / stats->callbacks;
+    if (elapsed_ns > buffer_ns) {
+        stats->missed_deadlines++;
+    }
+
+    stats->decode_ns += (Uint32) SDL_SetAtomicInt(&pending->decode_ns, 0);
+    stats->mix_ns += (Uint32) SDL_SetAtomicInt(&pending->mix_ns, 0);
+    stats->app_callback_ns += (Uint32) SDL_SetAtomicInt(&pending->app_callback_ns, 0);
+    stats->buffer_reallocations += (Uint32) SDL_SetAtomicInt(&pending->buffer_reallocations, 0);
+    for (int i = 0; i < MIX_MAX_STATS_DECODERS; i++) {
+        stats->frames_decoded[i] += (Uint32) SDL_SetAtomicInt(&pending->frames_decoded[i], 0);
+    }
+
+    stats->playing_tracks = stats->paused_tracks = stats->stopped_tracks = stats->fire_and_forget_pool = stats->virtual_tracks = stats->culled_tracks = 0;
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        switch (track->state) {
+            case MIX_STATE_PLAYING:
+                stats->playing_tracks++;
+                if (track->virtualized) {
+                    stats->virtual_tracks++;
+                    if (track->culled) {
+                        stats->culled_tracks++;
+                    }
+                }
+                break;
+            case MIX_STATE_PAUSED: stats->paused_tracks++; break;
+            default: stats->stopped_tracks++; break;
+        }
+    }
+
+    ReclaimFireAndForgetTracks(mixer);
+    for (MIX_Track *track = mixer->fire_and_forget_pool; track; track = track->fire_and_forget_next) {
+        stats->fire_and_forget_pool++;
+    }
+
+    // this is a seqlock: the sequence is odd while we're writing, so readers know to try again.
+    const Uint32 sequence = SDL_GetAtomicU32(&mixer->stats_sequence);
+    SDL_SetAtomicU32(&mixer->stats_sequence, sequence + 1);
+    SDL_MemoryBarrierRelease();
+    SDL_copyp(&mixer->published_stats, stats);
+    SDL_MemoryBarrierRelease();
+    SDL_SetAtomicU32(&mixer->stats_sequence, sequence + 2);
+}
+
+// Track changes that can either happen right away, or be recorded in a batch and applied by MixerCallback later.
+
+static bool SetTrackGain(MIX_Track *track, float gain)
+{
+    // don't have to LockTrack, as SDL_SetAudioStreamGain will do that.
+    //LockTrack(track);
+    const bool retval = SDL_SetAudioStreamGain(track->output_stream, gain);
+    //UnlockTrack(track);
+    if (retval) {
+        track->gain = gain;
+    }
+    return retval;
+}
+
+static bool SetTrackFrequencyRatio(MIX_Track *track, float ratio)
+{
+    LockTrack(track);
+    track->frequency_ratio = ratio;
+    const bool retval = SDL_SetAudioStreamFrequencyRatio(track->output_stream, SDL_clamp(ratio * track->mixed_doppler_ratio, 0.01f, 100.0f));
+    UnlockTrack(track);
+    return retval;
+}
+
+static void SetTrackStereo(MIX_Track *track, const MIX_StereoGains *gains)
+{
+    LockTrack(track);
+
+    const bool wants_stereo = (gains != NULL);
+    const MIX_SpatializationMode new_mode = wants_stereo ? MIX_SPATIALIZATION_STEREO : MIX_SPATIALIZATION_NONE;
+    if (track->spatialization_mode != new_mode) {
+        track->spatialization_mode = new_mode;
+        SetTrackOutputStreamFormat(track, NULL);   // change output format to stereo (or back to normal) if necessary.
+    }
+
+    track->position3d[0] = track->position3d[1] = track->position3d[2] = 0.0f;
+    track->attenuation = 1.0f;
+
+    if (wants_stereo) {
+        const float left = SDL_max(0.0f, gains->left);
+        const float right = SDL_max(0.0f, gains->right);
+        track->attenuation = SDL_max(left, right);
+        if (track->mixer->spec.channels == 1) {  // mono output
+            track->spatialization_speakers[0] = track->spatialization_speakers[1] = 0;
+            track->spatialization_panning[0] = left * 0.5f;
+            track->spatialization_panning[1] = right * 0.5f;
+        } else {
+            track->spatialization_speakers[0] = 0;
+            track->spatialization_speakers[1] = 1;
+            track->spatialization_panning[0] = left;
+            track->spatialization_panning[1] = right;
+        }
+    }
+
+    UnlockTrack(track);
+}
+
+// Spatialize `track` at its current position3d and velocity3d right away. This bumps position3d_serial, so anything
+//  waiting in spatial_block for it is obsolete.
+// this assumes LockTrack(track) was called before this. It doesn't need the mixer locked.
+static void SpatializeTrack(MIX_Mixer *mixer, MIX_Track *track)
+{
+    const float *p = track->position3d;
+    const float *v = track->velocity3d;
+    float panning[2];
+    int speakers[2];
+    float radians, attenuation, doppler_ratio;
+    Uint32 sequence;
+
+    do {
+        sequence = BeginSpatialRead(mixer);
+        MIX_Spatialize(&mixer->vbap2d, &mixer->listener3d, p, panning, speakers, &radians);
+        attenuation = MIX_DistanceAttenuation(&mixer->listener3d, p);
+        MIX_CalculateDopplerRatios(&mixer->listener3d, mixer->speed_of_sound, &p[0], &p[1], &p[2], &v[0], &v[1], &v[2], &doppler_ratio, 1);
+    } while (!EndSpatialRead(mixer, sequence));
+
+    // if the listener or the speakers change after this, the next mix (or the device format change) respatializes this track again.
+    track->spatialization_panning[0] = panning[0];
+    track->spatialization_panning[1] = panning[1];
+    track->spatialization_speakers[0] = speakers[0];
+    track->spatialization_speakers[1] = speakers[1];
+    track->spatialization_radians = radians;
+    track->attenuation = attenuation;
+    track->doppler_ratio = doppler_ratio;
+    track->position3d_serial++;
+}
+
+static void SetTrack3DPosition(MIX_Track *track, const MIX_Point3D *position)
+{
+    MIX_Mixer *mixer = track->mixer;
+
+    LockTrack(track);
+
+    const bool wants_spatialization = (position != NULL);
+    const MIX_SpatializationMode new_mode = wants_spatialization ? MIX_SPATIALIZATION_3D : MIX_SPATIALIZATION_NONE;
+    const bool toggling = (track->spatialization_mode != new_mode);
+    if (toggling) {
+        track->spatialization_mode = new_mode;
+        SetTrackOutputStreamFormat(track, NULL);   // change output format to stereo (or back to normal) if necessary.
+    }
+
+    if (!wants_spatialization) {
+        track->position3d[0] = track->position3d[1] = track->position3d[2] = 0.0f;
+        track->attenuation = 1.0f;
+        track->doppler_ratio = 1.0f;
+        track->position3d_serial++;  // anything waiting in spatial_block is obsolete now.
+    } else {
+        float *tposition3d = track->position3d;
+        if (toggling || ((tposition3d[0] != position->x) || (tposition3d[2] != position->y) || (tposition3d[2] != position->z))) {
+            tposition3d[0] = position->x;
+            tposition3d[1] = position->y;
+            tposition3d[2] = position->z;
+            SpatializeTrack(mixer, track);
+        }
+    }
+
+    UnlockTrack(track);
+}
+
+// Find where `track`'s pending position is in the mixer's spatial_block, or -1 if it doesn't have one there.
+// this assumes LockMixer(mixer) and LockTrack(track) were called before this.
+static int FindSpatialBlockSlot(const MIX_SpatialBlock *block, const MIX_Track *track)
+{
+    const int slot = track->spatial_block_slot;
+    if ((slot >= 0) && (slot < block->count) && (block->tracks[slot] == track) && (block->serials[slot] == track->position3d_serial)) {
+        return slot;
+    }
+    return -1;
+}
+
+// Store `track`'s current position and velocity in `slot`, to be spatialized at the start of the next mix.
+// this assumes LockMixer(mixer) and LockTrack(track) were called before this.
+static void StoreSpatialBlockSlot(MIX_SpatialBlock *block, int slot, MIX_Track *track)
+{
+    block->tracks[slot] = track;
+    block->serials[slot] = ++track->position3d_serial;
+    block->x[slot] = track->position3d[0];
+    block->y[slot] = track->position3d[1];
+    block->z[slot] = track->position3d[2];
+    block->vx[slot] = track->velocity3d[0];
+    block->vy[slot] = track->velocity3d[1];
+    block->vz[slot] = track->velocity3d[2];
+}
+
+static void SetTrack3DVelocity(MIX_Track *track, const MIX_Point3D *velocity)
+{
+    LockTrack(track);
+
+    track->velocity3d[0] = velocity ? velocity->x : 0.0f;
+    track->velocity3d[1] = velocity ? velocity->y : 0.0f;
+    track->velocity3d[2] = velocity ? velocity->z : 0.0f;
+
+    // position3d already has any position waiting in spatial_block, so this makes that entry obsolete, too.
+    if (track->spatialization_mode == MIX_SPATIALIZATION_3D) {
+        SpatializeTrack(track->mixer, track);
+    }
+
+    UnlockTrack(track);
+}
+
+static void SetTrackOcclusion(MIX_Track *track, float occlusion, float obstruction)
+{
+    MIX_Mixer *mixer = track->mixer;
+
+    LockTrack(track);
+    track->occlusion = SDL_clamp(occlusion, 0.0f, 1.0f);
+    track->obstruction = SDL_clamp(obstruction, 0.0f, 1.0f);
+    Uint32 sequence;
+    do {
+        sequence = BeginSpatialRead(mixer);  // for the mixer's sample rate.
+        UpdateTrackLowpass(mixer, track);
+    } while (!EndSpatialRead(mixer, sequence));
+    UnlockTrack(track);
+}
+
+static void SetTrackSend(MIX_Track *track, int bus, float level)
+{
+    LockTrack(track);
+    track->send_levels[bus] = level;
+    UnlockTrack(track);
+}
+
+// this doesn't need the decode-ahead lock, so MixerCallback can apply it, and it's safe with the mixer locked.
+static void StopTrack(MIX_Track *track, Sint64 fadeOut)
+{
+    LockTrack(track);
+    if (track->state != MIX_STATE_STOPPED) {
+        if (fadeOut <= 0) {  // stop immediately.
+            MIX_DecodeAhead *da = track->decode_ahead;
+            if (da && (da->channels > 0)) {
+                SDL_SetAtomicInt(&da->active, 0);  // the worker stops at the end of its chunk. MIX_PlayTrack resets the ring and starts it up again.
+            } else if (track->internal_stream) {
+                SDL_ClearAudioStream(track->internal_stream);  // make sure we don't leave old data hanging around.
+            }
+            TrackStopped(track);
+        } else {
+            track->total_fade_frames = fadeOut;
+            track->fade_frames = fadeOut;
+            track->fade_direction = -1;
+            track->fade_curve = track->fade_out_curve;
+        }
+    }
+    UnlockTrack(track);
+}
+
+static void PauseTrack(MIX_Track *track)
+{
+    LockTrack(track);
+    if (track->state == MIX_STATE_PLAYING) {
+        track->state = MIX_STATE_PAUSED;
+    }
+    UnlockTrack(track);
+}
+
+static void ResumeTrack(MIX_Track *track)
+{
+    LockTrack(track);
+    if (track->state == MIX_STATE_PAUSED) {
+        track->state = MIX_STATE_PLAYING;
+    }
+    UnlockTrack(track);
+}
+
+static void *BatchOwner(SDL_ThreadID thread)
+{
+    return (void *) (uintptr_t) thread;  // might be truncated, so a match still has to be confirmed against batch_thread.
+}
+
+// If `mixer` has a batch open on this thread, sets *cmds to `count` new commands to fill in, with mixer->batch_lock
+//  held; call EndTrackCommand when done with them. Otherwise, sets *cmds to NULL, and the caller should make the change
+//  right away. Returns false if the batch couldn't grow; the caller should fail then, since making the change right
+//  away would break the promise that everything in a batch lands at once.
+static bool QueueTrackCommands(MIX_Mixer *mixer, int count, MIX_Command **cmds)
+{
+    *cmds = NULL;
+
+    const SDL_ThreadID thread = SDL_GetCurrentThreadID();
+    if (SDL_GetAtomicPointer(&mixer->batch_owner) != BatchOwner(thread)) {
+        return true;  // no batch open on this thread, which is almost always the case; don't touch batch_lock at all.
+    }
+
+    SDL_LockMutex(mixer->batch_lock);
+    MIX_CommandBatch *batch = mixer->batch;
+    if ((mixer->batch_depth == 0) || (mixer->batch_thread != thread)) {
+        SDL_UnlockMutex(mixer->batch_lock);
+        return true;
+    }
+
+    SDL_assert(batch != NULL);
+    if ((batch->num_commands + count) > batch->allocation) {
+        const int allocation = SDL_max(SDL_max(batch->allocation * 2, 64), batch->num_commands + count);
+        void *ptr = SDL_realloc(batch->commands, allocation * sizeof (MIX_Command));
+        if (!ptr) {
+            SDL_UnlockMutex(mixer->batch_lock);
+            return false;
+        }
+        batch->commands = (MIX_Command *) ptr;
+        batch->allocation = allocation;
+    }
+
+    *cmds = &batch->commands[batch->num_commands];
+    batch->num_commands += count;
+    SDL_memset(*cmds, '\0', count * sizeof (MIX_Command));
+    return true;
+}
+
+static bool QueueTrackCommand(MIX_Track *track, MIX_CommandType type, MIX_Command **cmd)
+{
+    if (!QueueTrackCommands(track->mixer, 1, cmd)) {
+        return false;
+    } else if (*cmd) {
+        (*cmd)->type = type;
+        (*cmd)->track = track;
+    }
+    return true;
+}
+
+static void EndTrackCommand(MIX_Mixer *mixer)
+{
+    SDL_UnlockMutex(mixer->batch_lock);
+}
+
+// this assumes LockMixer(mixer) was called before this, so MixerCallback can't run (it only runs with the mixer locked).
+static void ApplyCommand(const MIX_Command *cmd)
+{
+    MIX_Track *track = cmd->track;
+    if (!track) {
+        return;  // track was destroyed after this was recorded.
+    }
+
+    switch (cmd->type) {
+        case MIX_COMMAND_GAIN:
+            SetTrackGain(track, cmd->data.gain);
+            break;
+
+        case MIX_COMMAND_FREQUENCY_RATIO:
+            SetTrackFrequencyRatio(track, cmd->data.ratio);
+            break;
+
+        case MIX_COMMAND_STEREO:
+            SetTrackStereo(track, cmd->clear ? NULL : &cmd->data.stereo);
+            break;
+
+        case MIX_COMMAND_3D_POSITION:
+            SetTrack3DPosition(track, cmd->clear ? NULL : &cmd->data.position);
+            break;
+
+        case MIX_COMMAND_3D_VELOCITY:
+            SetTrack3DVelocity(track, cmd->clear ? NULL : &cmd->data.position);
+            break;
+
+        case MIX_COMMAND_OCCLUSION:
+            SetTrackOcclusion(track, cmd->data.occlusion.occlusion, cmd->data.occlusion.obstruction);
+            break;
+
+        case MIX_COMMAND_SEND:
+            SetTrackSend(track, cmd->data.send.bus, cmd->data.send.level);
+            break;
+
+        case MIX_COMMAND_PLAY:
+            LockTrack(track);
+            if ((track->state != MIX_STATE_PLAYING) && (track->input_audio || track->input_stream)) {
+                track->state = MIX_STATE_PLAYING;
+            }
+            UnlockTrack(track);
+            break;
+
+        case MIX_COMMAND_STOP:
+            StopTrack(track, cmd->data.fade_out_frames);
+            break;
+
+        case MIX_COMMAND_PAUSE:
+            PauseTrack(track);
+            break;
+
+        case MIX_COMMAND_RESUME:
+            ResumeTrack(track);
+            break;
+    }
+}
+
+static void ForgetTrackCommands(MIX_CommandBatch *batch, MIX_Track *track)
+{
+    for (int i = 0; i < batch->num_commands; i++) {
+        if (batch->commands[i].track == track) {
+            batch->commands[i].track = NULL;
+        }
+    }
+}
+
+static void FreeCommandBatches(MIX_CommandBatch *batch)
+{
+    while (batch) {
+        MIX_CommandBatch *next = batch->next;
+        SDL_free(batch->commands);
+        SDL_free(batch);
+        batch = next;
+    }
+}
+
+// Apply every batch committed since the last time, oldest first, and hand them back to the app's thread for reuse.
+// this is only called from MixerCallback, so the mixer is locked.
+static void ApplyCommittedBatches(MIX_Mixer *mixer)
+{
+    MIX_CommandBatch *batch = (MIX_CommandBatch *) SDL_SetAtomicPointer((void **) &mixer->committed_batches, NULL);
+
+    // the stack is newest first, so reverse it.
+    MIX_CommandBatch *oldest = NULL;
+    while (batch) {
+        MIX_CommandBatch *next = batch->next;
+        batch->next = oldest;
+        oldest = batch;
+        batch = next;
+    }
+
+    while (oldest) {
+        MIX_CommandBatch *next = oldest->next;
+        const MIX_Command *cmd = oldest->commands;
+        for (int i = 0; i < oldest->num_commands; i++, cmd++) {
+            ApplyCommand(cmd);
+        }
+
+        MIX_CommandBatch *head;
+        do {
+            head = (MIX_CommandBatch *) SDL_GetAtomicPointer((void **) &mixer->spent_batches);
+            oldest->next = head;
+        } while (!SDL_CompareAndSwapAtomicPointer((void **) &mixer->spent_batches, head, oldest));
+
+        oldest = next;
+    }
+}
+
+static bool GrowSpatialArray(void **array, size_t element_size, int allocation)
+{
+    void *ptr = SDL_realloc(*array, element_size * allocation);
+    if (!ptr) {
+        return false;
+    }
+    *array = ptr;
+    return true;
+}
+
+// this assumes LockMixer(mixer) was called before this; it's never called from the audio thread.
+static bool GrowSpatialBlock(MIX_SpatialBlock *block, int needed)
+{
+    if (needed <= block->allocation) {
+        return true;
+    }
+
+    // if one of these fails, the others are just bigger than they need to be, which is fine.
+    const int allocation = SDL_max(needed, block->allocation * 2);
+    if (!GrowSpatialArray((void **) &block->tracks, sizeof (*block->tracks), allocation) ||
+        !GrowSpatialArray((void **) &block->serials, sizeof (*block->serials), allocation) ||
+        !GrowSpatialArray((void **) &block->x, sizeof (*block->x), allocation) ||
+        !GrowSpatialArray((void **) &block->y, sizeof (*block->y), allocation) ||
+        !GrowSpatialArray((void **) &block->z, sizeof (*block->z), allocation) ||
+        !GrowSpatialArray((void **) &block->vx, sizeof (*block->vx), allocation) ||
+        !GrowSpatialArray((void **) &block->vy, sizeof (*block->vy), allocation) ||
+        !GrowSpatialArray((void **) &block->vz, sizeof (*block->vz), allocation) ||
+        !GrowSpatialArray((void **) &block->gains, sizeof (*block->gains), allocation) ||
+        !GrowSpatialArray((void **) &block->radians, sizeof (*block->radians), allocation) ||
+        !GrowSpatialArray((void **) &block->ratios, sizeof (*block->ratios), allocation)) {
+        return false;
+    }
+    block->allocation = allocation;
+    return true;
+}
+
+static void FreeSpatialBlock(MIX_SpatialBlock *block)
+{
+    SDL_free(block->tracks);
+    SDL_free(block->serials);
+    SDL_free(block->x);
+    SDL_free(block->y);
+    SDL_free(block->z);
+    SDL_free(block->vx);
+    SDL_free(block->vy);
+    SDL_free(block->vz);
+    SDL_free(block->gains);
+    SDL_free(block->radians);
+    SDL_free(block->ratios);
+    SDL_zerop(block);
+}
+
+// Spatialize `count` positions (and velocities, for doppler) together, and hand the results to their tracks, unless a track got a newer position in the meantime.
+// this is only called from MixerCallback, so the mixer is locked.
+static void SpatializeTracks(MIX_Mixer *mixer, MIX_Track **tracks, const Uint32 *serials, const float *x, const float *y, const float *z, const float *vx, const float *vy, const float *vz, float *gains, float *radians, float *ratios, int count)
+{
+    MIX_CalculateDistanceAttenuationsAndAngles(&mixer->listener3d, x, y, z, gains, radians, count);
+    MIX_CalculateDopplerRatios(&mixer->listener3d, mixer->speed_of_sound, x, y, z, vx, vy, vz, ratios, count);
+
+    for (int i = 0; i < count; i++) {
+        MIX_Track *track = tracks[i];
+        if (!track) {
+            continue;  // destroyed since this was stored.
+        }
+        LockTrack(track);
+        if ((track->position3d_serial == serials[i]) && (track->spatialization_mode == MIX_SPATIALIZATION_3D)) {
+            MIX_SpatializeAngle(&mixer->vbap2d, gains[i], radians[i], track->spatialization_panning, track->spatialization_speakers);
+            track->spatialization_radians = radians[i];
+            track->attenuation = gains[i];
+            track->doppler_ratio = ratios[i];
+        }
+        UnlockTrack(track);
+    }
+}
+
+// The listener moved, so every 3D track needs new panning. This goes through them a chunk at a time, so nothing
+//  has to be allocated in the audio thread.
+// this is only called from MixerCallback, so the mixer is locked.
+#define MIX_RESPATIALIZE_CHUNK_TRACKS 64
+static void RespatializeAllTracks(MIX_Mixer *mixer)
+{
+    MIX_Track *tracks[MIX_RESPATIALIZE_CHUNK_TRACKS];
+    Uint32 serials[MIX_RESPATIALIZE_CHUNK_TRACKS];
+    float x[MIX_RESPATIALIZE_CHUNK_TRACKS], y[MIX_RESPATIALIZE_CHUNK_TRACKS], z[MIX_RESPATIALIZE_CHUNK_TRACKS];
+    float vx[MIX_RESPATIALIZE_CHUNK_TRACKS], vy[MIX_RESPATIALIZE_CHUNK_TRACKS], vz[MIX_RESPATIALIZE_CHUNK_TRACKS];
+    float gains[MIX_RESPATIALIZE_CHUNK_TRACKS], radians[MIX_RESPATIALIZE_CHUNK_TRACKS], ratios[MIX_RESPATIALIZE_CHUNK_TRACKS];
+    int count = 0;
+
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        LockTrack(track);
+        if (track->spatialization_mode == MIX_SPATIALIZATION_3D) {
+            tracks[count] = track;
+            serials[count] = track->position3d_serial;
+            x[count] = track->position3d[0];
+            y[count] = track->position3d[1];
+            z[count] = track->position3d[2];
+            vx[count] = track->velocity3d[0];
+            vy[count] = track->velocity3d[1];
+            vz[count] = track->velocity3d[2];
+            count++;
+        }
+        UnlockTrack(track);
+
+        if (count == MIX_RESPATIALIZE_CHUNK_TRACKS) {
+            SpatializeTracks(mixer, tracks, serials, x, y, z, vx, vy, vz, gains, radians, ratios, count);
+            count = 0;
+        }
+    }
+
+    if (count > 0) {
+        SpatializeTracks(mixer, tracks, serials, x, y, z, vx, vy, vz, gains, radians, ratios, count);
+    }
+}
+
+// Spatialize everything MIX_SetTracks3DPositions stored since the last mix, all at once.
+// this is only called from MixerCallback, so the mixer is locked.
+static void ApplySpatialBlock(MIX_Mixer *mixer)
+{
+    MIX_SpatialBlock *block = &mixer->spatial_block;
+
+    if (mixer->listener3d_changed) {
+        // every 3D track's position3d is already current, including anything waiting in the block, so this covers it all.
+        mixer->listener3d_changed = false;
+        block->count = 0;
+        RespatializeAllTracks(mixer);
+    } else if (block->count > 0) {
+        SpatializeTracks(mixer, block->tracks, block->serials, block->x, block->y, block->z, block->vx, block->vy, block->vz, block->gains, block->radians, block->ratios, block->count);
+        block->count = 0;
+    }
+}
+
+// Decode a group's ambisonic bus into `mixbuf`: through HRTF-rendered virtual speakers if binaural output is
+//  available, otherwise straight to the output speakers. `getbuf` must hold at least bus->frames floats.
+static void DecodeAmbisonicBus(MIX_Mixer *mixer, MIX_Group *group, const MIX_AmbisonicBus *bus, float *getbuf, float *mixbuf)
+{
+    const int channels = (mixer->ambisonic_order * 2) + 1;
+
+    if (BinauralAvailable(mixer)) {
+        int speaker;
+        for (speaker = 0; speaker < mixer->ambisonic_virtual_speakers; speaker++) {
+            if (!group->ambisonic_binaural[speaker]) {
+                break;  // CreateGroupAmbisonicBinaural ran out of memory; decode to speakers instead. We don't allocate here.
+            }
+        }
+
+        if (speaker == mixer->ambisonic_virtual_speakers) {
+            for (speaker = 0; speaker < mixer->ambisonic_virtual_speakers; speaker++) {
+                const float *row = &mixer->ambisonic_virtual_decoder[speaker * MIX_AMBISONIC_MAX_CHANNELS];
+                SDL_memset(getbuf, '\0', bus->frames * sizeof (float));
+                for (int i = 0; i < channels; i++) {
+                    MixRampFloat32Audio(getbuf, bus->buffer + (i * bus->frames), bus->frames, row[i], 0.0f);
+                }
+                MIX_RenderBinaural(mixer->hrtf, group->ambisonic_binaural[speaker], getbuf, bus->frames, mixer->ambisonic_virtual_radians[speaker], 1.0f, mixbuf);
+            }
+            return;
+        }
+    }
+
+    DecodeAmbisonicFloat32Audio(mixbuf, bus->buffer, bus->frames, channels, mixer->spec.channels, mixer->ambisonic_decoder);
+}
+
+// Group effects (see MIX_GroupEffects). EQ changes glide part of the way to their target each mix, the group gain
+//  ramps across each mix, and the compressor works out a new gain every MIX_DYNAMICS_CONTROL_FRAMES sample frames
+//  and ramps between them, so nothing the app changes makes a click.
+#define MIX_EFFECT_SMOOTHING 0.5f
+#define MIX_DYNAMICS_CONTROL_FRAMES 16
+
+static float DecibelsToGain(const float db)
+{
+    return SDL_powf(10.0f, db * 0.05f);
+}
+
+// Take the app's latest settings, if there are new ones and the app isn't in the middle of changing them.
+// this is called from the audio device thread with the mixer locked; it never waits on the app.
+static void SyncGroupEffects(MIX_GroupEffects *fx)
+{
+    const int serial = SDL_GetAtomicInt(&fx->serial);
+    if ((serial == fx->applied_serial) || (serial & 1)) {
+        return;  // nothing new, or it's being changed right now; try again next mix.
+    }
+
+    MIX_GroupEffectParams params;
+    SDL_copyp(&params, &fx->pending);
+    SDL_MemoryBarrierAcquire();
+    if (SDL_GetAtomicInt(&fx->serial) == serial) {  // if the app changed it while we were copying, try again next mix.
+        SDL_copyp(&fx->target, &params);
+        fx->applied_serial = serial;
+    }
+}
+
+static bool IsEQGainBand(const MIX_EQBandType type)
+{
+    return (type == MIX_EQ_PEAKING) || (type == MIX_EQ_LOWSHELF) || (type == MIX_EQ_HIGHSHELF);
+}
+
+// Biquad coefficients for an EQ band, from the usual "Audio EQ Cookbook" formulas, normalized so a0 is 1.
+static void CalculateEQCoefficients(const MIX_EQBand *band, const int freq, float *coefficients)
+{
+    const float frequency = SDL_clamp(band->frequency, 10.0f, ((float) freq) * 0.49f);
+    const float w0 = (2.0f * SDL_PI_F * frequency) / ((float) freq);
+    const float cosw = SDL_cosf(w0);
+    const float alpha = SDL_sinf(w0) / (2.0f * SDL_max(band->q, 0.05f));
+    const float A = SDL_powf(10.0f, band->gain_db / 40.0f);
+    const float sqrtA2alpha = 2.0f * SDL_sqrtf(A) * alpha;
+    float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
+
+    switch (band->type) {
+        case MIX_EQ_PEAKING:
+            b0 = 1.0f + (alpha * A);
+            b1 = -2.0f * cosw;
+            b2 = 1.0f - (alpha * A);
+            a0 = 1.0f + (alpha / A);
+            a1 = -2.0f * cosw;
+            a2 = 1.0f - (alpha / A);
+            break;
+
+        case MIX_EQ_LOWSHELF:
+            b0 = A * ((A + 1.0f) - ((A - 1.0f) * cosw) + sqrtA2alpha);
+            b1 = 2.0f * A * ((A - 1.0f) - ((A + 1.0f) * cosw));
+            b2 = A * ((A + 1.0f) - ((A - 1.0f) * cosw) - sqrtA2alpha);
+            a0 = (A + 1.0f) + ((A - 1.0f) * cosw) + sqrtA2alpha;
+            a1 = -2.0f * ((A - 1.0f) + ((A + 1.0f) * cosw));
+            a2 = (A + 1.0f) + ((A - 1.0f) * cosw) - sqrtA2alpha;
+            break;
+
+        case MIX_EQ_HIGHSHELF:
+            b0 = A * ((A + 1.0f) + ((A - 1.0f) * cosw) + sqrtA2alpha);
+            b1 = -2.0f * A * ((A - 1.0f) + ((A + 1.0f) * cosw));
+            b2 = A * ((A + 1.0f) + ((A - 1.0f) * cosw) - sqrtA2alpha);
+            a0 = (A + 1.0f) - ((A - 1.0f) * cosw) + sqrtA2alpha;
+            a1 = 2.0f * ((A - 1.0f) - ((A + 1.0f) * cosw));
+            a2 = (A + 1.0f) - ((A - 1.0f) * cosw) - sqrtA2alpha;
+            break;
+
+        case MIX_EQ_LOWPASS:
+            b0 = (1.0f - cosw) * 0.5f;
+            b1 = 1.0f - cosw;
+            b2 = (1.0f - cosw) * 0.5f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw;
+            a2 = 1.0f - alpha;
+            break;
+
+        case MIX_EQ_HIGHPASS:
+            b0 = (1.0f + cosw) * 0.5f;
+            b1 = -(1.0f + cosw);
+            b2 = (1.0f + cosw) * 0.5f;
+            a0 = 1.0f + alpha;
+            a1 = -2.0f * cosw;
+            a2 = 1.0f - alpha;
+            break;
+
+        default:
+            break;  // passthrough.
+    }
+
+    coefficients[0] = b0 / a0;
+    coefficients[1] = b1 / a0;
+    coefficients[2] = b2 / a0;
+    coefficients[3] = a1 / a0;
+    coefficients[4] = a2 / a0;
+}
+
+// Move each EQ band toward what the app asked for, and recalculate the filters if anything changed.
+static void UpdateGroupEQ(MIX_GroupEffects *fx, const int freq)
+{
+    if (fx->freq != freq) {
+        fx->freq = freq;
+        fx->eq_dirty = true;
+    }
+
+    for (int band = 0; band < MIX_MAX_EQ_BANDS; band++) {
+        MIX_EQBand *current = &fx->eq[band];
+        const MIX_EQBand *target = &fx->target.eq[band];
+        MIX_EQBand goal;
+        SDL_copyp(&goal, target);
+
+        if (current->type != target->type) {
+            if (IsEQGainBand(current->type) && (target->type == MIX_EQ_NONE)) {
+                goal = *current;   // fade a boost or cut out before turning the band off.
+                goal.gain_db = 0.0f;
+            } else {
+                const bool fade_in = IsEQGainBand(target->type) && (current->type == MIX_EQ_NONE);
+                *current = *target;  // other shape changes can't glide; just start over with the new one.
+                if (fade_in) {
+                    current->gain_db = 0.0f;
+                }
+                fx->eq_dirty = true;
+            }
+        }
+
+        if (current->type == MIX_EQ_NONE) {
+            continue;
+        } else if ((current->frequency == goal.frequency) && (current->gain_db == goal.gain_db) && (current->q == goal.q)) {
+            if ((target->type != current->type) && (current->gain_db == 0.0f)) {
+                current->type = MIX_EQ_NONE;  // faded out, now it can turn off.
+                fx->eq_dirty = true;
+            }
+            continue;
+        }
+
+        // frequency glides in octaves, the others linearly. Close enough lands exactly, so this eventually stops recalculating.
+        current->frequency *= SDL_powf(goal.frequency / current->frequency, MIX_EFFECT_SMOOTHING);
+        current->gain_db += (goal.gain_db - current->gain_db) * MIX_EFFECT_SMOOTHING;
+        current->q += (goal.q - current->q) * MIX_EFFECT_SMOOTHING;
+        if (SDL_fabsf(goal.frequency - current->frequency) < (goal.frequency * 0.001f)) {
+            current->frequency = goal.frequency;
+        }
+        if (SDL_fabsf(goal.gain_db - current->gain_db) < 0.01f) {
+            current->gain_db = goal.gain_db;
+        }
+        if (SDL_fabsf(goal.q - current->q) < 0.001f) {
+            current->q = goal.q;
+        }
+        fx->eq_dirty = true;
+    }
+
+    if (!fx->eq_dirty) {
+        return;
+    }
+    fx->eq_dirty = false;
+
+    // rebuild the list of bands that are on, carrying each one's filter state along with it.
+    float state[MIX_MAX_EQ_BANDS][2][MIX_EFFECT_MAX_CHANNELS];
+    int active_band[MIX_MAX_EQ_BANDS];
+    int num_active = 0;
+    for (int band = 0; band < MIX_MAX_EQ_BANDS; band++) {
+        if (fx->eq[band].type == MIX_EQ_NONE) {
+            continue;
+        }
+
+        SDL_zeroa(state[num_active]);
+        for (int slot = 0; slot < fx->num_eq_active; slot++) {
+            if (fx->eq_active_band[slot] == band) {
+                SDL_memcpy(state[num_active], fx->eq_state[slot], sizeof (state[num_active]));
+                break;
+            }
+        }
+        CalculateEQCoefficients(&fx->eq[band], freq, fx->eq_coefficients[num_active]);
+        active_band[num_active++] = band;
+    }
+
+    SDL_memcpy(fx->eq_state, state, sizeof (state));
+    SDL_memcpy(fx->eq_active_band, active_band, sizeof (active_band));
+    fx->num_eq_active = num_active;
+}
+
+// Work out the compressor's gain for each sample frame, with the group gain's ramp folded in, so both are applied in one pass.
+//  On input, `gains` has each frame's peak level (if the compressor is on); on output, it has the gain for each frame.
+static void CalculateCompressorGains(MIX_GroupEffects *fx, float *gains, const int frames, const int freq, const float group_gain, const float group_gain_step)
+{
+    const MIX_Compressor *params = &fx->target.compressor;
+    const bool enabled = fx->target.compressor_enabled;
+    const float threshold = DecibelsToGain(params->threshold_db);
+    const float exponent = (1.0f / SDL_max(params->ratio, 1.0f)) - 1.0f;
+    const float makeup = DecibelsToGain(params->makeup_db);
+    const float attack = SDL_expf(-1000.0f / (SDL_max(params->attack_ms, 0.01f) * ((float) freq)));
+    const float release = SDL_expf(-1000.0f / (SDL_max(params->release_ms, 1.0f) * ((float) freq)));
+    float envelope = fx->compressor_envelope;
+    float gain = fx->compressor_gain;
+    float ramp = group_gain;
+
+    int i = 0;
+    while (i < frames) {
+        const int total = SDL_min(MIX_DYNAMICS_CONTROL_FRAMES, frames - i);
+        float target = 1.0f;   // when the compressor turns off, glide back to no change.
+        if (enabled) {
+            for (int j = 0; j < total; j++) {
+                const float peak = gains[i + j];
+                envelope = peak + (((peak > envelope) ? attack : release) * (envelope - peak));
             }
-            br = SDL_GetAudioStreamData(track->input_stream, pcm, bytes_remaining);
+            target = makeup * ((envelope > threshold) ? SDL_powf(envelope / threshold, exponent) : 1.0f);
         }
 
-        // if input_audio and input_stream are both NULL, there's nothing to play (maybe they changed out the input on us?), br will be zero and we'll go to end_of_audio=true.
+        const float step = (target - gain) / (float) total;
+        for (int j = 0; j < total; j++, i++) {
+            gain += step;
+            ramp += group_gain_step;
+            gains[i] = gain * ramp;
+        }
+        gain = target;  // don't let rounding drift.
+    }
 
-        if (br <= 0) {  // if 0: EOF. if < 0: decoding/input failure, we're done by default. But maybe it'll loop and play the start again...!
-            end_of_audio = true;
-        } else {
-            SDL_assert(track->input_stream != NULL);  // should have data bound if you landed here.
+    fx->compressor_envelope = enabled ? envelope : 0.0f;
+    fx->compressor_gain = gain;
+}
 
-            // this (probably?) shouldn't be a partial read here. It's either we completely filled the buffer or exhausted the data.
-            //  as such, this does raw_callback() as likely the entire buffer, or all we're getting before a finish callback would have to fire,
-            //  even if the finish callback would restart the track. As such, the outer loop is mostly here to deal with looping tracks
-            //  and finish callbacks that restart the track.
+// Work out the limiter's gain for each sample frame. It holds a peak for the length of the lookahead, and turns
+//  down fast enough to be nearly there by the time that peak comes out of the delay line; the clamp in
+//  ApplyLimiterFloat32Audio catches whatever is left. On input, `gains` has each frame's peak level.
+static void CalculateLimiterGains(MIX_GroupEffects *fx, float *gains, const int frames, const int freq, const int lookahead, const float ceiling)
+{
+    const float release = SDL_expf(-1000.0f / (SDL_max(fx->target.limiter.release_ms, 1.0f) * ((float) freq)));
+    const float attack = 1.0f - SDL_expf(-5.0f / (float) lookahead);
+    float envelope = fx->limiter_envelope;
+    float gain = fx->limiter_gain;
+    int hold = fx->limiter_hold;
+
+    for (int i = 0; i < frames; i++) {
+        const float peak = gains[i];
+        if (peak >= envelope) {
+            envelope = peak;
+            hold = lookahead;
+        } else if (hold > 0) {
+            hold--;
+        } else {
+            envelope = peak + (release * (envelope - peak));
+        }
 
-            // if this would put us past the end of maxframes, or a fadeout, clamp br and set end_of_audio=true so we can do looping, etc.
-            Sint64 maxpos = -1;
-            if (track->max_frame >= 0) {
-                maxpos = track->max_frame;
-            }
-            if (track->fade_direction < 0) {
-                const Sint64 maxfadepos = (Sint64) (track->position + track->fade_frames);
-                if ((maxpos < 0) || (maxfadepos < maxpos)) {
-                    maxpos = maxfadepos;
-                }
-            }
+        const float target = (envelope > ceiling) ? (ceiling / envelope) : 1.0f;
+        gain += (target - gain) * ((target < gain) ? attack : (1.0f - release));
+        gains[i] = gain;
+    }
 
-            const int raw_channels = raw_spec.channels;
+    fx->limiter_envelope = envelope;
+    fx->limiter_gain = gain;
+    fx->limiter_hold = hold;
+}
 
-            int frames_read = br / (sizeof (float) * raw_channels);
-            if (maxpos >= 0) {
-                const Sint64 newpos = (Sint64)(track->position + frames_read);
-                if (newpos >= maxpos) {  // we read past the end of the fade out or maxframes, we need to clamp.
-                    br -= (int)(((newpos - maxpos) * raw_channels) * sizeof(float));
-                    frames_read = br / (sizeof (float) * raw_channels);
-                    end_of_audio = true;
-                }
-            }
+// Run a group's built-in effects over its mix, in place. Returns false if it has none, in which case `mixbuf` is untouched.
+// `scratch` must hold at least one float per sample frame.
+// this is called from the audio device thread with the mixer locked.
+static bool ProcessGroupEffects(MIX_Mixer *mixer, MIX_Group *group, float *mixbuf, float *scratch, const int frames)
+{
+    MIX_GroupEffects *fx = &group->effects;
+    const MIX_GroupEffectParams *target = &fx->target;
+    const int channels = mixer->spec.channels;
+    const int freq = mixer->spec.freq;
 
-            // give the app a shot at the final buffer before sending it on through transformations.
-            const int samples = frames_read * raw_channels;
+    SyncGroupEffects(fx);
 
-            if (track->raw_callback) {
-                track->raw_callback(track->raw_callback_userdata, track, &raw_spec, pcm, samples);
-            }
+    bool eq = false;
+    for (int band = 0; band < MIX_MAX_EQ_BANDS; band++) {
+        if ((target->eq[band].type != MIX_EQ_NONE) || (fx->eq[band].type != MIX_EQ_NONE)) {
+            eq = true;
+            break;
+        }
+    }
+    const bool dynamics = target->compressor_enabled || (fx->compressor_gain != 1.0f) || (target->gain != 1.0f) || (fx->gain != 1.0f);
+    const bool limiter = target->limiter_enabled;
 
-            ApplyFade(track, raw_channels, pcm, frames_read);
+    if ((!eq && !dynamics && !limiter) || (frames <= 0)) {
+        return false;  // the usual case: nothing to do.
+    } else if (channels > MIX_EFFECT_MAX_CHANNELS) {
+        return false;
+    }
 
-            const int put_bytes = samples * sizeof (float);
-            SDL_PutAudioStreamData(stream, pcm, put_bytes);
+    const Uint64 mix_start = SDL_GetTicksNS();
 
-            track->position += frames_read;
-            bytes_remaining -= put_bytes;
-        }
+    if (fx->channels != channels) {  // new output format; start the filters fresh.
+        SDL_zeroa(fx->eq_state);
+        SDL_zeroa(fx->limiter_ring);
+        fx->limiter_position = 0;
+        fx->limiter_envelope = 0.0f;
+        fx->limiter_hold = 0;
+        fx->channels = channels;
+    }
 
-        // remember that the callback in TrackStopped() might restart this track,
-        //  so we'll loop to see if we can fill in more audio without a gap even in that case.
-        if (end_of_audio) {
-            if (track->input_audio) {
-                SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input is removed.
-            }
-            bool track_stopped = false;
-            if (track->loops_remaining == 0) {
-                if (track->silence_frames < 0) {
-                    track->silence_frames = -track->silence_frames;  // time to start appending silence.
-                } else {
-                    track_stopped = true;  // out of data, no loops remain, no appended silence left, we're done.
-                }
-            } else {
-                if (track->loops_remaining > 0) {  // negative means infinite loops, so don't decrement for that.
-                    track->loops_remaining--;
-                }
-                if (!track->input_audio) {  // can't loop on a streaming input, you're done.
-                    track_stopped = true;
-                } else {
-                    if (!track->input_audio->decoder->seek(track->decoder_userdata, track->loop_start)) {
-                        track_stopped = true;  // uhoh, can't seek! Abandon ship!
-                    } else {
-                        track->position = track->loop_start;
+    if (eq) {
+        UpdateGroupEQ(fx, freq);
+        if (fx->num_eq_active > 0) {
+            ProcessEQFloat32Audio(mixbuf, frames, channels, fx->num_eq_active, (const float (*)[5]) fx->eq_coefficients, fx->eq_state);
+            for (int slot = 0; slot < fx->num_eq_active; slot++) {  // don't let the filters decay into denormals during silence.
+                for (int i = 0; i < channels; i++) {
+                    for (int j = 0; j < 2; j++) {
+                        if (SDL_fabsf(fx->eq_state[slot][j][i]) < 1e-20f) {
+                            fx->eq_state[slot][j][i] = 0.0f;
+                        }
                     }
                 }
             }
+        }
+    }
 
-            if (track_stopped) {
-                TrackStopped(track);
-            }
+    if (dynamics) {
+        if (target->compressor_enabled) {
+            FramePeaksFloat32Audio(mixbuf, frames, channels, scratch);
+        }
+        CalculateCompressorGains(fx, scratch, frames, freq, fx->gain, (target->gain - fx->gain) / (float) frames);
+        fx->gain = target->gain;
+        ApplyFrameGainsFloat32Audio(mixbuf, frames, channels, scratch);
+    }
+
+    if (limiter) {
+        const int lookahead = SDL_clamp((int) (target->limiter.lookahead_ms * 0.001f * (float) freq), 1, MIX_LIMITER_MAX_LOOKAHEAD_FRAMES - 1);
+        const float ceiling = DecibelsToGain(target->limiter.ceiling_db);
+        FramePeaksFloat32Audio(mixbuf, frames, channels, scratch);
+        CalculateLimiterGains(fx, scratch, frames, freq, lookahead, ceiling);
+
+        // go through the delay line in runs that don't wrap around its end.
+        int done = 0;
+        while (done < frames) {
+            const int in_position = fx->limiter_position;
+            const int out_position = (in_position + MIX_LIMITER_MAX_LOOKAHEAD_FRAMES - lookahead) % MIX_LIMITER_MAX_LOOKAHEAD_FRAMES;
+            const int total = SDL_min(frames - done, MIX_LIMITER_MAX_LOOKAHEAD_FRAMES - SDL_max(in_position, out_position));
+            ApplyLimiterFloat32Audio(mixbuf + (done * channels), fx->limiter_ring + (in_position * channels), fx->limiter_ring + (out_position * channels), total, channels, scratch + done, ceiling);
+            fx->limiter_position = (in_position + total) % MIX_LIMITER_MAX_LOOKAHEAD_FRAMES;
+            done += total;
         }
     }
+
+    AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
+    return true;
 }
 
-static void MixSpatializedFloat32Audio(float *dst, const float *src, const int samples, const int output_channels, const float *panning, const int *speakers, const float gain)
+// The reverb is idle once nothing has been sent for long enough to get through the pre-delay and the longest delay line,
+//  and what comes out is below this. The delay lines are cleared then, instead of decaying forever into denormals, and
+//  it skips processing until something is sent again.
+#define MIX_REVERB_SILENCE 0.00001f  // -100dB
+#define MIX_REVERB_MAX_DAMPING 0.9f
+
+static void UpdateReverb(MIX_ReverbState *reverb, const int freq)
 {
-    const float panning0 = panning[0] * gain;
-    const float panning1 = panning[1] * gain;
-    const int speaker0 = speakers[0];
-    const int speaker1 = speakers[1];
+    const MIX_Reverb *params = &reverb->params;
+    const float scale = (1.0f + ((MIX_REVERB_MAX_ROOM_SCALE - 1.0f) * SDL_clamp(params->room_size, 0.0f, 1.0f))) * (freq / 1000.0f);
+    const float decay_frames = params->decay_time * freq;
 
-    // !!! FIXME: a common case (output_channels==2, speaker0=0, speaker1=1) can be easily SIMD'd.
-    // !!! FIXME: unroll this loop?
-    if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
-        return;  // don't mix silence.
-    } else if ((panning0 == 1.0f) && (panning1 == 1.0f)) {  // no modulation.
-        for (int i = 0; i < samples; i++, dst += output_channels, src++) {
-            const float sample = *src;
-            dst[speaker0] += sample;
-            dst[speaker1] += sample;
-        }
-    } else {
-        for (int i = 0; i < samples; i++, dst += output_channels, src++) {
-            const float sample = *src;
-            dst[speaker0] += sample * panning0;
-            dst[speaker1] += sample * panning1;
-        }
+    for (int i = 0; i < MIX_REVERB_LINES; i++) {
+        const int length = SDL_clamp((int) (MIX_ReverbLineMs[i] * scale), 1, reverb->capacity);
+        reverb->lengths[i] = length;
+        reverb->feedback[i] = SDL_powf(10.0f, (-3.0f * length) / decay_frames);  // -60dB after decay_time.
     }
+
+    reverb->damping = SDL_clamp(params->damping, 0.0f, 1.0f) * MIX_REVERB_MAX_DAMPING;
+    reverb->predelay_length = SDL_clamp((int) ((params->predelay_ms * freq) / 1000.0f), 0, reverb->predelay_capacity - 1);
 }
 
-static void MixForcedStereoFloat32Audio(float *dst, const float *src, const int sample_frames, const int output_channels, const float *panning, const float gain)
+// replace a send bus's audio with its reverb. Returns false if the reverb is idle, so there's nothing to mix back in.
+static bool ProcessSendBusReverb(MIX_Mixer *mixer, MIX_ReverbState *reverb, float *busbuf, const int frames, const bool sent)
 {
-    const float panning0 = panning[0] * gain;
-    const float panning1 = panning[1] * gain;
+    if (reverb->changed) {
+        reverb->changed = false;
+        UpdateReverb(reverb, mixer->spec.freq);
+    }
 
-    // !!! FIXME: a common case (output_channels==2) can be easily SIMD'd.
-    // !!! FIXME: unroll this loop?
-    if ((panning0 == 0.0f) && (panning1 == 0.0f)) {
-        return;  // don't mix silence.
-    } else if ((panning0 == 1.0f) && (panning1 == 1.0f)) {  // no modulation.
-        for (int i = 0; i < sample_frames; i++, dst += output_channels, src += 2) {
-            dst[0] += src[0];
-            dst[1] += src[1];
-        }
+    if (sent) {
+        reverb->quiet_frames = 0;
+    } else if (reverb->idle) {
+        return false;
     } else {
-        for (int i = 0; i < sample_frames; i++, dst += output_channels, src += 2) {
-            dst[0] += src[0] * panning0;
-            dst[1] += src[1] * panning1;
-        }
+        reverb->quiet_frames = SDL_min(reverb->quiet_frames + frames, SDL_MAX_SINT32 - frames);  // a very long decay_time might never go idle.
     }
-}
 
-static void MixFloat32Audio(float *dst, const float *src, const int buffer_size, const float gain)
-{
-    if (gain == 0.0f) {
-        return;  // don't mix silence.
-    } else if (!SDL_MixAudio((Uint8 *) dst, (const Uint8 *) src, SDL_AUDIO_F32, buffer_size, gain)) {
-        SDL_assert(!"This shouldn't happen.");
+    const float peak = ProcessReverbFloat32Audio(reverb, busbuf, frames, mixer->spec.channels);
+
+    reverb->idle = (reverb->quiet_frames > (reverb->predelay_length + reverb->lengths[MIX_REVERB_LINES - 1])) && (peak < MIX_REVERB_SILENCE);
+    if (reverb->idle) {
+        SDL_memset(reverb->lines, '\0', reverb->capacity * MIX_REVERB_LINES * sizeof (float));
+        SDL_memset(reverb->predelay, '\0', reverb->predelay_capacity * sizeof (float));
+        SDL_zeroa(reverb->damping_state);
     }
+    return true;
 }
 
 // SDL calls this function from the audio device thread as more data is needed the mixer.
@@ -538,6 +4855,19 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
 
     MIX_Mixer *mixer = (MIX_Mixer *) userdata;
 
+    // in real-time-safe mode, our buffers are only big enough for `realtime_frames`, so if asked for more, do it in pieces.
+    const int realtime_amount = mixer->realtime_frames * SDL_AUDIO_FRAMESIZE(mixer->spec);
+    if ((realtime_amount > 0) && (additional_amount > realtime_amount)) {
+        while (additional_amount > 0) {
+            const int amount = SDL_min(additional_amount, realtime_amount);
+            MixerCallback(userdata, stream, amount, amount);
+            additional_amount -= amount;
+        }
+        return;
+    }
+
+    const Uint64 start_ns = SDL_GetTicksNS();
+
     // it should be asking for float data...
     SDL_assert((additional_amount % sizeof (float)) == 0);
 
@@ -549,12 +4879,44 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
     const int alloc_multiplier = skip_group_mixing ? 2 : 3;
     const int alloc_size = additional_amount * alloc_multiplier;
     if (alloc_size > mixer->mix_buffer_allocation) {
-        void *ptr = SDL_realloc(mixer->mix_buffer, alloc_size);
-        if (!ptr) {   // uhoh.
+        SDL_assert(mixer->realtime_frames == 0);  // ReserveRealtimeBuffers should have taken care of this.
+        if (!GrowScratchBuffer(&mixer->mix_buffer, &mixer->mix_buffer_allocation, alloc_size)) {   // uhoh.
+            return;  // not much to be done, we're out of memory!
+        }
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    const size_t ambisonic_size = AmbisonicBusSize(mixer, additional_amount);
+    if (ambisonic_size > mixer->ambisonic_buffer_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);  // ReserveRealtimeBuffers should have taken care of this.
+        if (!GrowScratchBuffer(&mixer->ambisonic_buffer, &mixer->ambisonic_buffer_allocation, ambisonic_size)) {
+            return;  // not much to be done, we're out of memory!
+        }
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    MIX_AmbisonicBus ambisonic;
+    ambisonic.buffer = ambisonic_size ? mixer->ambisonic_buffer : NULL;
+    ambisonic.frames = additional_amount / SDL_AUDIO_FRAMESIZE(mixer->spec);
+    ambisonic.used = false;
+
+    const size_t send_size = SendBusSize(mixer, additional_amount);
+    if (send_size > mixer->send_buffer_allocation) {
+        SDL_assert(mixer->realtime_frames == 0);  // ReserveRealtimeBuffers should have taken care of this.
+        if (!GrowScratchBuffer(&mixer->send_buffer, &mixer->send_buffer_allocation, send_size)) {
             return;  // not much to be done, we're out of memory!
         }
-        mixer->mix_buffer = (float *) ptr;
-        mixer->mix_buffer_allocation = alloc_size;
+        AddPendingStat(&mixer->pending_stats.buffer_reallocations, 1);
+    }
+
+    MIX_SendBuffers sends;
+    sends.buffer = send_size ? mixer->send_buffer : NULL;
+    sends.amount = additional_amount;
+    SDL_zeroa(sends.used);
+    MIX_SendBuffers *track_sends = NULL;
+    if (sends.buffer) {
+        SDL_memset(sends.buffer, '\0', send_size);
+        track_sends = &sends;
     }
 
     float *getbuf = mixer->mix_buffer;
@@ -563,6 +4925,27 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
 
     SDL_memset(final_mixbuf, '\0', additional_amount);
 
+    ApplyCommittedBatches(mixer);
+    ApplySpatialBlock(mixer);
+    UpdateVoices(mixer);
+
+    // if rendering in parallel, mix all the tracks up front, and then just sum up the results below.
+    const bool parallel = (mixer->num_render_threads > 0) && PrepareRenderJobs(mixer, additional_amount);
+    if (parallel) {
+        const int helpers = SDL_min(mixer->num_render_threads, mixer->num_render_jobs - 1);
+        SDL_SetAtomicInt(&mixer->render_next_job, 0);
+        for (int i = 0; i < helpers; i++) {
+            SDL_SignalSemaphore(mixer->render_start);
+        }
+        RunRenderJobs(mixer, &mixer->render_threads[0]);  // this thread works on jobs too, instead of just waiting.
+        for (int i = 0; i < helpers; i++) {
+            SDL_WaitSemaphore(mixer->render_done);
+        }
+        ReclaimFireAndForgetTracks(mixer);
+    }
+
+    const MIX_RenderJob *job = mixer->render_jobs;
+    const MIX_RenderJob *end_job = parallel ? (job + mixer->num_render_jobs) : job;
     MIX_Group *next_group = NULL;
     for (MIX_Group *group = mixer->all_groups; group; group = next_group) {
         next_group = group->next;  // this won't save you from a callback going totally rogue, but it'll deal with the current group changing.
@@ -570,57 +4953,105 @@ static void SDLCALL MixerCallback(void *userdata, SDL_AudioStream *stream, int a
             SDL_memset(group_mixbuf, '\0', additional_amount);  // if skip_group_mixing, this is final_mixbuf, which we just zero'd out.
         }
 
+        MIX_AmbisonicBus *group_ambisonic = NULL;
+        if (ambisonic.buffer) {
+            SDL_memset(ambisonic.buffer, '\0', ambisonic_size);
+            ambisonic.used = false;
+            group_ambisonic = &ambisonic;
+        }
+
         int group_bytes = 0;
-        MIX_Track *next_track = NULL;
-        for (MIX_Track *track = group->tracks; track; track = next_track) {
-            next_track = track->group_next;  // this won't save you from a callback going totally rogue, but it'll deal with the current track leaving the group.
-            const int to_be_read = (additional_amount / SDL_AUDIO_FRAMESIZE(mixer->spec)) * SDL_AUDIO_FRAMESIZE(track->output_spec);
-            const int br = SDL_GetAudioStreamData(track->output_stream, getbuf, to_be_read);
-            if (br > 0) {
-                if (track->cooked_callback) {
-                    track->cooked_callback(track->cooked_callback_userdata, track, &track->output_spec, getbuf, br / sizeof (float));
+        if (parallel) {
+            // sum this group's jobs in order, so the results don't depend on what thread rendered what.
+            const Uint64 mix_start = SDL_GetTicksNS();
+            for (; (job < end_job) && (job->group == group); job++) {
+                MixFloat32Audio(group_mixbuf, job->mixbuf, job->mixed_bytes, 1.0f);  // we adjusted for mixer->gain for each track, don't adjust gain here, too.
+                group_bytes = SDL_max(group_bytes, job->mixed_bytes);
+                if (group_ambisonic && job->ambisonic.used) {
+                    MixFloat32Audio(ambisonic.buffer, job->ambisonic.buffer, (int) ambisonic_size, 1.0f);
+                    ambisonic.used = true;
                 }
-
-                switch (track->spatialization_mode) {
-                    case MIX_SPATIALIZATION_NONE:
-                        SDL_assert(track->output_spec.channels == mixer->spec.channels);
-                        MixFloat32Audio(group_mixbuf, getbuf, br, mixer->gain);
-                        group_bytes = SDL_max(group_bytes, br);
-                        break;
-
-                    case MIX_SPATIALIZATION_3D:
-                        SDL_assert(track->output_spec.channels == 1);
-                        MixSpatializedFloat32Audio(group_mixbuf, getbuf, br / sizeof (float), mixer->spec.channels, track->spatialization_panning, track->spatialization_speakers, mixer->gain);
-                        group_bytes = SDL_max(group_bytes, br * mixer->spec.channels);
-                        break;
-
-                    case MIX_SPATIALIZATION_STEREO:
-                        SDL_assert(track->output_spec.channels == 2);
-                        MixForcedStereoFloat32Audio(group_mixbuf, getbuf, br / (sizeof (float) * 2), mixer->spec.channels, track->spatialization_panning, mixer->gain);
-                        group_bytes = SDL_max(group_bytes, (br / 2) * mixer->spec.channels);
-                        break;
-
-                    default:
-                        SDL_assert(!"Unexpected spatialization mode");
-                        break;
+                if (track_sends) {
+                    for (int bus = 0; bus < MIX_MAX_SEND_BUSES; bus++) {
+                        if (job->sends.used[bus]) {
+                            const int offset = bus * (additional_amount / sizeof (float));
+                            MixFloat32Audio(sends.buffer + offset, job->sends.buffer + offset, additional_amount, 1.0f);
+                            sends.used[bus] = true;
+                        }
+                    }
                 }
             }
+            AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
+        } else {
+            MIX_Track *next_track = NULL;
+            for (MIX_Track *track = group->tracks; track; track = next_track) {
+                next_track = track->group_next;  // this won't save you from a callback going totally rogue, but it'll deal with the current track leaving the group.
+                group_bytes = SDL_max(group_bytes, MixTrack(mixer, track, getbuf, group_mixbuf, group_ambisonic, track_sends, additional_amount));
+            }
+        }
+
+        // decode the group's 3D tracks before its postmix callback, so the callback hears them like everything else.
+        if (ambisonic.used) {
+            const Uint64 mix_start = SDL_GetTicksNS();
+            DecodeAmbisonicBus(mixer, group, &ambisonic, getbuf, group_mixbuf);
+            group_bytes = additional_amount;
+            AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
+        }
+
+        // the group's built-in effects run before its postmix callback, too.
+        if (ProcessGroupEffects(mixer, group, group_mixbuf, getbuf, additional_amount / SDL_AUDIO_FRAMESIZE(mixer->spec))) {
+            group_bytes = additional_amount;  // filters ring and the limiter's delay line drains, even if nothing was mixed.
         }
 
         if (group->postmix_callback) {
+            const Uint64 callback_start = SDL_GetTicksNS();
             group->postmix_callback(group->postmix_callback_userdata, group, &mixer->spec, group_mixbuf, additional_amount / sizeof (float));
+            AddPendingStat(&mixer->pending_stats.app_callback_ns, SDL_GetTicksNS() - callback_start);
         }
 
         if (!skip_group_mixing) {
+            const Uint64 mix_start = SDL_GetTicksNS();
             MixFloat32Audio(final_mixbuf, group_mixbuf, group_bytes, 1.0f);  // we adjusted for mixer->gain for each track, don't adjust gain here, too.
+            AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
+        }
+    }
+
+    // every track has fed the send buses by now; process each one and mix it back in.
+    if (track_sends) {
+        for (int bus = 0; bus < MIX_MAX_SEND_BUSES; bus++) {
+            const MIX_SendBus *send_bus = &mixer->send_buses[bus];
+            float *busbuf = sends.buffer + (bus * (additional_amount / sizeof (float)));
+            if (send_bus->reverb) {
+                const Uint64 effects_start = SDL_GetTicksNS();
+                if (ProcessSendBusReverb(mixer, send_bus->reverb, busbuf, additional_amount / SDL_AUDIO_FRAMESIZE(mixer->spec), sends.used[bus])) {
+                    sends.used[bus] = true;  // the tail keeps ringing after the tracks stop sending.
+                }
+                AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - effects_start);
+            }
+
+            if (send_bus->callback) {  // this runs even if nothing was sent, so effects like reverb can ring out.
+                const Uint64 callback_start = SDL_GetTicksNS();
+                send_bus->callback(send_bus->callback_userdata, mixer, bus, &mixer->spec, busbuf, additional_amount / sizeof (float));
+                AddPendingStat(&mixer->pending_stats.app_callback_ns, SDL_GetTicksNS() - callback_start);
+            } else if (!sends.used[bus]) {
+                continue;  // nothing to mix back in.
+            }
+
+            const Uint64 mix_start = SDL_GetTicksNS();
+            MixFloat32Audio(final_mixbuf, busbuf, additional_amount, send_bus->gain);
+            AddPendingStat(&mixer->pending_stats.mix_ns, SDL_GetTicksNS() - mix_start);
         }
     }
 
     if (mixer->postmix_callback) {
+        const Uint64 callback_start = SDL_GetTicksNS();
         mixer->postmix_callback(mixer->postmix_callback_userdata, mixer, &mixer->spec, final_mixbuf, additional_amount / sizeof (float));
+        AddPendingStat(&mixer->pending_stats.app_callback_ns, SDL_GetTicksNS() - callback_start);
     }
 
     SDL_PutAudioStreamData(stream, final_mixbuf, additional_amount);
+
+    UpdateMixerStats(mixer, start_ns, additional_amount);
 }
 
 bool MIX_Generate(MIX_Mixer *mixer, void *buffer, int buflen)
@@ -668,11 +5099,15 @@ bool MIX_Init(void)
         }
         #endif
 
-        #if defined(SDL_NEON_INTRINSICS) && !NEED_SCALAR_FALLBACK
+        #if defined(SDL_AVX2_INTRINSICS)
+        MIX_HasAVX2 = SDL_HasAVX2();
+        #endif
+
+        #if defined(SDL_NEON_INTRINSICS) && !SDL_MIXER_NEED_SCALAR_FALLBACK
         if (!SDL_HasNEON()) {
             return SDL_SetError("Need NEON instructions but this CPU doesn't offer it");  // :(
         }
-        #elif defined(SDL_NEON_INTRINSICS) && NEED_SCALAR_FALLBACK
+        #elif defined(SDL_NEON_INTRINSICS) && SDL_MIXER_NEED_SCALAR_FALLBACK
         MIX_HasNEON = SDL_HasNEON();
         #endif
 
@@ -712,6 +5147,10 @@ void MIX_Quit(void)
         MIX_DestroyAudio(all_audios);
     }
 
+    if (num_decode_ahead_threads > 0) {
+        QuitDecodeAheadPool();
+    }
+
     QuitDecoders();
 
     SDL_DestroyMutex(global_lock);
@@ -767,6 +5206,11 @@ static MIX_Mixer *CreateMixer(SDL_AudioStream *stream)
         goto failed;
     }
 
+    mixer->batch_lock = SDL_CreateMutex();
+    if (!mixer->batch_lock) {
+        goto failed;
+    }
+
     mixer->default_group = MIX_CreateGroup(mixer);
     if (!mixer->default_group) {
         goto failed;
@@ -778,6 +5222,11 @@ static MIX_Mixer *CreateMixer(SDL_AudioStream *stream)
     SDL_SetAudioStreamGetCallback(stream, MixerCallback, mixer);
 
     MIX_VBAP2D_Init(&mixer->vbap2d, output_spec.channels);
+    MIX_InitListener3D(&mixer->listener3d);
+    mixer->speed_of_sound = MIX_DEFAULT_SPEED_OF_SOUND;
+    for (int i = 0; i < MIX_MAX_SEND_BUSES; i++) {
+        mixer->send_buses[i].gain = 1.0f;
+    }
 
     LockGlobal();
     mixer->next = all_mixers;
@@ -794,6 +5243,7 @@ failed:
     if (mixer) {
         if (mixer->default_group) { MIX_DestroyGroup(mixer->default_group); }
         if (mixer->track_tags) { SDL_DestroyProperties(mixer->track_tags); }
+        if (mixer->batch_lock) { SDL_DestroyMutex(mixer->batch_lock); }
         SDL_free(mixer);
     }
     return NULL;
@@ -870,10 +5320,32 @@ void MIX_DestroyMixer(MIX_Mixer *mixer)
         SDL_RemoveEventWatch(AudioDeviceChangeEventWatcher, mixer);
     }
 
+    LockMixer(mixer);
+    StopRenderThreads(mixer);
+    UnlockMixer(mixer);
+
     SDL_DestroyAudioStream(mixer->output_stream);
     SDL_DestroyProperties(mixer->track_tags);
     SDL_DestroyProperties(mixer->props);
-    SDL_free(mixer->mix_buffer);
+    SDL_aligned_free(mixer->mix_buffer);
+    SDL_free(mixer->render_jobs);
+    SDL_free(mixer->render_tracks);
+    SDL_aligned_free(mixer->render_buffer);
+    SDL_aligned_free(mixer->ambisonic_buffer);
+    SDL_aligned_free(mixer->ambisonic_render_buffer);
+    SDL_aligned_free(mixer->send_buffer);
+    SDL_aligned_free(mixer->send_render_buffer);
+    for (int i = 0; i < MIX_MAX_SEND_BUSES; i++) {
+        DestroyReverbState(mixer->send_buses[i].reverb);
+    }
+    SDL_free(mixer->voice_tracks);
+    FreeCommandBatches(mixer->batch);
+    FreeCommandBatches(mixer->free_batches);
+    FreeCommandBatches(mixer->committed_batches);
+    FreeCommandBatches(mixer->spent_batches);
+    SDL_DestroyMutex(mixer->batch_lock);
+    FreeSpatialBlock(&mixer->spatial_block);
+    MIX_DestroyHRTF(mixer->hrtf);
 
     if (mixer->device_id) {
         SDL_QuitSubSystem(SDL_INIT_AUDIO);
@@ -932,11 +5404,12 @@ static const MIX_Decoder *PrepareDecoder(SDL_IOStream *io, MIX_Audio *audio)
     return NULL;
 }
 
-static void *DecodeWholeFile(MIX_Audio *audio, SDL_IOStream *io, size_t *decoded_len)
+// decode all of `audio`, converted to `spec`.
+static void *DecodeWholeFile(MIX_Audio *audio, SDL_IOStream *io, const SDL_AudioSpec *spec, size_t *decoded_len)
 {
     size_t bytes_decoded = 0;
     Uint8 *decoded = NULL;
-    SDL_AudioStream *stream = SDL_CreateAudioStream(&audio->spec, &audio->spec);   // !!! FIXME: if we're decoding up front, we might as well convert to float here too, right?
+    SDL_AudioStream *stream = SDL_CreateAudioStream(&audio->spec, spec);
     if (stream) {
         const MIX_Decoder *decoder = audio->decoder;
         void *track_userdata = NULL;
@@ -977,7 +5450,8 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
 
     SDL_IOStream *origio = (SDL_IOStream *) SDL_GetPointerProperty(props, MIX_PROP_AUDIO_LOAD_IOSTREAM_POINTER, NULL);
     MIX_Mixer *mixer = (MIX_Mixer *) SDL_GetPointerProperty(props, MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER, NULL);
-    const bool predecode = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN, false);
+    const bool predecode_mixer_format = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_PREDECODE_MIXER_FORMAT_BOOLEAN, false);
+    const bool predecode = predecode_mixer_format || SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN, false);
     const bool closeio = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_CLOSEIO_BOOLEAN, false);
     const bool ondemand = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_ONDEMAND_BOOLEAN, false);
     const bool skip_metadata_tags = SDL_GetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_SKIP_METADATA_TAGS_BOOLEAN, false);
@@ -1052,13 +5526,17 @@ MIX_Audio *MIX_LoadAudioWithProperties(SDL_PropertiesID props)  // lets you spec
     // set this before predecoding might change `decoder` to the RAW implementation.
     SDL_SetStringProperty(audio->props, MIX_PROP_AUDIO_DECODER_STRING, decoder->name);
 
-    // if this is already raw data, predecoding is just going to make a copy of it, so skip it.
-    if (predecode && (decoder != &MIX_Decoder_RAW) && (audio->duration_frames != MIX_DURATION_INFINITE)) {
-        audio->precache = DecodeWholeFile(audio, io, &audio->precachelen);
+    // if this is already raw data, predecoding is just going to make a copy of it, so skip it (unless we're converting it, too).
+    if (predecode && ((decoder != &MIX_Decoder_RAW) || predecode_mixer_format) && (audio->duration_frames != MIX_DURATION_INFINITE)) {
+        // converting to the mixer's format up front means tracks can copy this straight out of memory (see ReadDirectAudio).
+        SDL_AudioSpec decoded_spec;
+        SDL_copyp(&decoded_spec, predecode_mixer_format ? &recommended_spec : &audio->spec);
+        audio->precache = DecodeWholeFile(audio, io, &decoded_spec, &audio->precachelen);
         if (!audio->precache) {
             goto failed;
         }
         audio->free_precache = true;
+        SDL_copyp(&audio->spec, &decoded_spec);
 
         decoder->quit_audio(audio_userdata);
         decoder = audio->decoder = &MIX_Decoder_RAW;
@@ -1372,6 +5850,15 @@ MIX_Track *MIX_CreateTrack(MIX_Mixer *mixer)
     SDL_SetAudioStreamGetCallback(track->output_stream, TrackGetCallback, track);
 
     track->mixer = mixer;
+    track->raw_format = SDL_AUDIO_F32;
+    track->gain = 1.0f;
+    track->frequency_ratio = 1.0f;
+    track->doppler_ratio = 1.0f;
+    track->mixed_doppler_ratio = 1.0f;
+    track->attenuation = 1.0f;
+    track->occlusion_gain = 1.0f;
+    track->lowpass_coefficient = 1.0f;
+    track->audibility_threshold = -1.0f;  // use the mixer's.
 
     LockMixer(mixer);
     track->next = mixer->all_tracks;
@@ -1383,6 +5870,14 @@ MIX_Track *MIX_CreateTrack(MIX_Mixer *mixer)
 
     MIX_SetTrackGroup(track, NULL);  // this sets up state and updates linked lists. Should not fail!
 
+    LockMixer(mixer);
+    const bool reserved = ReserveRealtimeBuffers(mixer);
+    UnlockMixer(mixer);
+    if (!reserved) {
+        MIX_DestroyTrack(track);
+        return NULL;
+    }
+
     return track;
 }
 
@@ -1418,6 +5913,10 @@ void MIX_DestroyTrack(MIX_Track *track)
         track->next->prev = track->prev;
     }
 
+    if (track->audibility_threshold >= 0.0f) {
+        mixer->num_track_audibility_thresholds--;
+    }
+
     // we don't check the fire-and-forget pool because that is only free'd, with mixer->all_tracks, when closing the mixer.
     // !!! FIXME: maybe we _shouldn't_ keep the fire-and-forget pool in all_tracks, so we can skip processing them everywhere, and just explicitly free the pool in MIX_DestroyMixer.
 
@@ -1431,8 +5930,27 @@ void MIX_DestroyTrack(MIX_Track *track)
         track->group_next->group_prev = track->group_prev;
     }
     track->group = NULL;
+
+    // forget any recorded commands for this track. Do the open batch first, so one committed while we work is already clean.
+    SDL_LockMutex(mixer->batch_lock);
+    if (mixer->batch) {
+        ForgetTrackCommands(mixer->batch, track);
+    }
+    SDL_UnlockMutex(mixer->batch_lock);
+    for (MIX_CommandBatch *batch = (MIX_CommandBatch *) SDL_GetAtomicPointer((void **) &mixer->committed_batches); batch; batch = batch->next) {
+        ForgetTrackCommands(batch, track);  // MixerCallback can't be applying these right now, since we hold the mixer lock.
+    }
+
+    MIX_SpatialBlock *block = &mixer->spatial_block;
+    for (int i = 0; i < block->count; i++) {
+        if (block->tracks[i] == track) {
+            block->tracks[i] = NULL;
+        }
+    }
     UnlockMixer(mixer);
 
+    DestroyDecodeAhead(track);  // do this first; it has to shut out the workers before we touch the decoder.
+
     SDL_DestroyAudioStream(track->output_stream);
 
     if (track->input_audio) {
@@ -1445,7 +5963,8 @@ void MIX_DestroyTrack(MIX_Track *track)
     SDL_EnumerateProperties(track->tags, UntagWholeTrack, track);
     SDL_DestroyProperties(track->props);
     SDL_DestroyProperties(track->tags);
-    SDL_free(track->input_buffer);
+    SDL_aligned_free(track->input_buffer);
+    MIX_DestroyBinauralState(track->binaural);
     if (track->ioclamp.io) {  // if we applied an i/o clamp to the stream, close that unconditionally.
         SDL_CloseIO(track->io);   // this is the clamp, not the actual stream.
         track->io = track->ioclamp.io;  // this is the actual stream.
@@ -1484,14 +6003,18 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
         spec.freq = 44100;
         spec.channels = 2;
     }
-    spec.format = SDL_AUDIO_F32;  // we always work in float32.
 
+    // we work in float32, but Sint16 passes through as-is, so output_stream can convert it in the same pass that resamples it.
+    spec.format = (audio && (audio->spec.format == SDL_AUDIO_S16)) ? SDL_AUDIO_S16 : SDL_AUDIO_F32;
+
+    MIX_DecodeAhead *da = LockDecodeAhead(track);
     LockTrack(track);
 
     if (audio && (track->internal_stream == NULL)) {
         track->internal_stream = SDL_CreateAudioStream(&audio->spec, &spec);
         if (!track->internal_stream) {
             UnlockTrack(track);
+            UnlockDecodeAhead(da);
             if (closeio) {
                 SDL_CloseIO(io);
             }
@@ -1519,6 +6042,8 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
 
     track->input_audio = NULL;
     track->input_stream = NULL;
+    track->virtualized = false;  // whatever was virtual before is gone now.
+    track->direct_render = false;
 
     bool retval = true;
     if (audio) {
@@ -1544,6 +6069,8 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
                 RefAudio(audio);
                 SDL_SetAudioStreamFormat(track->internal_stream, &audio->spec, &spec);   // input is from decoded audio, output is to output_stream
                 SetTrackOutputStreamFormat(track, &spec);   // input is from internal_stream, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
+                track->raw_format = spec.format;
+                track->direct_render = IsDirectAudio(audio);
                 track->input_audio = audio;
                 track->input_stream = track->internal_stream;
                 SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input from before is removed.
@@ -1554,7 +6081,9 @@ static bool MIX_SetTrackAudio_internal(MIX_Track *track, MIX_Audio *audio, SDL_I
         }
     }
 
+    ResetDecodeAhead(track, false);
     UnlockTrack(track);
+    UnlockDecodeAhead(da);
 
     if (!retval && closeio) {
         SDL_CloseIO(origio);
@@ -1587,6 +6116,7 @@ bool MIX_SetTrackAudioStream(MIX_Track *track, SDL_AudioStream *stream)
         return false;
     }
 
+    MIX_DecodeAhead *da = LockDecodeAhead(track);
     LockTrack(track);
 
     if (track->input_audio) {
@@ -1616,9 +6146,14 @@ bool MIX_SetTrackAudioStream(MIX_Track *track, SDL_AudioStream *stream)
         SetTrackOutputStreamFormat(track, &spec);   // input is whatever in float format, output is to mixer->output_stream (or, if spatializing, to mixer->output_stream but mono).
     }
 
+    track->raw_format = SDL_AUDIO_F32;
+    track->direct_render = false;
+
     track->input_stream = stream;
     track->position = 0;
+    ResetDecodeAhead(track, false);  // just turns it off; streams don't decode ahead.
     UnlockTrack(track);
+    UnlockDecodeAhead(da);
 
     return true;
 }
@@ -1651,6 +6186,91 @@ bool MIX_SetTrackIOStream(MIX_Track *track, SDL_IOStream *io, bool closeio)
     return retval;
 }
 
+bool MIX_SetTrackDecodeAhead(MIX_Track *track, Sint64 frames)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (frames <= 0) {
+        frames = 0;  // turn it off, but keep the MIX_DecodeAhead; it lives until the track does, so other threads can always trust the pointer.
+    } else if (!StartDecodeAheadPool()) {
+        return false;
+    }
+
+    frames = SDL_min(frames, MIX_DECODE_AHEAD_MAX_FRAMES);
+    Uint32 ring_frames = 1;
+    while (ring_frames < (Uint32) frames) {
+        ring_frames <<= 1;  // power of two, so positions can wrap around and we can mask them.
+    }
+
+    if (!GetDecodeAhead(track)) {
+        if (frames == 0) {
+            return true;  // never turned on, nothing to do.
+        }
+
+        MIX_DecodeAhead *created = (MIX_DecodeAhead *) SDL_calloc(1, sizeof (*created));
+        if (!created) {
+            return false;
+        }
+        created->track = track;
+        created->lock = SDL_CreateMutex();
+        if (!created->lock) {
+            SDL_free(created);
+            return false;
+        }
+
+        // if another thread got here first, use theirs.
+        if (SDL_CompareAndSwapAtomicPointer((void **) &track->decode_ahead, NULL, created)) {
+            SDL_LockMutex(decode_ahead_lock);
+            created->next = decode_ahead_list;
+            if (decode_ahead_list) {
+                decode_ahead_list->prev = created;
+            }
+            decode_ahead_list = created;
+            SDL_UnlockMutex(decode_ahead_lock);
+        } else {
+            SDL_DestroyMutex(created->lock);
+            SDL_free(created);
+        }
+    }
+
+    MIX_DecodeAhead *da = LockDecodeAhead(track);
+    LockTrack(track);
+    da->requested_frames = frames;
+    da->ring_frames = ring_frames;
+    if (frames == 0) {
+        SDL_SetAtomicInt(&da->underruns, 0);
+    }
+    ResetDecodeAhead(track, true);  // internal_stream (or the old ring) has data the mix hasn't used yet, so the decoder is ahead of track->position.
+    UnlockTrack(track);
+    UnlockDecodeAhead(da);
+
+    return true;
+}
+
+Sint64 MIX_GetTrackDecodeAhead(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return -1;
+    }
+
+    LockTrack(track);
+    const Sint64 retval = track->decode_ahead ? track->decode_ahead->requested_frames : 0;
+    UnlockTrack(track);
+    return retval;
+}
+
+Sint64 MIX_GetTrackDecodeUnderruns(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return -1;
+    }
+
+    LockTrack(track);
+    const Sint64 retval = track->decode_ahead ? (Sint64) SDL_GetAtomicInt(&track->decode_ahead->underruns) : 0;
+    UnlockTrack(track);
+    return retval;
+}
+
 static void SDLCALL CleanupTagList(void *userdata, void *value)
 {
     MIX_TagList *list = (MIX_TagList *) value;
@@ -1788,6 +6408,7 @@ bool MIX_SetTrackPlaybackPosition(MIX_Track *track, Sint64 frames)
     bool retval = true;
 
     // !!! FIXME: should it be legal to seek past the end of an track (so it just stops immediately, or maybe stops on next callback)?
+    MIX_DecodeAhead *da = LockDecodeAhead(track);
     LockTrack(track);
     if (!track->input_audio) {
         if (track->input_stream) {  // can't seek a stream that was set up with MIX_SetTrackAudioStream.
@@ -1800,9 +6421,11 @@ bool MIX_SetTrackPlaybackPosition(MIX_Track *track, Sint64 frames)
         if (retval) {
             SDL_ClearAudioStream(track->input_stream);   // make sure that any extra buffered input from before the seek is removed.
             track->position = (Uint64) frames;
+            ResetDecodeAhead(track, false);
         }
     }
     UnlockTrack(track);
+    UnlockDecodeAhead(da);
 
     return retval;
 }
@@ -1976,6 +6599,9 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
     Sint64 loop_start = 0;
     Sint64 fade_in = 0;
     Sint64 append_silence_frames = 0;
+    MIX_FadeCurve fade_in_curve = MIX_FADE_CURVE_LINEAR;
+    MIX_FadeCurve fade_out_curve = MIX_FADE_CURVE_LINEAR;
+    MIX_DecodeAhead *da = LockDecodeAhead(track);
     LockTrack(track);
     if (options) {
         loops = (int) SDL_GetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, loops);
@@ -1984,6 +6610,16 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
         loop_start = GetTrackOptionFramesOrTicks(track, options, MIX_PROP_PLAY_LOOP_START_FRAME_NUMBER, MIX_PROP_PLAY_LOOP_START_MILLISECOND_NUMBER, loop_start);
         fade_in = GetTrackOptionFramesOrTicks(track, options, MIX_PROP_PLAY_FADE_IN_FRAMES_NUMBER, MIX_PROP_PLAY_FADE_IN_MILLISECONDS_NUMBER, fade_in);
         append_silence_frames = GetTrackOptionFramesOrTicks(track, options, MIX_PROP_PLAY_APPEND_SILENCE_FRAMES_NUMBER, MIX_PROP_PLAY_APPEND_SILENCE_MILLISECONDS_NUMBER, append_silence_frames);
+        fade_in_curve = (MIX_FadeCurve) SDL_GetNumberProperty(options, MIX_PROP_PLAY_FADE_IN_CURVE_NUMBER, fade_in_curve);
+        fade_out_curve = (MIX_FadeCurve) SDL_GetNumberProperty(options, MIX_PROP_PLAY_FADE_OUT_CURVE_NUMBER, fade_out_curve);
+    }
+
+    if ((fade_in_curve < MIX_FADE_CURVE_LINEAR) || (fade_in_curve > MIX_FADE_CURVE_EXPONENTIAL)) {
+        fade_in_curve = MIX_FADE_CURVE_LINEAR;
+    }
+
+    if ((fade_out_curve < MIX_FADE_CURVE_LINEAR) || (fade_out_curve > MIX_FADE_CURVE_EXPONENTIAL)) {
+        fade_out_curve = MIX_FADE_CURVE_LINEAR;
     }
 
     if (start_pos < 0) {
@@ -2000,9 +6636,11 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
 
     if (track->input_audio && (!track->input_audio->decoder->seek(track->decoder_userdata, start_pos))) {
         UnlockTrack(track);
+        UnlockDecodeAhead(da);
         return false;
     } else if (!track->input_audio && (start_pos != 0)) {
         UnlockTrack(track);
+        UnlockDecodeAhead(da);
         return SDL_SetError("Playing an input stream (not MIX_Audio) with a non-zero start position");  // !!! FIXME: should we just read off this many frames right now instead?
     }
 
@@ -2012,11 +6650,32 @@ bool MIX_PlayTrack(MIX_Track *track, SDL_PropertiesID options)
     track->total_fade_frames = (fade_in > 0) ? fade_in : 0;
     track->fade_frames = track->total_fade_frames;
     track->fade_direction = (fade_in > 0) ? 1 : 0;
+    track->fade_curve = fade_in_curve;
+    track->fade_out_curve = fade_out_curve;
     track->silence_frames = (append_silence_frames > 0) ? -append_silence_frames : 0;  // negative means "there is still actual audio data to play", positive means "we're done with actual data, feed silence now." Zero means no silence (left) to feed.
-    track->state = MIX_STATE_PLAYING;
     track->position = start_pos;
 
+    // if recording a batch, everything is ready to go, but MixerCallback sets it playing when the batch is applied.
+    //  Tracks that are already playing just restarted above, and decode-ahead needs to know it's playing now, so those don't wait.
+    MIX_Command *cmd = NULL;
+    if ((track->state != MIX_STATE_PLAYING) && (!da || (da->requested_frames == 0))) {
+        if (!QueueTrackCommand(track, MIX_COMMAND_PLAY, &cmd)) {
+            UnlockTrack(track);
+            UnlockDecodeAhead(da);
+            return false;
+        }
+    }
+    if (cmd) {
+        EndTrackCommand(track->mixer);
+    } else {
+        track->state = MIX_STATE_PLAYING;
+    }
+    track->virtualized = false;  // we just seeked the decoder, so it can go straight to being real if voice limiting allows it.
+
+    ResetDecodeAhead(track, false);  // the seek above already put the decoder where the worker should start.
+
     UnlockTrack(track);
+    UnlockDecodeAhead(da);
     return true;
 }
 
@@ -2061,6 +6720,7 @@ bool MIX_PlayAudio(MIX_Mixer *mixer, MIX_Audio *audio)
 
     // grab an existing fire-and-forget track from the available pool.
     LockMixer(mixer);
+    ReclaimFireAndForgetTracks(mixer);
     MIX_Track *track = mixer->fire_and_forget_pool;
     if (track) {
         mixer->fire_and_forget_pool = track->fire_and_forget_next;
@@ -2089,31 +6749,21 @@ bool MIX_PlayAudio(MIX_Mixer *mixer, MIX_Audio *audio)
     return retval;
 }
 
-static void StopTrack(MIX_Track *track, Sint64 fadeOut)
-{
-    LockTrack(track);
-    if (track->state != MIX_STATE_STOPPED) {
-        if (fadeOut <= 0) {  // stop immediately.
-            if (track->internal_stream) {
-                SDL_ClearAudioStream(track->internal_stream);  // make sure we don't leave old data hanging around.
-            }
-            TrackStopped(track);
-        } else {
-            track->total_fade_frames = fadeOut;
-            track->fade_frames = track->total_fade_frames;
-            track->fade_frames = fadeOut;
-            track->fade_direction = -1;
-        }
-    }
-    UnlockTrack(track);
-}
-
 bool MIX_StopTrack(MIX_Track *track, Sint64 fade_out_frames)
 {
     if (!CheckTrackParam(track)) {
         return false;
     }
 
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_STOP, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->data.fade_out_frames = fade_out_frames;
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
     StopTrack(track, fade_out_frames);
     return true;
 }
@@ -2166,20 +6816,20 @@ bool MIX_StopTag(MIX_Mixer *mixer, const char *tag, Sint64 fade_out_ms)
     return true;
 }
 
-static void PauseTrack(MIX_Track *track)
-{
-    LockTrack(track);
-    if (track->state == MIX_STATE_PLAYING) {
-        track->state = MIX_STATE_PAUSED;
-    }
-    UnlockTrack(track);
-}
-
 bool MIX_PauseTrack(MIX_Track *track)
 {
     if (!CheckTrackParam(track)) {
         return false;
     }
+
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_PAUSE, &cmd)) {
+        return false;
+    } else if (cmd) {
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
     PauseTrack(track);
     return true;
 }
@@ -2226,20 +6876,20 @@ bool MIX_PauseTag(MIX_Mixer *mixer, const char *tag)
     return true;
 }
 
-static void ResumeTrack(MIX_Track *track)
-{
-    LockTrack(track);
-    if (track->state == MIX_STATE_PAUSED) {
-        track->state = MIX_STATE_PLAYING;
-    }
-    UnlockTrack(track);
-}
-
 bool MIX_ResumeTrack(MIX_Track *track)
 {
     if (!CheckTrackParam(track)) {
         return false;
     }
+
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_RESUME, &cmd)) {
+        return false;
+    } else if (cmd) {
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
     ResumeTrack(track);
     return true;
 }
@@ -2308,6 +6958,124 @@ bool MIX_TrackPaused(MIX_Track *track)
     return retval;
 }
 
+bool MIX_SetMixerMaxVoices(MIX_Mixer *mixer, int voices)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if (voices < 0) {
+        return SDL_InvalidParamError("voices");
+    }
+
+    LockMixer(mixer);
+    mixer->max_voices = voices;
+    UnlockMixer(mixer);
+    return true;
+}
+
+int MIX_GetMixerMaxVoices(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1;
+    }
+
+    LockMixer(mixer);
+    const int retval = mixer->max_voices;
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_SetMixerAudibilityThreshold(MIX_Mixer *mixer, float threshold)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    LockMixer(mixer);
+    mixer->audibility_threshold = SDL_max(threshold, 0.0f);
+    UnlockMixer(mixer);
+    return true;
+}
+
+float MIX_GetMixerAudibilityThreshold(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1.0f;
+    }
+
+    LockMixer(mixer);
+    const float retval = mixer->audibility_threshold;
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_SetTrackPriority(MIX_Track *track, int priority)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    // voice ranking happens with the mixer locked, so change this under the same lock.
+    LockMixer(track->mixer);
+    track->priority = priority;
+    UnlockMixer(track->mixer);
+    return true;
+}
+
+int MIX_GetTrackPriority(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return 0;
+    }
+
+    LockMixer(track->mixer);
+    const int retval = track->priority;
+    UnlockMixer(track->mixer);
+    return retval;
+}
+
+bool MIX_SetTrackAudibilityThreshold(MIX_Track *track, float threshold)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    // voice ranking happens with the mixer locked, so change this under the same lock.
+    MIX_Mixer *mixer = track->mixer;
+    LockMixer(mixer);
+    const bool had_threshold = (track->audibility_threshold >= 0.0f);
+    track->audibility_threshold = (threshold >= 0.0f) ? threshold : -1.0f;  // any negative value means "use the mixer's."
+    if (had_threshold && (threshold < 0.0f)) {
+        mixer->num_track_audibility_thresholds--;
+    } else if (!had_threshold && (threshold >= 0.0f)) {
+        mixer->num_track_audibility_thresholds++;
+    }
+    UnlockMixer(mixer);
+    return true;
+}
+
+float MIX_GetTrackAudibilityThreshold(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return -1.0f;
+    }
+
+    LockMixer(track->mixer);
+    const float retval = track->audibility_threshold;
+    UnlockMixer(track->mixer);
+    return retval;
+}
+
+bool MIX_TrackVirtual(MIX_Track *track)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+    LockTrack(track);
+    const bool retval = (track->state == MIX_STATE_PLAYING) && track->virtualized;
+    UnlockTrack(track);
+    return retval;
+}
+
 bool MIX_SetTrackStoppedCallback(MIX_Track *track, MIX_TrackStoppedCallback cb, void *userdata)
 {
     if (!CheckTrackParam(track)) {
@@ -2326,37 +7094,297 @@ bool MIX_SetMasterGain(MIX_Mixer *mixer, float gain)
 {
     if (!CheckMixerParam(mixer)) {
         return false;
-    } else if (gain < 0.0f) {
-        return SDL_InvalidParamError("gain");
+    } else if (gain < 0.0f) {
+        return SDL_InvalidParamError("gain");
+    }
+
+    LockMixer(mixer);
+    mixer->gain = gain;
+    UnlockMixer(mixer);
+    return true;
+}
+
+float MIX_GetMasterGain(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return 1.0f;
+    }
+
+    LockMixer(mixer);
+    const float retval = mixer->gain;
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_GetMixerStats(MIX_Mixer *mixer, MIX_MixerStats *stats)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    // don't lock the mixer; just retry if MixerCallback published new stats while we were copying.
+    Uint32 sequence;
+    do {
+        sequence = SDL_GetAtomicU32(&mixer->stats_sequence);
+        SDL_MemoryBarrierAcquire();
+        SDL_copyp(stats, &mixer->published_stats);
+        SDL_MemoryBarrierAcquire();
+    } while ((sequence & 1) || (sequence != SDL_GetAtomicU32(&mixer->stats_sequence)));
+
+    return true;
+}
+
+bool MIX_SetMixerRenderThreads(MIX_Mixer *mixer, int threads)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    if (threads < 0) {
+        threads = SDL_GetNumLogicalCPUCores();
+    }
+    threads = SDL_min(threads, MIX_MAX_RENDER_THREADS + 1);
+
+    bool retval = true;
+    LockMixer(mixer);
+    if (threads != (mixer->num_render_threads + 1)) {
+        StopRenderThreads(mixer);
+        if (threads > 1) {
+            mixer->render_start = SDL_CreateSemaphore(0);
+            mixer->render_done = SDL_CreateSemaphore(0);
+            if (!mixer->render_start || !mixer->render_done) {
+                retval = false;
+            } else {
+                mixer->render_threads[0].mixer = mixer;
+                for (int i = 1; i < threads; i++) {
+                    MIX_RenderThread *rt = &mixer->render_threads[i];
+                    char name[32];
+                    SDL_snprintf(name, sizeof (name), "MIX_Render%d", i);
+                    rt->mixer = mixer;
+                    rt->thread = SDL_CreateThread(RenderThread, name, rt);
+                    if (!rt->thread) {
+                        retval = false;
+                        break;
+                    }
+                    mixer->num_render_threads++;
+                }
+            }
+
+            if (retval) {
+                retval = ReserveRealtimeBuffers(mixer);
+            }
+
+            if (!retval) {
+                StopRenderThreads(mixer);
+            }
+        }
+    }
+    UnlockMixer(mixer);
+
+    return retval;
+}
+
+int MIX_GetMixerRenderThreads(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1;
+    }
+
+    LockMixer(mixer);
+    const int retval = mixer->num_render_threads + 1;
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_SetMixerRealtimeSafe(MIX_Mixer *mixer, int max_frames)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if ((max_frames < 0) || (max_frames > MIX_REALTIME_MAX_FRAMES)) {
+        return SDL_InvalidParamError("max_frames");
+    }
+
+    LockMixer(mixer);
+    mixer->realtime_frames = max_frames;
+    const bool retval = ReserveRealtimeBuffers(mixer);
+    if (!retval) {
+        mixer->realtime_frames = 0;  // we can't promise anything, so don't pretend to.
+    }
+    UnlockMixer(mixer);
+
+    return retval;
+}
+
+int MIX_GetMixerRealtimeSafe(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1;
+    }
+
+    LockMixer(mixer);
+    const int retval = mixer->realtime_frames;
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_Update(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    // pull out any fire-and-forget tracks that are still holding on to their audio, so we can let go of it without the mixer locked.
+    MIX_Track *garbage = NULL;
+    LockMixer(mixer);
+    ReclaimFireAndForgetTracks(mixer);
+    MIX_Track **prev = &mixer->fire_and_forget_pool;
+    while (*prev) {
+        MIX_Track *track = *prev;
+        if (track->input_audio || track->input_stream) {
+            *prev = track->fire_and_forget_next;
+            track->fire_and_forget_next = garbage;
+            garbage = track;
+        } else {
+            prev = &track->fire_and_forget_next;
+        }
+    }
+    UnlockMixer(mixer);
+
+    if (!garbage) {
+        return true;  // nothing to do.
+    }
+
+    MIX_Track *last = NULL;
+    for (MIX_Track *track = garbage; track; track = track->fire_and_forget_next) {
+        MIX_SetTrackAudio(track, NULL);  // this shuts down the decoder and unrefs the MIX_Audio, maybe freeing it.
+        last = track;
+    }
+
+    // put them back in the pool, ready for MIX_PlayAudio to reuse.
+    LockMixer(mixer);
+    last->fire_and_forget_next = mixer->fire_and_forget_pool;
+    mixer->fire_and_forget_pool = garbage;
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+bool MIX_SetMixerNativeChannels(MIX_Mixer *mixer, bool enabled)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
     }
 
     LockMixer(mixer);
-    mixer->gain = gain;
+    if (mixer->native_channels != enabled) {
+        mixer->native_channels = enabled;
+        for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+            LockTrack(track);
+            SetTrackOutputStreamFormat(track, NULL);   // input stays the same, output might change channels.
+            UnlockTrack(track);
+        }
+    }
     UnlockMixer(mixer);
+
     return true;
 }
 
-float MIX_GetMasterGain(MIX_Mixer *mixer)
+bool MIX_GetMixerNativeChannels(MIX_Mixer *mixer)
 {
     if (!CheckMixerParam(mixer)) {
-        return 1.0f;
+        return false;
     }
 
     LockMixer(mixer);
-    const float retval = mixer->gain;
+    const bool retval = mixer->native_channels;
     UnlockMixer(mixer);
     return retval;
 }
 
-static bool SetTrackGain(MIX_Track *track, float gain)
+bool MIX_BeginBatch(MIX_Mixer *mixer)
 {
-    // don't have to LockTrack, as SDL_SetAudioStreamGain will do that.
-    //LockTrack(track);
-    const bool retval = SDL_SetAudioStreamGain(track->output_stream, gain);
-    //UnlockTrack(track);
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    const SDL_ThreadID thread = SDL_GetCurrentThreadID();
+
+    bool retval = true;
+    SDL_LockMutex(mixer->batch_lock);
+    if (mixer->batch_depth > 0) {
+        if (mixer->batch_thread != thread) {
+            retval = SDL_SetError("Another thread already has a batch open on this mixer");
+        } else {
+            mixer->batch_depth++;  // nested, just keep recording into the open batch.
+        }
+    } else {
+        // take back any batches MixerCallback is done with.
+        MIX_CommandBatch *spent = (MIX_CommandBatch *) SDL_SetAtomicPointer((void **) &mixer->spent_batches, NULL);
+        while (spent) {
+            MIX_CommandBatch *next = spent->next;
+            spent->next = mixer->free_batches;
+            mixer->free_batches = spent;
+            spent = next;
+        }
+
+        MIX_CommandBatch *batch = mixer->free_batches;
+        if (batch) {
+            mixer->free_batches = batch->next;
+        } else {
+            batch = (MIX_CommandBatch *) SDL_calloc(1, sizeof (*batch));
+        }
+
+        if (!batch) {
+            retval = false;
+        } else {
+            batch->num_commands = 0;
+            batch->next = NULL;
+            mixer->batch = batch;
+            mixer->batch_thread = thread;
+            mixer->batch_depth = 1;
+            SDL_SetAtomicPointer(&mixer->batch_owner, BatchOwner(thread));
+        }
+    }
+    SDL_UnlockMutex(mixer->batch_lock);
+
     return retval;
 }
 
+bool MIX_CommitBatch(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    SDL_LockMutex(mixer->batch_lock);
+    if ((mixer->batch_depth == 0) || (mixer->batch_thread != SDL_GetCurrentThreadID())) {
+        SDL_UnlockMutex(mixer->batch_lock);
+        return SDL_SetError("No batch open on this thread");
+    } else if (--mixer->batch_depth > 0) {
+        SDL_UnlockMutex(mixer->batch_lock);
+        return true;  // still nested in an outer batch, which will commit everything.
+    }
+
+    MIX_CommandBatch *batch = mixer->batch;
+    mixer->batch = NULL;
+    SDL_SetAtomicPointer(&mixer->batch_owner, NULL);
+    if (batch->num_commands == 0) {
+        batch->next = mixer->free_batches;  // nothing to do, just keep it for next time.
+        mixer->free_batches = batch;
+    } else {
+        MIX_CommandBatch *head;
+        do {
+            head = (MIX_CommandBatch *) SDL_GetAtomicPointer((void **) &mixer->committed_batches);
+            batch->next = head;
+        } while (!SDL_CompareAndSwapAtomicPointer((void **) &mixer->committed_batches, head, batch));
+    }
+    SDL_UnlockMutex(mixer->batch_lock);
+
+    return true;
+}
+
 bool MIX_SetTrackGain(MIX_Track *track, float gain)
 {
     if (!CheckTrackParam(track)) {
@@ -2367,6 +7395,15 @@ bool MIX_SetTrackGain(MIX_Track *track, float gain)
         gain = 0.0f;  // !!! FIXME: this clamps, but should it fail instead?
     }
 
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_GAIN, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->data.gain = gain;
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
     return SetTrackGain(track, gain);
 }
 
@@ -2413,15 +7450,6 @@ bool MIX_SetTagGain(MIX_Mixer *mixer, const char *tag, float gain)
     return true;
 }
 
-static bool SetTrackFrequencyRatio(MIX_Track *track, float ratio)
-{
-    // don't have to LockTrack, as SDL_SetAudioStreamFrequencyRatio will do that.
-    //LockTrack(track);
-    const bool retval = SDL_SetAudioStreamFrequencyRatio(track->output_stream, ratio);
-    //UnlockTrack(track);
-    return retval;
-}
-
 bool MIX_SetTrackFrequencyRatio(MIX_Track *track, float ratio)
 {
     if (!CheckTrackParam(track)) {
@@ -2430,6 +7458,15 @@ bool MIX_SetTrackFrequencyRatio(MIX_Track *track, float ratio)
 
     ratio = SDL_clamp(ratio, 0.01f, 100.0f);   // !!! FIXME: this clamps, but should it fail instead?
 
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_FREQUENCY_RATIO, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->data.ratio = ratio;
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
     return SetTrackFrequencyRatio(track, ratio);
 }
 
@@ -2439,10 +7476,9 @@ float MIX_GetTrackFrequencyRatio(MIX_Track *track)
         return 0.0f;
     }
 
-    // don't have to LockTrack, as SDL_GetAudioStreamFrequencyRatio will do that.
-    //LockTrack(track);
-    const float retval = SDL_GetAudioStreamFrequencyRatio(track->output_stream);
-    //UnlockTrack(track);
+    LockTrack(track);
+    const float retval = track->frequency_ratio;  // not the output stream's ratio, which has doppler in it, too.
+    UnlockTrack(track);
 
     return retval;
 }
@@ -2468,89 +7504,513 @@ bool MIX_SetTrackStereo(MIX_Track *track, const MIX_StereoGains *gains)
         return false;
     }
 
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_STEREO, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->clear = (gains == NULL);
+        if (gains) {
+            SDL_copyp(&cmd->data.stereo, gains);
+        }
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
+    SetTrackStereo(track, gains);
+    return true;
+}
+
+
+bool MIX_SetTrack3DPosition(MIX_Track *track, const MIX_Point3D *position)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    if (position) {
+        PrepareTrackBinaural(track);  // this might be applied in the mix, which can't allocate it.
+    }
+
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_3D_POSITION, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->clear = (position == NULL);
+        if (position) {
+            SDL_copyp(&cmd->data.position, position);
+        }
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
+    SetTrack3DPosition(track, position);
+    return true;
+}
+
+bool MIX_GetTrack3DPosition(MIX_Track *track, MIX_Point3D *position)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (!position) {
+        return SDL_InvalidParamError("position");
+    }
+
     LockTrack(track);
+    const float *tposition3d = track->position3d;
+    position->x = tposition3d[0];
+    position->y = tposition3d[1];
+    position->z = tposition3d[2];
+    UnlockTrack(track);
 
-    const bool wants_stereo = (gains != NULL);
-    const MIX_SpatializationMode new_mode = wants_stereo ? MIX_SPATIALIZATION_STEREO : MIX_SPATIALIZATION_NONE;
-    if (track->spatialization_mode != new_mode) {
-        track->spatialization_mode = new_mode;
-        SetTrackOutputStreamFormat(track, NULL);   // change output format to stereo (or back to normal) if necessary.
+    return true;
+
+}
+
+bool MIX_SetTrack3DVelocity(MIX_Track *track, const MIX_Point3D *velocity)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
     }
 
-    track->position3d[0] = track->position3d[1] = track->position3d[2] = 0.0f;
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_3D_VELOCITY, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->clear = (velocity == NULL);
+        if (velocity) {
+            SDL_copyp(&cmd->data.position, velocity);
+        }
+        EndTrackCommand(track->mixer);
+        return true;
+    }
 
-    if (wants_stereo) {
-        const float left = SDL_max(0.0f, gains->left);
-        const float right = SDL_max(0.0f, gains->right);
-        if (track->mixer->spec.channels == 1) {  // mono output
-            track->spatialization_speakers[0] = track->spatialization_speakers[1] = 0;
-            track->spatialization_panning[0] = left * 0.5f;
-            track->spatialization_panning[1] = right * 0.5f;
-        } else {
-            track->spatialization_speakers[0] = 0;
-            track->spatialization_speakers[1] = 1;
-            track->spatialization_panning[0] = left;
-            track->spatialization_panning[1] = right;
+    SetTrack3DVelocity(track, velocity);
+    return true;
+}
+
+bool MIX_GetTrack3DVelocity(MIX_Track *track, MIX_Point3D *velocity)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if (!velocity) {
+        return SDL_InvalidParamError("velocity");
+    }
+
+    LockTrack(track);
+    velocity->x = track->velocity3d[0];
+    velocity->y = track->velocity3d[1];
+    velocity->z = track->velocity3d[2];
+    UnlockTrack(track);
+
+    return true;
+}
+
+bool MIX_SetTrackOcclusion(MIX_Track *track, float occlusion, float obstruction)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_OCCLUSION, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->data.occlusion.occlusion = occlusion;
+        cmd->data.occlusion.obstruction = obstruction;
+        EndTrackCommand(track->mixer);
+        return true;
+    }
+
+    SetTrackOcclusion(track, occlusion, obstruction);
+    return true;
+}
+
+bool MIX_GetTrackOcclusion(MIX_Track *track, float *occlusion, float *obstruction)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    }
+
+    LockTrack(track);
+    if (occlusion) {
+        *occlusion = track->occlusion;
+    }
+    if (obstruction) {
+        *obstruction = track->obstruction;
+    }
+    UnlockTrack(track);
+
+    return true;
+}
+
+bool MIX_SetTracks3DPositions(MIX_Track **tracks, const MIX_Point3D *positions, int count)
+{
+    if (count < 0) {
+        return SDL_InvalidParamError("count");
+    } else if (count == 0) {
+        return true;  // nothing to do.
+    } else if (!tracks) {
+        return SDL_InvalidParamError("tracks");
+    } else if (!positions) {
+        return SDL_InvalidParamError("positions");
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!CheckTrackParam(tracks[i])) {
+            return false;
+        } else if (tracks[i]->mixer != tracks[0]->mixer) {
+            return SDL_SetError("All tracks must belong to the same mixer");
+        }
+    }
+
+    MIX_Mixer *mixer = tracks[0]->mixer;
+
+    for (int i = 0; i < count; i++) {
+        PrepareTrackBinaural(tracks[i]);  // these might be applied in the mix, which can't allocate them.
+    }
+
+    // if this thread has a batch open, record these with the rest of it, like MIX_SetTrack3DPosition would.
+    MIX_Command *cmds;
+    if (!QueueTrackCommands(mixer, count, &cmds)) {
+        return false;
+    } else if (cmds) {
+        for (int i = 0; i < count; i++) {
+            cmds[i].type = MIX_COMMAND_3D_POSITION;
+            cmds[i].track = tracks[i];
+            SDL_copyp(&cmds[i].data.position, &positions[i]);
+        }
+        EndTrackCommand(mixer);
+        return true;
+    }
+
+    LockMixer(mixer);
+    MIX_SpatialBlock *block = &mixer->spatial_block;
+    if (!GrowSpatialBlock(block, block->count + count)) {
+        UnlockMixer(mixer);
+        return false;
+    }
+
+    for (int i = 0; i < count; i++) {
+        MIX_Track *track = tracks[i];
+        LockTrack(track);
+        if (track->spatialization_mode != MIX_SPATIALIZATION_3D) {
+            track->spatialization_mode = MIX_SPATIALIZATION_3D;
+            SetTrackOutputStreamFormat(track, NULL);   // change output format to mono if necessary.
+        }
+        track->position3d[0] = positions[i].x;
+        track->position3d[1] = positions[i].y;
+        track->position3d[2] = positions[i].z;
+
+        int slot = FindSpatialBlockSlot(block, track);  // if it's already waiting for the next mix, just replace it.
+        if (slot < 0) {
+            slot = block->count++;
+            track->spatial_block_slot = slot;
+        }
+        StoreSpatialBlockSlot(block, slot, track);
+        UnlockTrack(track);
+    }
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+bool MIX_SetTracks3DVelocities(MIX_Track **tracks, const MIX_Point3D *velocities, int count)
+{
+    if (count < 0) {
+        return SDL_InvalidParamError("count");
+    } else if (count == 0) {
+        return true;  // nothing to do.
+    } else if (!tracks) {
+        return SDL_InvalidParamError("tracks");
+    } else if (!velocities) {
+        return SDL_InvalidParamError("velocities");
+    }
+
+    for (int i = 0; i < count; i++) {
+        if (!CheckTrackParam(tracks[i])) {
+            return false;
+        } else if (tracks[i]->mixer != tracks[0]->mixer) {
+            return SDL_SetError("All tracks must belong to the same mixer");
+        }
+    }
+
+    MIX_Mixer *mixer = tracks[0]->mixer;
+
+    // if this thread has a batch open, record these with the rest of it, like MIX_SetTrack3DVelocity would.
+    MIX_Command *cmds;
+    if (!QueueTrackCommands(mixer, count, &cmds)) {
+        return false;
+    } else if (cmds) {
+        for (int i = 0; i < count; i++) {
+            cmds[i].type = MIX_COMMAND_3D_VELOCITY;
+            cmds[i].track = tracks[i];
+            SDL_copyp(&cmds[i].data.position, &velocities[i]);
+        }
+        EndTrackCommand(mixer);
+        return true;
+    }
+
+    LockMixer(mixer);
+    MIX_SpatialBlock *block = &mixer->spatial_block;
+    if (!GrowSpatialBlock(block, block->count + count)) {
+        UnlockMixer(mixer);
+        return false;
+    }
+
+    // 3D tracks go in the spatial block, so their doppler is calculated all at once at the start of the next mix.
+    for (int i = 0; i < count; i++) {
+        MIX_Track *track = tracks[i];
+        LockTrack(track);
+        track->velocity3d[0] = velocities[i].x;
+        track->velocity3d[1] = velocities[i].y;
+        track->velocity3d[2] = velocities[i].z;
+        if (track->spatialization_mode == MIX_SPATIALIZATION_3D) {
+            int slot = FindSpatialBlockSlot(block, track);  // if its position is already waiting for the next mix, just update that.
+            if (slot < 0) {
+                slot = block->count++;
+                track->spatial_block_slot = slot;
+            }
+            StoreSpatialBlockSlot(block, slot, track);
+        }
+        UnlockTrack(track);
+    }
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+// normalize `v` in place; returns false if it has no length (or isn't a number at all).
+static bool NormalizeListenerVector(float *v)
+{
+    const float len = SDL_sqrtf((v[0] * v[0]) + (v[1] * v[1]) + (v[2] * v[2]));
+    if (!(len > 0.0f)) {
+        return false;
+    }
+    v[0] /= len;
+    v[1] /= len;
+    v[2] /= len;
+    return true;
+}
+
+bool MIX_SetListener3D(MIX_Mixer *mixer, const MIX_Point3D *position, const MIX_Point3D *orientation, const MIX_Point3D *velocity)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    MIX_Listener3D listener;
+    MIX_InitListener3D(&listener);
+
+    if (position) {
+        listener.position[0] = position->x;
+        listener.position[1] = position->y;
+        listener.position[2] = position->z;
+    }
+
+    if (orientation) {
+        float *at = listener.at;
+        float *up = listener.up;
+        at[0] = orientation[0].x;
+        at[1] = orientation[0].y;
+        at[2] = orientation[0].z;
+        up[0] = orientation[1].x;
+        up[1] = orientation[1].y;
+        up[2] = orientation[1].z;
+
+        // the spatializer projects sources onto the plane `up` is perpendicular to, so make sure `up` really is
+        //  perpendicular to `at` (Gram-Schmidt), and that both are unit length.
+        if (!NormalizeListenerVector(at)) {
+            return SDL_InvalidParamError("orientation");
         }
+        const float d = (at[0] * up[0]) + (at[1] * up[1]) + (at[2] * up[2]);
+        up[0] -= d * at[0];
+        up[1] -= d * at[1];
+        up[2] -= d * at[2];
+        if (!NormalizeListenerVector(up)) {
+            return SDL_InvalidParamError("orientation");  // `up` was zero, or parallel to `at`.
+        }
+    }
+
+    if (velocity) {
+        listener.velocity[0] = velocity->x;
+        listener.velocity[1] = velocity->y;
+        listener.velocity[2] = velocity->z;
+    }
+
+    LockMixer(mixer);
+    BeginSpatialChange(mixer);
+    SDL_copyp(&mixer->listener3d, &listener);
+    EndSpatialChange(mixer);
+    mixer->listener3d_changed = true;  // the next mix will respatialize everything at once.
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+bool MIX_GetListener3D(MIX_Mixer *mixer, MIX_Point3D *position, MIX_Point3D *orientation, MIX_Point3D *velocity)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    }
+
+    LockMixer(mixer);
+    const MIX_Listener3D *listener = &mixer->listener3d;
+    if (position) {
+        position->x = listener->position[0];
+        position->y = listener->position[1];
+        position->z = listener->position[2];
+    }
+    if (orientation) {
+        orientation[0].x = listener->at[0];
+        orientation[0].y = listener->at[1];
+        orientation[0].z = listener->at[2];
+        orientation[1].x = listener->up[0];
+        orientation[1].y = listener->up[1];
+        orientation[1].z = listener->up[2];
+    }
+    if (velocity) {
+        velocity->x = listener->velocity[0];
+        velocity->y = listener->velocity[1];
+        velocity->z = listener->velocity[2];
+    }
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+bool MIX_SetMixerSpeedOfSound(MIX_Mixer *mixer, float speed)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if (!(speed >= 0.0f)) {
+        return SDL_InvalidParamError("speed");
     }
 
-    UnlockTrack(track);
+    LockMixer(mixer);
+    if (mixer->speed_of_sound != speed) {
+        BeginSpatialChange(mixer);
+        mixer->speed_of_sound = speed;
+        EndSpatialChange(mixer);
+        mixer->listener3d_changed = true;  // the next mix will recalculate everything's doppler at once.
+    }
+    UnlockMixer(mixer);
 
     return true;
-
 }
 
+float MIX_GetMixerSpeedOfSound(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1.0f;
+    }
 
-bool MIX_SetTrack3DPosition(MIX_Track *track, const MIX_Point3D *position)
+    LockMixer(mixer);
+    const float retval = mixer->speed_of_sound;
+    UnlockMixer(mixer);
+    return retval;
+}
+
+bool MIX_SetMixerHRTF(MIX_Mixer *mixer, const MIX_HRIR *hrirs, int num_hrirs, int frames, int freq)
 {
-    if (!CheckTrackParam(track)) {
+    if (!CheckMixerParam(mixer)) {
         return false;
     }
 
-    LockTrack(track);
+    MIX_HRTF *hrtf = NULL;
+    if (hrirs) {
+        if (num_hrirs <= 0) {
+            return SDL_InvalidParamError("num_hrirs");
+        } else if ((frames <= 0) || (frames > MIX_HRTF_MAX_FRAMES)) {
+            return SDL_InvalidParamError("frames");
+        } else if (freq <= 0) {
+            return SDL_InvalidParamError("freq");
+        }
+        for (int i = 0; i < num_hrirs; i++) {
+            if (!hrirs[i].left || !hrirs[i].right) {
+                return SDL_InvalidParamError("hrirs");
+            }
+        }
 
-    const bool wants_spatialization = (position != NULL);
-    const MIX_SpatializationMode new_mode = wants_spatialization ? MIX_SPATIALIZATION_3D : MIX_SPATIALIZATION_NONE;
-    const bool toggling = (track->spatialization_mode != new_mode);
-    if (toggling) {
-        track->spatialization_mode = new_mode;
-        SetTrackOutputStreamFormat(track, NULL);   // change output format to stereo (or back to normal) if necessary.
+        // build this before locking the mixer; it's a lot of work.
+        SDL_AudioSpec spec;
+        LockMixer(mixer);
+        SDL_copyp(&spec, &mixer->spec);
+        UnlockMixer(mixer);
+
+        hrtf = MIX_CreateHRTF(hrirs, num_hrirs, frames, freq, spec.freq);
+        if (!hrtf) {
+            return false;
+        }
     }
 
-    if (!wants_spatialization) {
-        track->position3d[0] = track->position3d[1] = track->position3d[2] = 0.0f;
-    } else {
-        float *tposition3d = track->position3d;
-        if (toggling || ((tposition3d[0] != position->x) || (tposition3d[2] != position->y) || (tposition3d[2] != position->z))) {
-            tposition3d[0] = position->x;
-            tposition3d[1] = position->y;
-            tposition3d[2] = position->z;
-            MIX_Spatialize(&track->mixer->vbap2d, tposition3d, track->spatialization_panning, track->spatialization_speakers);
+    LockMixer(mixer);
+    MIX_HRTF *old_hrtf = mixer->hrtf;
+    mixer->hrtf = hrtf;
+    for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+        LockTrack(track);
+        const bool wants_binaural = track->binaural || (track->spatialization_mode == MIX_SPATIALIZATION_3D);
+        if (track->binaural) {  // sized for the old HRTF.
+            MIX_DestroyBinauralState(track->binaural);
+            track->binaural = NULL;
         }
+        if (wants_binaural) {
+            CreateTrackBinaural(mixer, track);  // build the new one here, so the mix never has to allocate it.
+        }
+        UnlockTrack(track);
     }
+    for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+        FreeGroupAmbisonicBinaural(group);
+        CreateGroupAmbisonicBinaural(mixer, group);
+    }
+    UnlockMixer(mixer);
 
-    UnlockTrack(track);
+    MIX_DestroyHRTF(old_hrtf);
 
     return true;
 }
 
-bool MIX_GetTrack3DPosition(MIX_Track *track, MIX_Point3D *position)
+bool MIX_SetMixerAmbisonicOrder(MIX_Mixer *mixer, int order)
 {
-    if (!CheckTrackParam(track)) {
+    if (!CheckMixerParam(mixer)) {
         return false;
-    } else if (!position) {
-        return SDL_InvalidParamError("position");
+    } else if ((order < 0) || (order > MIX_AMBISONIC_MAX_ORDER)) {
+        return SDL_InvalidParamError("order");
     }
 
-    LockTrack(track);
-    const float *tposition3d = track->position3d;
-    position->x = tposition3d[0];
-    position->y = tposition3d[1];
-    position->z = tposition3d[2];
-    UnlockTrack(track);
+    bool retval = true;
+    LockMixer(mixer);
+    if (mixer->ambisonic_order != order) {
+        const int old_order = mixer->ambisonic_order;
+        mixer->ambisonic_order = order;
+        if (!ReserveRealtimeBuffers(mixer)) {  // a bigger order needs bigger buses.
+            mixer->ambisonic_order = old_order;
+            retval = false;
+        } else {
+            BuildAmbisonicDecoders(mixer);
+            for (MIX_Group *group = mixer->all_groups; group; group = group->next) {
+                FreeGroupAmbisonicBinaural(group);  // start the virtual speakers fresh.
+                CreateGroupAmbisonicBinaural(mixer, group);
+            }
+            for (MIX_Track *track = mixer->all_tracks; track; track = track->next) {
+                track->mixed_ambisonic_valid = false;  // don't ramp from gains for a different order.
+            }
+        }
+    }
+    UnlockMixer(mixer);
 
-    return true;
+    return retval;
+}
+
+int MIX_GetMixerAmbisonicOrder(MIX_Mixer *mixer)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1;
+    }
 
+    LockMixer(mixer);
+    const int order = mixer->ambisonic_order;
+    UnlockMixer(mixer);
+    return order;
 }
 
 bool MIX_SetPostMixCallback(MIX_Mixer *mixer, MIX_PostMixCallback cb, void *userdata)
@@ -2605,6 +8065,11 @@ MIX_Group *MIX_CreateGroup(MIX_Mixer *mixer)
     }
 
     group->mixer = mixer;
+    group->effects.pending.gain = 1.0f;
+    group->effects.target.gain = 1.0f;
+    group->effects.gain = 1.0f;
+    group->effects.compressor_gain = 1.0f;
+    group->effects.limiter_gain = 1.0f;
 
     LockMixer(mixer);
     group->next = mixer->all_groups;
@@ -2612,8 +8077,15 @@ MIX_Group *MIX_CreateGroup(MIX_Mixer *mixer)
         mixer->all_groups->prev = group;
     }
     mixer->all_groups = group;
+    CreateGroupAmbisonicBinaural(mixer, group);
+    const bool reserved = ReserveRealtimeBuffers(mixer);
     UnlockMixer(mixer);
 
+    if (!reserved) {
+        MIX_DestroyGroup(group);
+        return NULL;
+    }
+
     return group;
 }
 
@@ -2640,6 +8112,7 @@ void MIX_DestroyGroup(MIX_Group *group)
         next = track->group_next;  // track->group_next will change in SetTrackGroup, so save it off.
         MIX_SetTrackGroup(track, NULL);
     }
+    FreeGroupAmbisonicBinaural(group);
     UnlockMixer(mixer);
 
     SDL_DestroyProperties(group->props);
@@ -2717,6 +8190,319 @@ bool MIX_SetGroupPostMixCallback(MIX_Group *group, MIX_GroupMixCallback cb, void
     return true;
 }
 
+// Group effect settings don't lock the mixer, so they never wait for a mix to finish; see MIX_GroupEffects.
+static MIX_GroupEffectParams *BeginGroupEffectsChange(MIX_Group *group)
+{
+    SDL_LockSpinlock(&group->effects.writer_lock);
+    SDL_AddAtomicInt(&group->effects.serial, 1);  // now it's odd, so the audio thread leaves `pending` alone.
+    return &group->effects.pending;
+}
+
+static void EndGroupEffectsChange(MIX_Group *group)
+{
+    SDL_AddAtomicInt(&group->effects.serial, 1);  // even again, and different, so the audio thread picks it up next mix.
+    SDL_UnlockSpinlock(&group->effects.writer_lock);
+}
+
+bool MIX_SetGroupEQBand(MIX_Group *group, int band, const MIX_EQBand *params)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if ((band < 0) || (band >= MIX_MAX_EQ_BANDS)) {
+        return SDL_InvalidParamError("band");
+    } else if (params && ((params->type < MIX_EQ_NONE) || (params->type > MIX_EQ_HIGHPASS) || (params->frequency <= 0.0f) || (params->q <= 0.0f))) {
+        return SDL_InvalidParamError("params");
+    }
+
+    MIX_GroupEffectParams *pending = BeginGroupEffectsChange(group);
+    if (params) {
+        SDL_copyp(&pending->eq[band], params);
+    } else {
+        pending->eq[band].type = MIX_EQ_NONE;
+    }
+    EndGroupEffectsChange(group);
+
+    return true;
+}
+
+bool MIX_GetGroupEQBand(MIX_Group *group, int band, MIX_EQBand *params)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if ((band < 0) || (band >= MIX_MAX_EQ_BANDS)) {
+        return SDL_InvalidParamError("band");
+    } else if (!params) {
+        return SDL_InvalidParamError("params");
+    }
+
+    SDL_LockSpinlock(&group->effects.writer_lock);
+    SDL_copyp(params, &group->effects.pending.eq[band]);
+    SDL_UnlockSpinlock(&group->effects.writer_lock);
+
+    return true;
+}
+
+bool MIX_SetGroupCompressor(MIX_Group *group, const MIX_Compressor *params)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if (params && ((params->ratio < 1.0f) || (params->attack_ms < 0.0f) || (params->release_ms < 0.0f))) {
+        return SDL_InvalidParamError("params");
+    }
+
+    MIX_GroupEffectParams *pending = BeginGroupEffectsChange(group);
+    pending->compressor_enabled = (params != NULL);
+    if (params) {
+        SDL_copyp(&pending->compressor, params);
+    }
+    EndGroupEffectsChange(group);
+
+    return true;
+}
+
+bool MIX_GetGroupCompressor(MIX_Group *group, MIX_Compressor *params)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if (!params) {
+        return SDL_InvalidParamError("params");
+    }
+
+    SDL_LockSpinlock(&group->effects.writer_lock);
+    const bool enabled = group->effects.pending.compressor_enabled;
+    if (enabled) {
+        SDL_copyp(params, &group->effects.pending.compressor);
+    }
+    SDL_UnlockSpinlock(&group->effects.writer_lock);
+
+    return enabled ? true : SDL_SetError("Group has no compressor");
+}
+
+bool MIX_SetGroupLimiter(MIX_Group *group, const MIX_Limiter *params)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if (params && ((params->lookahead_ms < 0.0f) || (params->release_ms < 0.0f))) {
+        return SDL_InvalidParamError("params");
+    }
+
+    MIX_GroupEffectParams *pending = BeginGroupEffectsChange(group);
+    pending->limiter_enabled = (params != NULL);
+    if (params) {
+        SDL_copyp(&pending->limiter, params);
+    }
+    EndGroupEffectsChange(group);
+
+    return true;
+}
+
+bool MIX_GetGroupLimiter(MIX_Group *group, MIX_Limiter *params)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if (!params) {
+        return SDL_InvalidParamError("params");
+    }
+
+    SDL_LockSpinlock(&group->effects.writer_lock);
+    const bool enabled = group->effects.pending.limiter_enabled;
+    if (enabled) {
+        SDL_copyp(params, &group->effects.pending.limiter);
+    }
+    SDL_UnlockSpinlock(&group->effects.writer_lock);
+
+    return enabled ? true : SDL_SetError("Group has no limiter");
+}
+
+bool MIX_SetGroupGain(MIX_Group *group, float gain)
+{
+    if (!CheckGroupParam(group)) {
+        return false;
+    } else if (gain < 0.0f) {
+        return SDL_InvalidParamError("gain");
+    }
+
+    MIX_GroupEffectParams *pending = BeginGroupEffectsChange(group);
+    pending->gain = gain;
+    EndGroupEffectsChange(group);
+
+    return true;
+}
+
+float MIX_GetGroupGain(MIX_Group *group)
+{
+    if (!CheckGroupParam(group)) {
+        return 1.0f;
+    }
+
+    SDL_LockSpinlock(&group->effects.writer_lock);
+    const float gain = group->effects.pending.gain;
+    SDL_UnlockSpinlock(&group->effects.writer_lock);
+
+    return gain;
+}
+
+bool MIX_SetTrackSend(MIX_Track *track, int bus, float level)
+{
+    if (!CheckTrackParam(track)) {
+        return false;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        return SDL_InvalidParamError("bus");
+    } else if (level < 0.0f) {
+        return SDL_InvalidParamError("level");
+    }
+
+    // the first send makes the mixer keep send buffers from then on. sends_enabled never goes back to false, so only check it unlocked once it's set.
+    MIX_Mixer *mixer = track->mixer;
+    if ((level > 0.0f) && !mixer->sends_enabled) {
+        LockMixer(mixer);
+        bool okay = true;
+        if (!mixer->sends_enabled) {
+            mixer->sends_enabled = true;
+            okay = ReserveRealtimeBuffers(mixer);
+            if (!okay) {
+                mixer->sends_enabled = false;
+            }
+        }
+        UnlockMixer(mixer);
+        if (!okay) {
+            return false;
+        }
+    }
+
+    MIX_Command *cmd;
+    if (!QueueTrackCommand(track, MIX_COMMAND_SEND, &cmd)) {
+        return false;
+    } else if (cmd) {
+        cmd->data.send.bus = bus;
+        cmd->data.send.level = level;
+        EndTrackCommand(mixer);
+        return true;
+    }
+
+    SetTrackSend(track, bus, level);
+    return true;
+}
+
+float MIX_GetTrackSend(MIX_Track *track, int bus)
+{
+    if (!CheckTrackParam(track)) {
+        return -1.0f;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        SDL_InvalidParamError("bus");
+        return -1.0f;
+    }
+
+    LockTrack(track);
+    const float level = track->send_levels[bus];
+    UnlockTrack(track);
+
+    return level;
+}
+
+bool MIX_SetSendBusGain(MIX_Mixer *mixer, int bus, float gain)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        return SDL_InvalidParamError("bus");
+    } else if (gain < 0.0f) {
+        return SDL_InvalidParamError("gain");
+    }
+
+    LockMixer(mixer);
+    mixer->send_buses[bus].gain = gain;
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+float MIX_GetSendBusGain(MIX_Mixer *mixer, int bus)
+{
+    if (!CheckMixerParam(mixer)) {
+        return -1.0f;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        SDL_InvalidParamError("bus");
+        return -1.0f;
+    }
+
+    LockMixer(mixer);
+    const float gain = mixer->send_buses[bus].gain;
+    UnlockMixer(mixer);
+
+    return gain;
+}
+
+bool MIX_SetSendBusPostMixCallback(MIX_Mixer *mixer, int bus, MIX_SendBusMixCallback cb, void *userdata)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        return SDL_InvalidParamError("bus");
+    }
+
+    LockMixer(mixer);
+    mixer->send_buses[bus].callback = cb;
+    mixer->send_buses[bus].callback_userdata = userdata;
+    UnlockMixer(mixer);
+
+    return true;
+}
+
+bool MIX_SetSendBusReverb(MIX_Mixer *mixer, int bus, const MIX_Reverb *params)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        return SDL_InvalidParamError("bus");
+    } else if (params && !(params->decay_time > 0.0f)) {
+        return SDL_InvalidParamError("params->decay_time");
+    } else if (params && (params->predelay_ms < 0.0f)) {
+        return SDL_InvalidParamError("params->predelay_ms");
+    }
+
+    MIX_ReverbState *discard = NULL;
+    bool retval = true;
+
+    LockMixer(mixer);
+    MIX_SendBus *send_bus = &mixer->send_buses[bus];
+    if (!params) {
+        discard = send_bus->reverb;
+        send_bus->reverb = NULL;
+    } else if (send_bus->reverb) {
+        SDL_copyp(&send_bus->reverb->params, params);
+        send_bus->reverb->changed = true;
+    } else {
+        send_bus->reverb = CreateReverbState(params, mixer->spec.freq);  // all the memory it will need, so MixerCallback never allocates for it.
+        retval = (send_bus->reverb != NULL);
+    }
+    UnlockMixer(mixer);
+
+    DestroyReverbState(discard);
+    return retval;
+}
+
+bool MIX_GetSendBusReverb(MIX_Mixer *mixer, int bus, MIX_Reverb *params)
+{
+    if (!CheckMixerParam(mixer)) {
+        return false;
+    } else if ((bus < 0) || (bus >= MIX_MAX_SEND_BUSES)) {
+        return SDL_InvalidParamError("bus");
+    } else if (!params) {
+        return SDL_InvalidParamError("params");
+    }
+
+    LockMixer(mixer);
+    const MIX_ReverbState *reverb = mixer->send_buses[bus].reverb;
+    const bool enabled = (reverb != NULL);
+    if (enabled) {
+        SDL_copyp(params, &reverb->params);
+    }
+    UnlockMixer(mixer);
+
+    return enabled ? true : SDL_SetError("Send bus has no reverb");
+}
+
 MIX_AudioDecoder * MIX_CreateAudioDecoder_IO(SDL_IOStream *io, bool closeio, SDL_PropertiesID props)
 {
     if (!CheckInitialized()) {
@@ -25,6 +25,13 @@
 #endif
 #if SDL_MIXER_FORCE_SCALAR_FALLBACK
 #  define SDL_DISABLE_SSE
+#  define SDL_DISABLE_SSE2
+#  define SDL_DISABLE_SSE3
+#  define SDL_DISABLE_SSE4_1
+#  define SDL_DISABLE_SSE4_2
+#  define SDL_DISABLE_AVX
+#  define SDL_DISABLE_AVX2
+#  define SDL_DISABLE_AVX512F
 #  define SDL_DISABLE_NEON
 #endif
 
@@ -47,6 +54,10 @@
 #define MIX_HasSSE 1
 #endif
 
+#if defined(SDL_AVX2_INTRINSICS)   /* this is still fairly new, so check at runtime. */
+extern bool MIX_HasAVX2;
+#endif
+
 #if defined(SDL_NEON_INTRINSICS)
 #if SDL_MIXER_NEED_SCALAR_FALLBACK
 extern bool MIX_HasNEON;
@@ -69,20 +80,108 @@ typedef enum MIX_SpatializationMode
 #define MIX_VBAP2D_MAX_RESOLUTION 3600
 #define MIX_VBAP2D_MAX_SPEAKER_COUNT 8   // original code had 64, assumed you'd use less, but we're hardcoding our current maximum.
 #define MIX_VBAP2D_RESOLUTION 36   // 10 degrees per division
+#define MIX_VBAP2D_GAIN_TABLE_RESOLUTION 720   // half a degree per entry. Must be a multiple of MIX_VBAP2D_RESOLUTION, and no more than MIX_VBAP2D_MAX_RESOLUTION.
 
 typedef struct MIX_VBAP2D_Bucket { Uint8 speaker_pair; } MIX_VBAP2D_Bucket;
 typedef struct MIX_VBAP2D_Matrix { float a00, a01, a10, a11; } MIX_VBAP2D_Matrix;
 
+// Precalculated panning from one table angle to the next. Both ends use the same speaker pair, so gains can be interpolated.
+typedef struct MIX_VBAP2D_GainEntry
+{
+    float gains[2];   // at this entry's angle.
+    float deltas[2];  // how much the gains change by the next entry's angle.
+    Uint8 speakers[2];  // SDL channels.
+} MIX_VBAP2D_GainEntry;
+
 typedef struct MIX_VBAP2D
 {
     int speaker_count;
     MIX_VBAP2D_Bucket buckets[MIX_VBAP2D_RESOLUTION];
     MIX_VBAP2D_Matrix matrices[MIX_VBAP2D_MAX_SPEAKER_COUNT-1];   // the upper ones all have an LFE channel, which we don't track here, so minus one.
+    MIX_VBAP2D_GainEntry gain_table[MIX_VBAP2D_GAIN_TABLE_RESOLUTION];  // built from the buckets and matrices, so spatializing is just a lookup.
 } MIX_VBAP2D;
 
 void MIX_VBAP2D_Init(MIX_VBAP2D *vbap2d, int speaker_count);
 
 
+// Ambisonic bus: 3D tracks can be encoded into horizontal-only (circular harmonic) B-format instead of being panned
+//  to speakers one at a time. Each group sums its tracks there, and decodes the sum to the speakers (or binaurally) once.
+// Channel 0 is W, then cos(m*azimuth) and sin(m*azimuth) for each order m, with azimuth counterclockwise from the front.
+#define MIX_AMBISONIC_MAX_ORDER 3
+#define MIX_AMBISONIC_MAX_CHANNELS ((MIX_AMBISONIC_MAX_ORDER * 2) + 1)
+#define MIX_AMBISONIC_MAX_VIRTUAL_SPEAKERS ((MIX_AMBISONIC_MAX_ORDER * 2) + 2)
+
+typedef struct MIX_AmbisonicBus
+{
+    float *buffer;   // planar: each channel is `frames` floats, one after another.
+    int frames;
+    bool used;       // false if nothing was encoded since the buffer was cleared.
+} MIX_AmbisonicBus;
+
+// Fill in `order * 2 + 1` channel gains to encode a source at `radians` from the listener (the spatializer's convention), scaled by `gain`.
+void MIX_AmbisonicEncodingGains(int order, float gain, float radians, float *gains);
+
+// Fill in a decoding matrix for the mixer's speakers: `speaker_count` rows of MIX_AMBISONIC_MAX_CHANNELS gains, in SDL's channel order.
+void MIX_BuildAmbisonicDecoder(int order, int speaker_count, float *matrix);
+
+// Fill in a decoding matrix for evenly spaced virtual speakers, to be rendered binaurally, and each one's angle in
+//  the spatializer's convention. `matrix` needs room for MIX_AMBISONIC_MAX_VIRTUAL_SPEAKERS rows. Returns the number of speakers.
+int MIX_BuildAmbisonicVirtualSpeakers(int order, float *matrix, float *radians);
+
+
+// Binaural rendering for stereo (headphone) output: 3D tracks are convolved with head-related impulse responses,
+//  using uniformly partitioned overlap-save FFT convolution.
+#define MIX_HRTF_PARTITION_FRAMES 128   // convolution block size. This is also how much latency binaural rendering adds.
+#define MIX_HRTF_FFT_SIZE (MIX_HRTF_PARTITION_FRAMES * 2)
+#define MIX_HRTF_BINS (MIX_HRTF_PARTITION_FRAMES + 1)   // a real signal's spectrum only needs the bins up to Nyquist.
+#define MIX_HRTF_AZIMUTH_BUCKETS 72     // 5 degrees per bucket.
+#define MIX_HRTF_MAX_FRAMES 4096        // longest impulse response we accept, after resampling.
+
+typedef struct MIX_HRTF
+{
+    int freq;              // sample rate the filters were built for.
+    int num_partitions;
+    int num_filters;
+    int bucket_filters[MIX_HRTF_AZIMUTH_BUCKETS];  // which filter to use for each direction.
+    float *filters;        // num_filters * 2 ears * num_partitions partitions * (MIX_HRTF_BINS real, then MIX_HRTF_BINS imaginary).
+    float fft_cos[MIX_HRTF_FFT_SIZE / 2];
+    float fft_sin[MIX_HRTF_FFT_SIZE / 2];
+    int fft_bitrev[MIX_HRTF_FFT_SIZE];
+    // a copy of what the app gave us, so we can rebuild the filters if the mixer's sample rate changes.
+    MIX_HRIR *hrirs;
+    float *hrir_data;
+    int num_hrirs;
+    int hrir_frames;
+    int hrir_freq;
+} MIX_HRTF;
+
+// Per-track binaural state. It's only touched by whatever thread is mixing the track.
+typedef struct MIX_BinauralState
+{
+    const MIX_HRTF *hrtf;  // what this state was sized for.
+    bool primed;           // false if everything needs to be cleared before use.
+    int fill;              // sample frames collected in the current partition (and frames of `output` already mixed).
+    int fdl_head;          // newest spectrum in the frequency-domain delay line.
+    int filter;            // filter used for the last partition, so we can crossfade when it changes. -1 if none yet.
+    float *fdl;            // num_partitions spectra of past input (MIX_HRTF_BINS real, then MIX_HRTF_BINS imaginary).
+    float *input;          // MIX_HRTF_FFT_SIZE samples: the previous partition, then the one being collected.
+    float *output;         // MIX_HRTF_PARTITION_FRAMES stereo frames, waiting to be mixed.
+    float *work_re;        // MIX_HRTF_FFT_SIZE samples of FFT scratch space.
+    float *work_im;
+    float *acc;            // one spectrum, MIX_HRTF_BINS real then MIX_HRTF_BINS imaginary.
+} MIX_BinauralState;
+
+// Build filters from `num_hrirs` impulse responses of `frames` sample frames at `hrir_freq`, resampled to `freq`. NULL on error.
+MIX_HRTF *MIX_CreateHRTF(const MIX_HRIR *hrirs, int num_hrirs, int frames, int hrir_freq, int freq);
+void MIX_DestroyHRTF(MIX_HRTF *hrtf);
+MIX_BinauralState *MIX_CreateBinauralState(const MIX_HRTF *hrtf);
+void MIX_DestroyBinauralState(MIX_BinauralState *state);
+
+// Convolve `samples` frames of mono `src` for a source at `radians` from the listener, and add the stereo result,
+//  scaled by `gain`, to `dst`. The output is MIX_HRTF_PARTITION_FRAMES behind the input.
+void MIX_RenderBinaural(const MIX_HRTF *hrtf, MIX_BinauralState *state, const float *src, int samples, float radians, float gain, float *dst);
+
+
 // Clamp an IOStream to a subset of its available data...this is used to cut ID3 (etc) tags off
 //  both ends of an audio file, making it look like the file just doesn't have those bytes.
 
@@ -117,6 +216,37 @@ typedef enum MIX_TrackState
     MIX_STATE_PLAYING
 } MIX_TrackState;
 
+// Decode-ahead: a worker thread decodes a track's MIX_Audio into a single-producer/single-consumer ring
+//  of float32 sample frames, so the audio device thread only has to copy finished data out of it.
+#define MIX_DECODE_AHEAD_MAX_MARKS 16   // end-of-audio positions the worker can queue up before the mixer catches up.
+
+typedef struct MIX_DecodeAhead
+{
+    MIX_Track *track;
+    SDL_Mutex *lock;      // held by a worker while decoding, and by the app thread while touching the decoder. The audio thread never takes it!
+    SDL_AtomicInt waiters;  // app threads waiting on `lock`. A worker gives it up between chunks when this is nonzero.
+    Uint8 *ring;          // decoded sample frames, in the track's raw_format.
+    size_t ring_allocation;  // number of bytes allocated to `ring`.
+    Uint32 ring_frames;   // capacity of the ring in sample frames; always a power of two.
+    Sint64 requested_frames;  // what the app asked for in MIX_SetTrackDecodeAhead.
+    int channels;         // channels per sample frame in `ring`. Zero if decode-ahead isn't usable with the current input.
+    int framesize;        // bytes per sample frame in `ring`.
+    SDL_AtomicU32 write_pos;  // total frames written to the ring (by the worker). Wraps around, that's okay.
+    SDL_AtomicU32 read_pos;   // total frames read from the ring (by the audio thread). Wraps around, that's okay.
+    Uint32 marks[MIX_DECODE_AHEAD_MAX_MARKS];  // write_pos values where the input hit end of audio (EOF, max_frame, etc).
+    SDL_AtomicU32 marks_write;
+    SDL_AtomicU32 marks_read;
+    SDL_AtomicInt active;     // nonzero if the worker should keep this ring full.
+    SDL_AtomicInt finished;   // nonzero if the worker can't produce anything else until the next reset.
+    SDL_AtomicInt underruns;  // times the mixer needed data that the worker hadn't decoded yet.
+    Sint64 decode_position;   // worker's idea of the input position, in sample frames.
+    Sint64 max_frame;         // copy of the track's playback parameters, so the worker doesn't have to touch the track.
+    Sint64 loop_start;
+    int loops_remaining;
+    struct MIX_DecodeAhead *prev;  // double-linked list for the worker pool.
+    struct MIX_DecodeAhead *next;
+} MIX_DecodeAhead;
+
 struct MIX_Audio
 {
     SDL_AtomicInt refcount;
@@ -137,9 +267,28 @@ struct MIX_Audio
 struct MIX_Track
 {
     float SDL_ALIGNED(16) position3d[4];   // we only need the X, Y, and Z coords, but the 4th element makes this SIMD-friendly.
+    float SDL_ALIGNED(16) velocity3d[4];   // for doppler. Same layout as position3d.
     MIX_SpatializationMode spatialization_mode;
     float spatialization_panning[2];
     int spatialization_speakers[2];
+    float spatialization_radians;  // angle from the listener, for binaural rendering.
+    MIX_BinauralState *binaural;   // created on the app's thread when the track gets a 3D position or the HRTF is set, never while rendering. Freed with the mixer locked.
+    Uint32 position3d_serial;  // changes every time position3d is spatialized, or stored in the mixer's spatial_block.
+    int spatial_block_slot;    // where position3d was last stored in the mixer's spatial_block. Only valid if the serial there still matches.
+    float frequency_ratio;     // what the app asked for. The output stream's ratio is this times mixed_doppler_ratio.
+    float doppler_ratio;       // the doppler shift from the last spatialization. Written with LockTrack; the mix reads it without, like spatialization_panning.
+    float mixed_doppler_ratio; // the doppler shift output_stream is using right now; it moves toward doppler_ratio a little each mix. Protected by LockTrack.
+    float mixed_panning[2];    // the spatialization_panning that was last mixed, to ramp from when it changes. Only the mixing thread touches these.
+    int mixed_speakers[2];
+    bool mixed_panning_valid;
+    float mixed_ambisonic_gains[MIX_AMBISONIC_MAX_CHANNELS];  // the encoding gains last mixed, to ramp from. Only the mixing thread touches these.
+    bool mixed_ambisonic_valid;
+    float send_levels[MIX_MAX_SEND_BUSES];  // how much of this track goes to each send bus. Written with LockTrack; the mix reads them without.
+    float occlusion;           // 0 to 1: how much of the track's sound has to pass through something to reach the listener. Protected by LockTrack.
+    float obstruction;         // 0 to 1: how much of the direct path is blocked, with the sound still getting around it. Protected by LockTrack.
+    float lowpass_coefficient; // one-pole low-pass for occlusion and obstruction; 1.0f means no filtering. Protected by LockTrack.
+    float occlusion_gain;      // attenuation from occlusion; 1.0f if none. Protected by LockTrack.
+    float lowpass_state;       // the low-pass filter's last output. Only the mixing thread touches this.
     MIX_Mixer *mixer;
     SDL_PropertiesID props;
     float *input_buffer;  // a place to process audio as it progresses through the callback.
@@ -150,7 +299,10 @@ struct MIX_Track
     bool closeio;  // true if we should close `io` when changing track data.
     SDL_AudioStream *input_stream;  // used for both MIX_SetTrackAudio and MIX_SetTrackAudioStream. Maybe not owned by SDL_mixer!
     SDL_AudioStream *internal_stream;  // used with MIX_SetTrackAudio, where it is also assigned to input_stream. Owned by SDL_mixer!
+    bool direct_render;  // hint for MixTrack: input_audio is float32 in memory, so it might be mixed straight from there.
+    SDL_AudioFormat raw_format;  // format of what input_stream hands to output_stream. Float32, unless the audio is Sint16, which output_stream converts while resampling.
     void *decoder_userdata;  // MIX_Decoder-specific data for this run, if any.
+    MIX_DecodeAhead *decode_ahead;  // created by the first MIX_SetTrackDecodeAhead and kept until the track is destroyed. Set with SDL_*AtomicPointer.
     SDL_AudioSpec output_spec;  // processed data we send to SDL is in this format.
     SDL_AudioStream *output_stream;  // the stream that is bound to the audio device.
     MIX_TrackState state;  // playing, paused, stopped.
@@ -161,8 +313,18 @@ struct MIX_Track
     Sint64 total_fade_frames;  // fade in or out for this many sample frames.
     Sint64 fade_frames;  // remaining frames to fade.
     int fade_direction;  // -1: fade out  0: don't fade  1: fade in
+    MIX_FadeCurve fade_curve;  // shape of the current fade.
+    MIX_FadeCurve fade_out_curve;  // shape to use if StopTrack() starts a fade-out.
     int loops_remaining;  // seek to loop_start and continue this many more times at end of input. Negative to loop forever.
     int loop_start;      // sample frame position for loops to begin, so you can play an intro once and then loop from an internal point thereafter.
+    float gain;  // copy of the output_stream's gain, so voice limiting doesn't have to lock every track.
+    float attenuation;  // distance attenuation (3D) or loudest channel (stereo); 1.0f if not spatialized.
+    float audibility;  // gain * attenuation, calculated each time voices are ranked.
+    int priority;  // voice limiting picks tracks with higher priority first.
+    float audibility_threshold;  // overrides the mixer's audibility_threshold if >= 0.0f.
+    bool virtualized;  // true if voice limiting decided not to decode or mix this track right now.
+    bool culled;  // true if virtualized because it was below the audibility threshold, not because of the voice budget.
+    double virtual_frames;  // fractional input sample frames a virtual track still has to advance.
     SDL_PropertiesID tags;  // lookup tags to see if they are currently applied to this track (true or false).
     MIX_TrackMixCallback raw_callback;
     void *raw_callback_userdata;
@@ -178,6 +340,50 @@ struct MIX_Track
     MIX_Track *fire_and_forget_next;  // linked list for the fire-and-forget pool.
 };
 
+// Built-in group effects: EQ, then compressor, then gain, then limiter. The app's threads change `pending` under
+//  writer_lock, bumping `serial` before and after (so it's odd while a change is in progress), and MixerCallback
+//  copies `pending` to `target` at the start of a mix whenever `serial` is even and new. The audio thread never
+//  waits on the app this way; at worst, it picks up a change one mix later.
+#define MIX_EFFECT_MAX_CHANNELS 8
+#define MIX_LIMITER_MAX_LOOKAHEAD_FRAMES 512
+
+typedef struct MIX_GroupEffectParams
+{
+    MIX_EQBand eq[MIX_MAX_EQ_BANDS];
+    bool compressor_enabled;
+    MIX_Compressor compressor;
+    bool limiter_enabled;
+    MIX_Limiter limiter;
+    float gain;
+} MIX_GroupEffectParams;
+
+typedef struct MIX_GroupEffects
+{
+    SDL_SpinLock writer_lock;         // only app threads take this, never the audio thread.
+    SDL_AtomicInt serial;
+    MIX_GroupEffectParams pending;    // Protected by writer_lock.
+
+    // everything below here is only touched by the mixing thread.
+    int applied_serial;
+    MIX_GroupEffectParams target;     // the last complete copy of `pending`.
+    int channels;                     // what the filter state below was built for; it's reset if this changes.
+    int freq;                         // what the EQ coefficients were calculated for.
+    MIX_EQBand eq[MIX_MAX_EQ_BANDS];  // glides toward target.eq.
+    bool eq_dirty;
+    int num_eq_active;
+    int eq_active_band[MIX_MAX_EQ_BANDS];        // which band each of the arrays below is for; only bands that aren't off are here.
+    float eq_coefficients[MIX_MAX_EQ_BANDS][5];  // b0, b1, b2, a1, a2.
+    float eq_state[MIX_MAX_EQ_BANDS][2][MIX_EFFECT_MAX_CHANNELS];  // the filter's state, per channel.
+    float compressor_envelope;
+    float compressor_gain;
+    float gain;                       // the group gain at the end of the last mix, to ramp from.
+    float limiter_envelope;
+    int limiter_hold;
+    float limiter_gain;
+    int limiter_position;
+    float limiter_ring[MIX_LIMITER_MAX_LOOKAHEAD_FRAMES * MIX_EFFECT_MAX_CHANNELS];  // the lookahead delay line.
+} MIX_GroupEffects;
+
 struct MIX_Group
 {
     MIX_Mixer *mixer;
@@ -185,10 +391,165 @@ struct MIX_Group
     SDL_PropertiesID props;
     MIX_GroupMixCallback postmix_callback;
     void *postmix_callback_userdata;
+    MIX_BinauralState *ambisonic_binaural[MIX_AMBISONIC_MAX_VIRTUAL_SPEAKERS];  // for decoding this group's ambisonic bus binaurally. Freed with the mixer locked.
+    MIX_GroupEffects effects;
     MIX_Group *prev;  // double-linked list for all_groups.
     MIX_Group *next;
 };
 
+// Send buses: tracks can feed some of their audio into a few shared buses, and each bus is processed once per mix,
+//  no matter how many tracks feed it, then mixed back into the final output after all the groups.
+// A send bus's built-in reverb: a feedback delay network of MIX_REVERB_LINES delay lines, mixed through a Householder
+//  matrix. The lines are interleaved (every frame has one sample from each line), so each frame's writes to all of
+//  them are contiguous, and the feedback math runs on all of them at once as vectors.
+#define MIX_REVERB_LINES 8
+#define MIX_REVERB_MAX_PREDELAY_MS 100
+
+typedef struct MIX_ReverbState
+{
+    MIX_Reverb params;     // what the app asked for.
+    bool changed;          // `params` changed since the last mix.
+    bool idle;             // nothing was sent and the tail faded out, so the delay lines are all zero.
+    int quiet_frames;      // sample frames since something was last sent to the bus.
+    int freq;              // what the delay lines were allocated for.
+    int capacity;          // sample frames in the delay lines.
+    int position;          // where the next frame goes into the delay lines.
+    int lengths[MIX_REVERB_LINES];  // how long each delay line is right now, in sample frames.
+    int predelay_capacity;
+    int predelay_position;
+    int predelay_length;
+    float damping;         // one-pole low-pass coefficient in each line's feedback path.
+    float SDL_ALIGNED(16) feedback[MIX_REVERB_LINES];       // each line's decay per trip around the network.
+    float SDL_ALIGNED(16) damping_state[MIX_REVERB_LINES];
+    float *lines;          // `capacity` frames of MIX_REVERB_LINES samples each.
+    float *predelay;       // `predelay_capacity` mono samples.
+} MIX_ReverbState;
+
+typedef struct MIX_SendBus
+{
+    float gain;                       // how much of the bus goes back into the mix. Protected by LockMixer.
+    MIX_SendBusMixCallback callback;  // Protected by LockMixer.
+    void *callback_userdata;
+    MIX_ReverbState *reverb;          // NULL if the bus has no reverb. Protected by LockMixer.
+} MIX_SendBus;
+
+typedef struct MIX_SendBuffers
+{
+    float *buffer;   // MIX_MAX_SEND_BUSES buffers of `amount` bytes of mixer->spec audio, one after another.
+    int amount;
+    bool used[MIX_MAX_SEND_BUSES];  // false if nothing was sent to that bus since the buffer was cleared.
+} MIX_SendBuffers;
+
+// Parallel rendering: MixerCallback splits each group's tracks into fixed-size chunks ("jobs"), and the
+//  audio device thread and a few render threads each mix whole jobs into the job's own buffer. Then the
+//  device thread sums the jobs in order, so the result doesn't depend on which thread did what.
+#define MIX_RENDER_TRACKS_PER_JOB 8
+#define MIX_MAX_RENDER_THREADS 16
+
+// the biggest buffer, in sample frames, that MIX_SetMixerRealtimeSafe will preallocate for.
+#define MIX_REALTIME_MAX_FRAMES 65536
+
+typedef struct MIX_RenderJob
+{
+    MIX_Group *group;
+    MIX_Track **tracks;   // points into mixer->render_tracks.
+    int num_tracks;
+    float *mixbuf;        // this job's tracks are mixed here.
+    int mixed_bytes;      // how much of mixbuf actually had something mixed into it.
+    MIX_AmbisonicBus ambisonic;  // this job's 3D tracks are encoded here, if the mixer uses an ambisonic bus.
+    MIX_SendBuffers sends;       // this job's tracks feed the send buses here, if any track uses them.
+} MIX_RenderJob;
+
+typedef struct MIX_RenderThread
+{
+    MIX_Mixer *mixer;
+    SDL_Thread *thread;
+    float *getbuf;        // scratch space to pull track data into.
+    size_t getbuf_allocation;
+} MIX_RenderThread;
+
+// Batches: between MIX_BeginBatch and MIX_CommitBatch, per-track changes from that thread are recorded as commands
+//  instead of locking the track. Committing pushes the whole batch on a lock-free stack, and MixerCallback applies
+//  every committed batch at the start of its next buffer, so they all land on the same sample frame. Applied batches
+//  go on another lock-free stack for the app's thread to reuse, so the audio thread never allocates or frees them.
+typedef enum MIX_CommandType
+{
+    MIX_COMMAND_GAIN,
+    MIX_COMMAND_FREQUENCY_RATIO,
+    MIX_COMMAND_STEREO,
+    MIX_COMMAND_3D_POSITION,
+    MIX_COMMAND_3D_VELOCITY,
+    MIX_COMMAND_OCCLUSION,
+    MIX_COMMAND_SEND,
+    MIX_COMMAND_PLAY,    // MIX_PlayTrack already did the setup on the app's thread; this just sets the track playing.
+    MIX_COMMAND_STOP,
+    MIX_COMMAND_PAUSE,
+    MIX_COMMAND_RESUME
+} MIX_CommandType;
+
+typedef struct MIX_Command
+{
+    MIX_CommandType type;
+    MIX_Track *track;     // NULL if the track was destroyed before this was applied.
+    bool clear;           // MIX_COMMAND_STEREO, MIX_COMMAND_3D_POSITION and MIX_COMMAND_3D_VELOCITY: the app passed NULL.
+    union {
+        float gain;
+        float ratio;
+        MIX_StereoGains stereo;
+        MIX_Point3D position;   // MIX_COMMAND_3D_VELOCITY uses this for the velocity.
+        struct { float occlusion; float obstruction; } occlusion;
+        struct { int bus; float level; } send;
+        Sint64 fade_out_frames;
+    } data;
+} MIX_Command;
+
+typedef struct MIX_CommandBatch
+{
+    MIX_Command *commands;
+    int num_commands;
+    int allocation;
+    struct MIX_CommandBatch *next;  // for the committed, spent and free lists.
+} MIX_CommandBatch;
+
+// The 3D listener: the point everything is spatialized relative to. Each vector is 4 elements, the last always zero, to be SIMD-friendly.
+typedef struct MIX_Listener3D
+{
+    float SDL_ALIGNED(16) position[4];
+    float SDL_ALIGNED(16) at[4];        // normalized.
+    float SDL_ALIGNED(16) up[4];        // normalized, and perpendicular to `at`.
+    float SDL_ALIGNED(16) velocity[4];
+} MIX_Listener3D;
+
+// MIX_SetTracks3DPositions stores positions here, structure-of-arrays, and MixerCallback spatializes them all
+//  at the start of the next mix, a SIMD register's worth at a time. Each array has `allocation` elements.
+typedef struct MIX_SpatialBlock
+{
+    MIX_Track **tracks;   // NULL if the track was destroyed after its position was stored.
+    Uint32 *serials;      // the track's position3d_serial when this was stored. If it changed since, a newer position won.
+    float *x;
+    float *y;
+    float *z;
+    float *vx;            // the track's velocity when this was stored (or last changed, if that was later).
+    float *vy;
+    float *vz;
+    float *gains;         // scratch space for MIX_CalculateDistanceAttenuationsAndAngles.
+    float *radians;
+    float *ratios;        // scratch space for MIX_CalculateDopplerRatios.
+    int count;
+    int allocation;
+} MIX_SpatialBlock;
+
+// Stats that any thread (render threads, decode-ahead workers, etc) might add to. MixerCallback moves these
+//  into the mixer's 64-bit totals and resets them each time it runs, so 32 bits is plenty.
+typedef struct MIX_PendingStats
+{
+    SDL_AtomicInt decode_ns;
+    SDL_AtomicInt mix_ns;
+    SDL_AtomicInt app_callback_ns;
+    SDL_AtomicInt buffer_reallocations;
+    SDL_AtomicInt frames_decoded[MIX_MAX_STATS_DECODERS];
+} MIX_PendingStats;
+
 struct MIX_Mixer
 {
     SDL_AudioStream *output_stream;
@@ -199,6 +560,7 @@ struct MIX_Mixer
     MIX_Group *default_group;
     MIX_Track *all_tracks;
     MIX_Track *fire_and_forget_pool;  // these are also listed in all_tracks.
+    MIX_Track *fire_and_forget_returns;  // stopped fire-and-forget tracks waiting to go back in the pool. Lock-free stack, use SDL_*AtomicPointer.
     MIX_Group *all_groups;
     MIX_PostMixCallback postmix_callback;
     void *postmix_callback_userdata;
@@ -206,6 +568,62 @@ struct MIX_Mixer
     size_t mix_buffer_allocation;
     float gain;
     MIX_VBAP2D vbap2d;
+    int num_render_threads;  // zero if not rendering in parallel, otherwise the number of threads _besides_ the audio device thread.
+    MIX_RenderThread render_threads[MIX_MAX_RENDER_THREADS + 1];  // element zero is the audio device thread's scratch space; it has no SDL_Thread.
+    SDL_Semaphore *render_start;   // posted once per render thread when there's a new set of jobs.
+    SDL_Semaphore *render_done;    // posted by each render thread when it runs out of jobs.
+    SDL_AtomicInt render_next_job;
+    SDL_AtomicInt render_shutdown;
+    MIX_RenderJob *render_jobs;
+    int num_render_jobs;
+    int render_jobs_allocation;
+    int render_amount;             // bytes of mixer->spec audio each job should produce this time.
+    MIX_Track **render_tracks;     // snapshot of each group's tracks for this callback.
+    int render_tracks_allocation;
+    float *render_buffer;          // job mix buffers.
+    size_t render_buffer_allocation;
+    int max_voices;                // voice budget; zero means no limit.
+    float audibility_threshold;    // tracks quieter than this are made virtual.
+    int num_track_audibility_thresholds;  // tracks with their own audibility threshold; voice limiting can't be skipped while any exist.
+    int num_virtual_tracks;        // tracks flagged as virtual after the last ranking, playing or not.
+    MIX_Track **voice_tracks;      // scratch space for ranking tracks.
+    int voice_tracks_allocation;
+    int realtime_frames;           // if > 0, real-time-safe mode: scratch buffers are preallocated for this many sample frames.
+    bool native_channels;          // if true, unspatialized mono and stereo tracks aren't upmixed until MixTrack.
+    SDL_Mutex *batch_lock;         // protects the batch_* fields and free_batches. The audio thread never takes this.
+    int batch_depth;               // MIX_BeginBatch nesting; commands are recorded while this is > 0.
+    SDL_ThreadID batch_thread;     // the thread with the open batch; calls from other threads apply immediately.
+    void *batch_owner;             // batch_thread cast to a pointer, or NULL; checked without batch_lock, so calls outside a batch never lock. Use SDL_*AtomicPointer.
+    MIX_CommandBatch *batch;       // the batch being recorded.
+    MIX_CommandBatch *free_batches;       // recycled batches, ready for MIX_BeginBatch.
+    MIX_CommandBatch *committed_batches;  // lock-free stack (newest first) for MixerCallback, use SDL_*AtomicPointer.
+    MIX_CommandBatch *spent_batches;      // lock-free stack of applied batches, to go back on free_batches.
+    MIX_SpatialBlock spatial_block;       // positions from MIX_SetTracks3DPositions, waiting for the next mix.
+    MIX_Listener3D listener3d;            // protected by LockMixer, and spatial_sequence for readers that don't lock the mixer.
+    MIX_HRTF *hrtf;                       // non-NULL to render 3D tracks binaurally on stereo output. Protected by LockMixer.
+    int ambisonic_order;                  // 0 to pan 3D tracks straight to speakers, otherwise they go through an ambisonic bus. Protected by LockMixer.
+    float ambisonic_decoder[MIX_VBAP2D_MAX_SPEAKER_COUNT * MIX_AMBISONIC_MAX_CHANNELS];
+    float ambisonic_virtual_decoder[MIX_AMBISONIC_MAX_VIRTUAL_SPEAKERS * MIX_AMBISONIC_MAX_CHANNELS];
+    float ambisonic_virtual_radians[MIX_AMBISONIC_MAX_VIRTUAL_SPEAKERS];
+    int ambisonic_virtual_speakers;
+    float *ambisonic_buffer;              // the bus for the device thread, and where job buses are summed when rendering in parallel.
+    size_t ambisonic_buffer_allocation;
+    float *ambisonic_render_buffer;       // a bus for each render job.
+    size_t ambisonic_render_buffer_allocation;
+    bool listener3d_changed;              // MixerCallback should respatialize every 3D track before the next mix.
+    float speed_of_sound;                 // in the app's units per second, for doppler. Zero turns doppler off. Protected like listener3d.
+    SDL_AtomicU32 spatial_sequence;       // seqlock over listener3d, speed_of_sound, vbap2d and spec.freq: odd while they're changing.
+    MIX_SendBus send_buses[MIX_MAX_SEND_BUSES];
+    bool sends_enabled;                   // set (for good) once any track feeds a send bus, so the buffers below are kept around. Protected by LockMixer.
+    float *send_buffer;                   // the send buses for the device thread, and where job buses are summed when rendering in parallel.
+    size_t send_buffer_allocation;
+    float *send_render_buffer;            // send buses for each render job.
+    size_t send_render_buffer_allocation;
+    MIX_PendingStats pending_stats;
+    MIX_MixerStats stats;            // only touched by MixerCallback.
+    Uint64 stats_total_callback_ns;  // for calculating stats.callback_avg_ns.
+    MIX_MixerStats published_stats;  // copy of `stats` for MIX_GetMixerStats, protected by stats_sequence.
+    SDL_AtomicU32 stats_sequence;    // seqlock: odd while published_stats is being updated.
     MIX_Mixer *prev;  // double-linked list for all_mixers.
     MIX_Mixer *next;
 };
@@ -260,8 +678,26 @@ typedef struct MIX_OggLoop
 
 void MIX_ParseOggComments(SDL_PropertiesID props, int freq, const char *vendor, const char * const *user_comments, int num_comments, MIX_OggLoop *loop);
 
+// Set up a listener at (0,0,0), facing forward with up being up, like OpenAL's defaults.
+void MIX_InitListener3D(MIX_Listener3D *listener);
+
 // `panning` and `speakers` need to be arrays of 2 elements each, to be filled in with what speakers to write to, and at what gain. `position` must be 16 bytes (only 12 are used), aligned to 16 bytes.
-void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const float *position, float *panning, int *speakers);
+// `radians`, if not NULL, gets the source's angle from the listener.
+void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const MIX_Listener3D *listener, const float *position, float *panning, int *speakers, float *radians);
+
+// Distance attenuation for a 3D position, the same as MIX_Spatialize applies. `position` must be at least 3 elements.
+float MIX_DistanceAttenuation(const MIX_Listener3D *listener, const float *position);
+
+// The first half of MIX_Spatialize for `count` positions at once, in structure-of-arrays form: fills in each one's
+//  distance attenuation (`gains`) and angle from the listener (`radians`), to be passed to MIX_SpatializeAngle.
+void MIX_CalculateDistanceAttenuationsAndAngles(const MIX_Listener3D *listener, const float *x, const float *y, const float *z, float *gains, float *radians, int count);
+
+// Doppler shift for `count` sources at (x, y, z) moving at (vx, vy, vz), relative to the listener, in structure-of-arrays form:
+//  fills in each one's frequency ratio. If `speed_of_sound` isn't positive, doppler is off and every ratio is 1.
+void MIX_CalculateDopplerRatios(const MIX_Listener3D *listener, float speed_of_sound, const float *x, const float *y, const float *z, const float *vx, const float *vy, const float *vz, float *ratios, int count);
+
+// The second half of MIX_Spatialize: picks speakers and panning for a source at `radians` from the listener, scaled by `gain`.
+void MIX_SpatializeAngle(const MIX_VBAP2D *vbap2d, float gain, float radians, float *panning, int *speakers);
 
 // if we think `io` is backed by a memory buffer, return its pointer and buffer length for direct access.
 void *MIX_GetConstIOBuffer(SDL_IOStream *io, size_t *datalen);
@@ -83,11 +83,79 @@ static const MIX_VBAP2D_SpeakerLayout MIX_VBAP2D_SpeakerLayouts[MIX_VBAP2D_MAX_S
 };
 #undef P
 
+// gains for a source at `source_angle` (radians, 0 is due east, counterclockwise) panned between `speaker_pair`.
+static void MIX_VBAP2D_CalculatePairGains(const MIX_VBAP2D *vbap2d, int speaker_pair, float source_angle, float *gains)
+{
+    const float source_x = SDL_cosf(source_angle);
+    const float source_y = SDL_sinf(source_angle);
+
+    const MIX_VBAP2D_Matrix *matrix = &vbap2d->matrices[speaker_pair];
+    const float gain_a = source_x * matrix->a00 + source_y * matrix->a01;
+    const float gain_b = source_x * matrix->a10 + source_y * matrix->a11;
+
+    const float scale = 1.0f / SDL_sqrtf(gain_a * gain_a + gain_b * gain_b);
+
+    gains[0] = gain_a * scale;
+    gains[1] = gain_b * scale;
+}
+
+// this does the expensive part of panning once per table entry, so MIX_VBAP2D_CalculateGains can just interpolate.
+static void MIX_VBAP2D_BuildGainTable(MIX_VBAP2D *vbap2d, const MIX_VBAP2D_SpeakerLayout *speaker_layout, int speaker_count)
+{
+    SDL_COMPILE_TIME_ASSERT(vbap_gain_table_resolution, (MIX_VBAP2D_GAIN_TABLE_RESOLUTION % MIX_VBAP2D_RESOLUTION) == 0);
+    const int entries_per_bucket = MIX_VBAP2D_GAIN_TABLE_RESOLUTION / MIX_VBAP2D_RESOLUTION;
+
+    for (int i = 0; i < MIX_VBAP2D_GAIN_TABLE_RESOLUTION; i++) {
+        // every entry sits inside one bucket, so both of its ends use that bucket's speaker pair.
+        const int speaker_pair = vbap2d->buckets[i / entries_per_bucket].speaker_pair;
+        const float angle = (float)i * (2.0f * SDL_PI_F) / (float)MIX_VBAP2D_GAIN_TABLE_RESOLUTION;
+        const float next_angle = (float)(i + 1) * (2.0f * SDL_PI_F) / (float)MIX_VBAP2D_GAIN_TABLE_RESOLUTION;
+        float next_gains[2];
+        int vbap_speakers[2];
+
+        MIX_VBAP2D_GainEntry *entry = &vbap2d->gain_table[i];
+        MIX_VBAP2D_CalculatePairGains(vbap2d, speaker_pair, angle, entry->gains);
+        MIX_VBAP2D_CalculatePairGains(vbap2d, speaker_pair, next_angle, next_gains);
+        entry->deltas[0] = next_gains[0] - entry->gains[0];
+        entry->deltas[1] = next_gains[1] - entry->gains[1];
+
+        MIX_VBAP2D_unpack_speaker_pair(speaker_pair, speaker_count, vbap_speakers);
+        entry->speakers[0] = speaker_layout->positions[vbap_speakers[0]].sdl_channel;
+        entry->speakers[1] = speaker_layout->positions[vbap_speakers[1]].sdl_channel;
+    }
+}
+
+static void MIX_VBAP2D_CalculateGains(const MIX_VBAP2D *vbap2d, float source_angle, float *gains, int *speakers)
+{
+    SDL_assert(vbap2d->speaker_count >= 4);
+
+    // shift so angle 0 is due east instead of due north, and normalize it to the 0 to 2pi range.
+    source_angle += SDL_PI_F / 2.0f;
+
+    while (source_angle < 0.0f) {
+        source_angle += 2.0f * SDL_PI_F;
+    }
+    while (source_angle > (2.0f * SDL_PI_F)) {
+        source_angle -= 2.0f * SDL_PI_F;
+    }
+
+    const float position = source_angle * (float)MIX_VBAP2D_GAIN_TABLE_RESOLUTION / (2.0f * SDL_PI_F);
+    const int index = SDL_clamp((int)position, 0, MIX_VBAP2D_GAIN_TABLE_RESOLUTION - 1);
+    const float fraction = position - (float)index;
+    const MIX_VBAP2D_GainEntry *entry = &vbap2d->gain_table[index];
+
+    speakers[0] = entry->speakers[0];
+    speakers[1] = entry->speakers[1];
+    gains[0] = entry->gains[0] + (entry->deltas[0] * fraction);
+    gains[1] = entry->gains[1] + (entry->deltas[1] * fraction);
+}
+
 void MIX_VBAP2D_Init(MIX_VBAP2D *vbap2d, int speaker_count)
 {
     SDL_assert(speaker_count > 0);
     SDL_assert(speaker_count <= MIX_VBAP2D_MAX_SPEAKER_COUNT);
     SDL_assert(MIX_VBAP2D_RESOLUTION <= MIX_VBAP2D_MAX_RESOLUTION);
+    SDL_assert(MIX_VBAP2D_GAIN_TABLE_RESOLUTION <= MIX_VBAP2D_MAX_RESOLUTION);
 
     vbap2d->speaker_count = speaker_count;
 
@@ -133,50 +201,8 @@ void MIX_VBAP2D_Init(MIX_VBAP2D *vbap2d, int speaker_count)
         matrices[speaker_pair].a10 = -a10 * det;
         matrices[speaker_pair].a11 = +a00 * det;
     }
-}
-
-static void MIX_VBAP2D_CalculateGains(const MIX_VBAP2D *vbap2d, float source_angle, float *gains, int *speakers)
-{
-    int speaker_count = vbap2d->speaker_count;
-    SDL_assert(speaker_count >= 4);
-
-    const MIX_VBAP2D_SpeakerLayout *speaker_layout = &MIX_VBAP2D_SpeakerLayouts[speaker_count - 4];  // offset to zero, skip mono/stereo/2.1
-
-    if (speaker_layout->lfe_channel >= 0) {
-        speaker_count--;  // for our purposes, collapse out the subwoofer channel
-    }
 
-    // shift so angle 0 is due east instead of due north, and normalize it to the 0 to 2pi range.
-    source_angle += SDL_PI_F / 2.0f;
-
-    while (source_angle < 0.0f) {
-        source_angle += 2.0f * SDL_PI_F;
-    }
-    while (source_angle > (2.0f * SDL_PI_F)) {
-        source_angle -= 2.0f * SDL_PI_F;
-    }
-
-    const float source_x = SDL_cosf(source_angle);
-    const float source_y = SDL_sinf(source_angle);
-    const int span = MIX_VBAP2D_angle_to_span(source_angle);
-    const int speaker_pair = vbap2d->buckets[span].speaker_pair;
-    int vbap_speakers[2];
-
-    MIX_VBAP2D_unpack_speaker_pair(speaker_pair, speaker_count, vbap_speakers);
-
-    const MIX_VBAP2D_Matrix *matrix = &vbap2d->matrices[speaker_pair];
-    const float gain_a = source_x * matrix->a00 + source_y * matrix->a01;
-    const float gain_b = source_x * matrix->a10 + source_y * matrix->a11;
-
-    const float scale = 1.0f / SDL_sqrtf(gain_a * gain_a + gain_b * gain_b);
-
-    const float gain_a_normalized = gain_a * scale;
-    const float gain_b_normalized = gain_b * scale;
-
-    speakers[0] = speaker_layout->positions[vbap_speakers[0]].sdl_channel;
-    speakers[1] = speaker_layout->positions[vbap_speakers[1]].sdl_channel;
-    gains[0] = gain_a_normalized;
-    gains[1] = gain_b_normalized;
+    MIX_VBAP2D_BuildGainTable(vbap2d, speaker_layout, speaker_count);
 }
 
 // end VBAP code.
@@ -195,8 +221,12 @@ static float calculate_distance_attenuation(const float distance)
     return 1.0f / (1.0f + (SDL_max(distance, 1.0f) - 1.0f));
 }
 
-static const float SDL_ALIGNED(16) listener_at[4] = { 0.0f, 0.0, -1.0f, 0.0f };  // default "at" for OpenAL listener orientation matrix.
-static const float SDL_ALIGNED(16) listener_up[4] = { 0.0f, 1.0, 0.0f, 0.0f };  // default "up" for OpenAL listener orientation matrix.
+void MIX_InitListener3D(MIX_Listener3D *listener)
+{
+    SDL_zerop(listener);
+    listener->at[2] = -1.0f;  // default "at" for OpenAL listener orientation matrix.
+    listener->up[1] = 1.0f;   // default "up" for OpenAL listener orientation matrix.
+}
 
 
 #if SDL_MIXER_NEED_SCALAR_FALLBACK
@@ -227,14 +257,23 @@ static float magnitude(const float *v)
     return SDL_sqrtf((v[0] * v[0]) + (v[1] * v[1]) + (v[2] * v[2]));
 }
 
-static void calculate_distance_attenuation_and_angle_scalar(const float *position, float *_gain, float *_radians)
+static void calculate_distance_attenuation_and_angle_scalar(const MIX_Listener3D *listener, const float *position, float *_gain, float *_radians)
 {
+    const float *listener_at = listener->at;
+    const float *listener_up = listener->up;
+
+    // Move the source into listener space, so the listener is at (0,0,0).
+    float P[3];
+    P[0] = position[0] - listener->position[0];
+    P[1] = position[1] - listener->position[1];
+    P[2] = position[2] - listener->position[2];
+
     // Remove upwards component so it lies completely within the horizontal plane.
-    const float a = dotproduct(position, listener_up);
+    const float a = dotproduct(P, listener_up);
     float V[3];
-    V[0] = position[0] - (a * listener_up[0]);
-    V[1] = position[1] - (a * listener_up[1]);
-    V[2] = position[2] - (a * listener_up[2]);
+    V[0] = P[0] - (a * listener_up[0]);
+    V[1] = P[1] - (a * listener_up[1]);
+    V[2] = P[2] - (a * listener_up[2]);
 
     // Calculate angle
     const float mags = magnitude(listener_at) * magnitude(V);
@@ -255,7 +294,7 @@ static void calculate_distance_attenuation_and_angle_scalar(const float *positio
         radians = -radians;
     }
 
-    *_gain = calculate_distance_attenuation(magnitude(position));
+    *_gain = calculate_distance_attenuation(magnitude(P));
     *_radians = radians;
 }
 #endif
@@ -287,11 +326,11 @@ static float SDL_TARGETING("sse") magnitude_sse(const __m128 v)
     return SDL_sqrtf(dotproduct_sse(v, v));
 }
 
-static void SDL_TARGETING("sse") calculate_distance_attenuation_and_angle_sse(const float *position, float *_gain, float *_radians)
+static void SDL_TARGETING("sse") calculate_distance_attenuation_and_angle_sse(const MIX_Listener3D *listener, const float *position, float *_gain, float *_radians)
 {
-    const __m128 position_sse = _mm_load_ps(position);
-    const __m128 at_sse = _mm_load_ps(listener_at);
-    const __m128 up_sse = _mm_load_ps(listener_up);
+    const __m128 position_sse = _mm_sub_ps(_mm_load_ps(position), _mm_load_ps(listener->position));
+    const __m128 at_sse = _mm_load_ps(listener->at);
+    const __m128 up_sse = _mm_load_ps(listener->up);
 
     const float a = dotproduct_sse(position_sse, up_sse);
     const __m128 V_sse = _mm_sub_ps(position_sse, _mm_mul_ps(_mm_set1_ps(a), up_sse));
@@ -337,11 +376,11 @@ static float magnitude_neon(const float32x4_t v)
     return SDL_sqrtf(dotproduct_neon(v, v));
 }
 
-static void calculate_distance_attenuation_and_angle_neon(const float *position, float *_gain, float *_radians)
+static void calculate_distance_attenuation_and_angle_neon(const MIX_Listener3D *listener, const float *position, float *_gain, float *_radians)
 {
-    const float32x4_t position_neon = vld1q_f32(position);
-    const float32x4_t at_neon = vld1q_f32(listener_at);
-    const float32x4_t up_neon = vld1q_f32(listener_up);
+    const float32x4_t position_neon = vsubq_f32(vld1q_f32(position), vld1q_f32(listener->position));
+    const float32x4_t at_neon = vld1q_f32(listener->at);
+    const float32x4_t up_neon = vld1q_f32(listener->up);
 
     const float a = dotproduct_neon(position_neon, up_neon);
     const float32x4_t V_neon = vsubq_f32(position_neon, vmulq_f32(vdupq_n_f32(a), up_neon));
@@ -364,29 +403,140 @@ static void calculate_distance_attenuation_and_angle_neon(const float *position,
 }
 #endif
 
-static void calculate_distance_attenuation_and_angle(const float *position, float *_gain, float *_radians)
+static void calculate_distance_attenuation_and_angle(const MIX_Listener3D *listener, const float *position, float *_gain, float *_radians)
 {
-    SDL_assert( (((size_t) listener_at) % 16) == 0 );  // must be aligned for SIMD access.
-    SDL_assert( (((size_t) listener_up) % 16) == 0 );  // must be aligned for SIMD access.
+    SDL_assert( (((size_t) listener) % 16) == 0 );  // must be aligned for SIMD access.
 
     // this goes through most of the steps the AL spec dictates for gain and distance attenuation...
     #if defined(SDL_SSE_INTRINSICS)
     if (MIX_HasSSE) {
-        calculate_distance_attenuation_and_angle_sse(position, _gain, _radians);
+        calculate_distance_attenuation_and_angle_sse(listener, position, _gain, _radians);
     } else
     #elif defined(SDL_NEON_INTRINSICS)
     if (MIX_HasNEON) {
-        calculate_distance_attenuation_and_angle_neon(position, _gain, _radians);
+        calculate_distance_attenuation_and_angle_neon(listener, position, _gain, _radians);
     } else
     #endif
 
     {
     #if SDL_MIXER_NEED_SCALAR_FALLBACK
-        calculate_distance_attenuation_and_angle_scalar(position, _gain, _radians);
+        calculate_distance_attenuation_and_angle_scalar(listener, position, _gain, _radians);
     #endif
     }
 }
 
+// Batched versions of calculate_distance_attenuation_and_angle: positions come in structure-of-arrays form, so
+//  each SIMD lane handles a different source. There's no SIMD arccosine, so that part is still done a lane at a time.
+#if defined(SDL_SSE_INTRINSICS)
+static int SDL_TARGETING("sse") calculate_distance_attenuations_and_angles_sse(const MIX_Listener3D *listener, const float *x, const float *y, const float *z, float *gains, float *radians, const int count)
+{
+    const float *listener_at = listener->at;
+    const float *listener_up = listener->up;
+    const __m128 l_x = _mm_set1_ps(listener->position[0]), l_y = _mm_set1_ps(listener->position[1]), l_z = _mm_set1_ps(listener->position[2]);
+    const __m128 at_x = _mm_set1_ps(listener_at[0]), at_y = _mm_set1_ps(listener_at[1]), at_z = _mm_set1_ps(listener_at[2]);
+    const __m128 up_x = _mm_set1_ps(listener_up[0]), up_y = _mm_set1_ps(listener_up[1]), up_z = _mm_set1_ps(listener_up[2]);
+    const __m128 at_magnitude = _mm_set1_ps(magnitude_sse(_mm_load_ps(listener_at)));
+    const __m128 R_sse = xyzzy_sse(_mm_load_ps(listener_at), _mm_load_ps(listener_up));
+    float SDL_ALIGNED(16) R[4];
+    _mm_store_ps(R, R_sse);
+    const __m128 r_x = _mm_set1_ps(R[0]), r_y = _mm_set1_ps(R[1]), r_z = _mm_set1_ps(R[2]);
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 px = _mm_sub_ps(_mm_loadu_ps(x + i), l_x);
+        const __m128 py = _mm_sub_ps(_mm_loadu_ps(y + i), l_y);
+        const __m128 pz = _mm_sub_ps(_mm_loadu_ps(z + i), l_z);
+
+        const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, up_x), _mm_mul_ps(py, up_y)), _mm_mul_ps(pz, up_z));
+        const __m128 vx = _mm_sub_ps(px, _mm_mul_ps(a, up_x));
+        const __m128 vy = _mm_sub_ps(py, _mm_mul_ps(a, up_y));
+        const __m128 vz = _mm_sub_ps(pz, _mm_mul_ps(a, up_z));
+        const __m128 v_magnitude = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz)));
+        const __m128 at_dot_v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(at_x, vx), _mm_mul_ps(at_y, vy)), _mm_mul_ps(at_z, vz));
+        const __m128 r_dot_v = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r_x, vx), _mm_mul_ps(r_y, vy)), _mm_mul_ps(r_z, vz));
+        const __m128 distance = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py)), _mm_mul_ps(pz, pz)));
+
+        _mm_storeu_ps(gains + i, _mm_div_ps(one, _mm_add_ps(one, _mm_sub_ps(_mm_max_ps(distance, one), one))));
+
+        float SDL_ALIGNED(16) mags[4], dots[4], sides[4];
+        _mm_store_ps(mags, _mm_mul_ps(at_magnitude, v_magnitude));
+        _mm_store_ps(dots, at_dot_v);
+        _mm_store_ps(sides, r_dot_v);
+        for (int j = 0; j < 4; j++) {
+            const float angle = (mags[j] == 0.0f) ? 0.0f : SDL_acosf(SDL_clamp(dots[j] / mags[j], -1.0f, 1.0f));
+            radians[i + j] = (sides[j] < 0.0f) ? -angle : angle;
+        }
+    }
+    return i;
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static int calculate_distance_attenuations_and_angles_neon(const MIX_Listener3D *listener, const float *x, const float *y, const float *z, float *gains, float *radians, const int count)
+{
+    const float *listener_at = listener->at;
+    const float *listener_up = listener->up;
+    const float32x4_t l_x = vdupq_n_f32(listener->position[0]), l_y = vdupq_n_f32(listener->position[1]), l_z = vdupq_n_f32(listener->position[2]);
+    const float32x4_t at_x = vdupq_n_f32(listener_at[0]), at_y = vdupq_n_f32(listener_at[1]), at_z = vdupq_n_f32(listener_at[2]);
+    const float32x4_t up_x = vdupq_n_f32(listener_up[0]), up_y = vdupq_n_f32(listener_up[1]), up_z = vdupq_n_f32(listener_up[2]);
+    const float32x4_t at_magnitude = vdupq_n_f32(magnitude_neon(vld1q_f32(listener_at)));
+    float SDL_ALIGNED(16) R[4];
+    vst1q_f32(R, xyzzy_neon(vld1q_f32(listener_at), vld1q_f32(listener_up)));
+    const float32x4_t r_x = vdupq_n_f32(R[0]), r_y = vdupq_n_f32(R[1]), r_z = vdupq_n_f32(R[2]);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const float32x4_t px = vsubq_f32(vld1q_f32(x + i), l_x);
+        const float32x4_t py = vsubq_f32(vld1q_f32(y + i), l_y);
+        const float32x4_t pz = vsubq_f32(vld1q_f32(z + i), l_z);
+
+        const float32x4_t a = vmlaq_f32(vmlaq_f32(vmulq_f32(px, up_x), py, up_y), pz, up_z);
+        const float32x4_t vx = vmlsq_f32(px, a, up_x);
+        const float32x4_t vy = vmlsq_f32(py, a, up_y);
+        const float32x4_t vz = vmlsq_f32(pz, a, up_z);
+        const float32x4_t v_magnitude = vsqrtq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(vx, vx), vy, vy), vz, vz));
+        const float32x4_t at_dot_v = vmlaq_f32(vmlaq_f32(vmulq_f32(at_x, vx), at_y, vy), at_z, vz);
+        const float32x4_t r_dot_v = vmlaq_f32(vmlaq_f32(vmulq_f32(r_x, vx), r_y, vy), r_z, vz);
+        const float32x4_t distance = vsqrtq_f32(vmlaq_f32(vmlaq_f32(vmulq_f32(px, px), py, py), pz, pz));
+
+        vst1q_f32(gains + i, vdivq_f32(one, vaddq_f32(one, vsubq_f32(vmaxq_f32(distance, one), one))));
+
+        float SDL_ALIGNED(16) mags[4], dots[4], sides[4];
+        vst1q_f32(mags, vmulq_f32(at_magnitude, v_magnitude));
+        vst1q_f32(dots, at_dot_v);
+        vst1q_f32(sides, r_dot_v);
+        for (int j = 0; j < 4; j++) {
+            const float angle = (mags[j] == 0.0f) ? 0.0f : SDL_acosf(SDL_clamp(dots[j] / mags[j], -1.0f, 1.0f));
+            radians[i + j] = (sides[j] < 0.0f) ? -angle : angle;
+        }
+    }
+    return i;
+}
+#endif
+
+void MIX_CalculateDistanceAttenuationsAndAngles(const MIX_Listener3D *listener, const float *x, const float *y, const float *z, float *gains, float *radians, int count)
+{
+    int i = 0;
+
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        i = calculate_distance_attenuations_and_angles_sse(listener, x, y, z, gains, radians, count);
+    }
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        i = calculate_distance_attenuations_and_angles_neon(listener, x, y, z, gains, radians, count);
+    }
+    #endif
+
+    // whatever is left over (or everything, if there's no SIMD).
+    for (; i < count; i++) {
+        const float SDL_ALIGNED(16) position[4] = { x[i], y[i], z[i], 0.0f };
+        calculate_distance_attenuation_and_angle(listener, position, &gains[i], &radians[i]);
+    }
+}
+
 // Get the sin(angle) and cos(angle) at the same time. Ideally, with one
 //  instruction, like what is offered on the x86.
 //  angle is in radians, not degrees.
@@ -398,16 +548,12 @@ static void calculate_sincos(const float angle, float *_sin, float *_cos)
     *_cos = SDL_cosf(angle);
 }
 
-void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const float *position, float *panning, int *speakers)
+void MIX_SpatializeAngle(const MIX_VBAP2D *vbap2d, float gain, float radians, float *panning, int *speakers)
 {
     const int output_channels = vbap2d->speaker_count;
 
-    SDL_assert( (((size_t) position) % 16) == 0 );  // must be aligned for SIMD access.
     SDL_assert(output_channels > 0);
 
-    float gain, radians;
-    calculate_distance_attenuation_and_angle(position, &gain, &radians);
-
     if (output_channels == 1) {  // no positioning for mono output, just distance attenuation.
         speakers[0] = speakers[1] = 0;
         panning[0] = gain;
@@ -466,3 +612,579 @@ void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const float *position, float *pann
     }
 }
 
+void MIX_Spatialize(const MIX_VBAP2D *vbap2d, const MIX_Listener3D *listener, const float *position, float *panning, int *speakers, float *_radians)
+{
+    SDL_assert( (((size_t) position) % 16) == 0 );  // must be aligned for SIMD access.
+
+    float gain, radians;
+    calculate_distance_attenuation_and_angle(listener, position, &gain, &radians);
+    MIX_SpatializeAngle(vbap2d, gain, radians, panning, speakers);
+    if (_radians) {
+        *_radians = radians;
+    }
+}
+
+float MIX_DistanceAttenuation(const MIX_Listener3D *listener, const float *position)
+{
+    const float x = position[0] - listener->position[0];
+    const float y = position[1] - listener->position[1];
+    const float z = position[2] - listener->position[2];
+    return calculate_distance_attenuation(SDL_sqrtf((x * x) + (y * y) + (z * z)));
+}
+
+// Don't let either end move faster than this fraction of the speed of sound along the line between them, so the
+//  doppler ratio stays somewhere sane (between 1/3 and 3) instead of blowing up near the sound barrier.
+#define MIX_DOPPLER_MAX_SPEED 0.5f
+
+void MIX_CalculateDopplerRatios(const MIX_Listener3D *listener, float speed_of_sound, const float *x, const float *y, const float *z, const float *vx, const float *vy, const float *vz, float *ratios, int count)
+{
+    if (!(speed_of_sound > 0.0f)) {
+        for (int i = 0; i < count; i++) {
+            ratios[i] = 1.0f;
+        }
+        return;
+    }
+
+    const float limit = speed_of_sound * MIX_DOPPLER_MAX_SPEED;
+    const float *lp = listener->position;
+    const float *lv = listener->velocity;
+
+    // plain structure-of-arrays math, so the compiler can vectorize it.
+    for (int i = 0; i < count; i++) {
+        const float dx = x[i] - lp[0];
+        const float dy = y[i] - lp[1];
+        const float dz = z[i] - lp[2];
+        const float distance = SDL_sqrtf((dx * dx) + (dy * dy) + (dz * dz));
+        if (!(distance > 0.0f)) {
+            ratios[i] = 1.0f;  // right on top of the listener, there's no direction to move along.
+            continue;
+        }
+
+        // how fast each end is moving toward the other.
+        const float scale = 1.0f / distance;
+        float listener_speed = ((lv[0] * dx) + (lv[1] * dy) + (lv[2] * dz)) * scale;
+        float source_speed = -((vx[i] * dx) + (vy[i] * dy) + (vz[i] * dz)) * scale;
+        listener_speed = SDL_clamp(listener_speed, -limit, limit);
+        source_speed = SDL_clamp(source_speed, -limit, limit);
+        ratios[i] = (speed_of_sound + listener_speed) / (speed_of_sound - source_speed);
+    }
+}
+
+
+// Ambisonics. Only horizontal (circular harmonic) components, since the spatializer only works in the horizontal plane.
+
+void MIX_AmbisonicEncodingGains(int order, float gain, float radians, float *gains)
+{
+    const float azimuth = -radians;  // ambisonics goes counterclockwise, the spatializer goes clockwise.
+    gains[0] = gain;
+    for (int m = 1; m <= order; m++) {
+        float sine, cosine;
+        calculate_sincos(m * azimuth, &sine, &cosine);
+        gains[(m * 2) - 1] = gain * cosine;
+        gains[m * 2] = gain * sine;
+    }
+}
+
+// One row of a "sampling" decoder, for a speaker at `azimuth`, out of `num_speakers` spread around the listener.
+//  `weights` shape each order's contribution (max-rE, usually). The result is scaled so a source's power
+//  across a regular layout comes out to 1, like the constant-power panning it replaces.
+static void ambisonic_decoder_row(const int order, const int num_speakers, const float *weights, const float azimuth, float *row)
+{
+    float power = 1.0f;
+    for (int m = 1; m <= order; m++) {
+        power += 2.0f * weights[m] * weights[m];
+    }
+    const float scale = SDL_sqrtf((float) num_speakers / power) / (float) num_speakers;
+
+    SDL_memset(row, '\0', sizeof (float) * MIX_AMBISONIC_MAX_CHANNELS);
+    row[0] = scale;
+    for (int m = 1; m <= order; m++) {
+        float sine, cosine;
+        calculate_sincos(m * azimuth, &sine, &cosine);
+        row[(m * 2) - 1] = scale * 2.0f * weights[m] * cosine;
+        row[m * 2] = scale * 2.0f * weights[m] * sine;
+    }
+}
+
+static void ambisonic_max_re_weights(const int order, float *weights)
+{
+    weights[0] = 1.0f;
+    for (int m = 1; m <= order; m++) {
+        weights[m] = SDL_cosf((m * SDL_PI_F) / ((order * 2) + 2));
+    }
+}
+
+void MIX_BuildAmbisonicDecoder(int order, int speaker_count, float *matrix)
+{
+    SDL_assert(speaker_count > 0);
+    SDL_assert(speaker_count <= MIX_VBAP2D_MAX_SPEAKER_COUNT);
+    SDL_assert((order > 0) && (order <= MIX_AMBISONIC_MAX_ORDER));
+
+    SDL_memset(matrix, '\0', sizeof (float) * speaker_count * MIX_AMBISONIC_MAX_CHANNELS);
+
+    if (speaker_count == 1) {  // mono just gets the omnidirectional part.
+        matrix[0] = 1.0f;
+        return;
+    } else if (speaker_count < 4) {  // stereo and 2.1: a pair of virtual cardioid microphones, pointing left and right.
+        static const float cardioid[2] = { 1.0f, 0.5f };
+        ambisonic_decoder_row(1, 2, cardioid, SDL_PI_F / 2.0f, &matrix[0 * MIX_AMBISONIC_MAX_CHANNELS]);
+        ambisonic_decoder_row(1, 2, cardioid, -SDL_PI_F / 2.0f, &matrix[1 * MIX_AMBISONIC_MAX_CHANNELS]);
+        return;
+    }
+
+    // surround: use the same speaker angles as VBAP does. The LFE channel's row stays zero.
+    const MIX_VBAP2D_SpeakerLayout *speaker_layout = &MIX_VBAP2D_SpeakerLayouts[speaker_count - 4];
+    const int num_speakers = speaker_count - ((speaker_layout->lfe_channel >= 0) ? 1 : 0);
+
+    // a decoder can't resolve more detail than the speakers can reproduce, so don't decode orders they can't.
+    const int decode_order = SDL_clamp((num_speakers - 1) / 2, 1, order);
+    float weights[MIX_AMBISONIC_MAX_ORDER + 1];
+    ambisonic_max_re_weights(decode_order, weights);
+
+    for (int i = 0; i < num_speakers; i++) {
+        const MIX_VBAP2D_SpeakerPosition *position = &speaker_layout->positions[i];
+        const float azimuth = MIX_VBAP2D_division_to_angle(position->division) - (SDL_PI_F / 2.0f);  // VBAP has the front at 90 degrees.
+        ambisonic_decoder_row(decode_order, num_speakers, weights, azimuth, &matrix[position->sdl_channel * MIX_AMBISONIC_MAX_CHANNELS]);
+    }
+}
+
+int MIX_BuildAmbisonicVirtualSpeakers(int order, float *matrix, float *radians)
+{
+    SDL_assert((order > 0) && (order <= MIX_AMBISONIC_MAX_ORDER));
+
+    const int num_speakers = (order * 2) + 2;
+    float weights[MIX_AMBISONIC_MAX_ORDER + 1];
+    ambisonic_max_re_weights(order, weights);
+
+    for (int i = 0; i < num_speakers; i++) {
+        const float azimuth = (i * 2.0f * SDL_PI_F) / num_speakers;
+        ambisonic_decoder_row(order, num_speakers, weights, azimuth, &matrix[i * MIX_AMBISONIC_MAX_CHANNELS]);
+        radians[i] = -azimuth;
+    }
+    return num_speakers;
+}
+
+
+// Binaural rendering.
+
+static void hrtf_fft(const MIX_HRTF *hrtf, float *re, float *im, const bool inverse)
+{
+    // plain iterative radix-2 Cooley-Tukey. The size is fixed and small, so this doesn't need to be fancy.
+    const int n = MIX_HRTF_FFT_SIZE;
+
+    for (int i = 0; i < n; i++) {
+        const int j = hrtf->fft_bitrev[i];
+        if (j > i) {
+            const float tre = re[i]; re[i] = re[j]; re[j] = tre;
+            const float tim = im[i]; im[i] = im[j]; im[j] = tim;
+        }
+    }
+
+    const float sign = inverse ? -1.0f : 1.0f;
+    for (int size = 2; size <= n; size *= 2) {
+        const int half = size / 2;
+        const int stride = n / size;
+        for (int start = 0; start < n; start += size) {
+            for (int k = 0; k < half; k++) {
+                const float wr = hrtf->fft_cos[k * stride];
+                const float wi = hrtf->fft_sin[k * stride] * sign;
+                const int a = start + k;
+                const int b = a + half;
+                const float tr = (re[b] * wr) - (im[b] * wi);
+                const float ti = (re[b] * wi) + (im[b] * wr);
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+            }
+        }
+    }
+}
+
+// acc += x * h, for `bins` complex numbers, stored as separate real and imaginary arrays.
+static void complex_multiply_accumulate_scalar(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re, const float *h_im, const int bins)
+{
+    for (int i = 0; i < bins; i++) {
+        acc_re[i] += (x_re[i] * h_re[i]) - (x_im[i] * h_im[i]);
+        acc_im[i] += (x_re[i] * h_im[i]) + (x_im[i] * h_re[i]);
+    }
+}
+
+#if defined(SDL_SSE_INTRINSICS)
+static void SDL_TARGETING("sse") complex_multiply_accumulate_sse(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re, const float *h_im, const int bins)
+{
+    int i = 0;
+    for (; i + 4 <= bins; i += 4) {
+        const __m128 xr = _mm_loadu_ps(x_re + i);
+        const __m128 xi = _mm_loadu_ps(x_im + i);
+        const __m128 hr = _mm_loadu_ps(h_re + i);
+        const __m128 hi = _mm_loadu_ps(h_im + i);
+        _mm_storeu_ps(acc_re + i, _mm_add_ps(_mm_loadu_ps(acc_re + i), _mm_sub_ps(_mm_mul_ps(xr, hr), _mm_mul_ps(xi, hi))));
+        _mm_storeu_ps(acc_im + i, _mm_add_ps(_mm_loadu_ps(acc_im + i), _mm_add_ps(_mm_mul_ps(xr, hi), _mm_mul_ps(xi, hr))));
+    }
+    complex_multiply_accumulate_scalar(acc_re + i, acc_im + i, x_re + i, x_im + i, h_re + i, h_im + i, bins - i);
+}
+#endif
+
+#if defined(SDL_NEON_INTRINSICS)
+static void complex_multiply_accumulate_neon(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re, const float *h_im, const int bins)
+{
+    int i = 0;
+    for (; i + 4 <= bins; i += 4) {
+        const float32x4_t xr = vld1q_f32(x_re + i);
+        const float32x4_t xi = vld1q_f32(x_im + i);
+        const float32x4_t hr = vld1q_f32(h_re + i);
+        const float32x4_t hi = vld1q_f32(h_im + i);
+        vst1q_f32(acc_re + i, vmlsq_f32(vmlaq_f32(vld1q_f32(acc_re + i), xr, hr), xi, hi));
+        vst1q_f32(acc_im + i, vmlaq_f32(vmlaq_f32(vld1q_f32(acc_im + i), xr, hi), xi, hr));
+    }
+    complex_multiply_accumulate_scalar(acc_re + i, acc_im + i, x_re + i, x_im + i, h_re + i, h_im + i, bins - i);
+}
+#endif
+
+static void complex_multiply_accumulate(float *acc_re, float *acc_im, const float *x_re, const float *x_im, const float *h_re, const float *h_im, const int bins)
+{
+    #if defined(SDL_SSE_INTRINSICS)
+    if (MIX_HasSSE) {
+        complex_multiply_accumulate_sse(acc_re, acc_im, x_re, x_im, h_re, h_im, bins);
+    } else
+    #elif defined(SDL_NEON_INTRINSICS)
+    if (MIX_HasNEON) {
+        complex_multiply_accumulate_neon(acc_re, acc_im, x_re, x_im, h_re, h_im, bins);
+    } else
+    #endif
+
+    {
+        complex_multiply_accumulate_scalar(acc_re, acc_im, x_re, x_im, h_re, h_im, bins);
+    }
+}
+
+static float *hrtf_filter_partition(const MIX_HRTF *hrtf, const int filter, const int ear, const int partition)
+{
+    return hrtf->filters + ((((filter * 2) + ear) * hrtf->num_partitions) + partition) * (MIX_HRTF_BINS * 2);
+}
+
+// 0 is straight ahead, counterclockwise (to the left), like SOFA files. radians are in the spatializer's
+//  convention: negative to the left, positive to the right.
+static int hrtf_azimuth_bucket(const float radians)
+{
+    const float bucket_size = (2.0f * SDL_PI_F) / MIX_HRTF_AZIMUTH_BUCKETS;
+    const int bucket = (int) SDL_floorf((-radians / bucket_size) + 0.5f) % MIX_HRTF_AZIMUTH_BUCKETS;
+    return (bucket < 0) ? (bucket + MIX_HRTF_AZIMUTH_BUCKETS) : bucket;
+}
+
+void MIX_DestroyHRTF(MIX_HRTF *hrtf)
+{
+    if (hrtf) {
+        SDL_free(hrtf->filters);
+        SDL_free(hrtf->hrirs);
+        SDL_free(hrtf->hrir_data);
+        SDL_free(hrtf);
+    }
+}
+
+MIX_HRTF *MIX_CreateHRTF(const MIX_HRIR *hrirs, int num_hrirs, int frames, int hrir_freq, int freq)
+{
+    MIX_HRTF *hrtf = (MIX_HRTF *) SDL_calloc(1, sizeof (*hrtf));
+    if (!hrtf) {
+        return NULL;
+    }
+
+    // keep a copy of the originals around, in case we have to rebuild for a new sample rate later.
+    const size_t hrir_bytes = sizeof (float) * frames * 2;
+    hrtf->hrirs = (MIX_HRIR *) SDL_calloc(num_hrirs, sizeof (MIX_HRIR));
+    hrtf->hrir_data = (float *) SDL_malloc(hrir_bytes * num_hrirs);
+    if (!hrtf->hrirs || !hrtf->hrir_data) {
+        MIX_DestroyHRTF(hrtf);
+        return NULL;
+    }
+    hrtf->num_hrirs = num_hrirs;
+    hrtf->hrir_frames = frames;
+    hrtf->hrir_freq = hrir_freq;
+    hrtf->freq = freq;
+
+    for (int i = 0; i < num_hrirs; i++) {
+        float *left = hrtf->hrir_data + (i * frames * 2);
+        float *right = left + frames;
+        SDL_memcpy(left, hrirs[i].left, sizeof (float) * frames);
+        SDL_memcpy(right, hrirs[i].right, sizeof (float) * frames);
+        hrtf->hrirs[i].azimuth = hrirs[i].azimuth;
+        hrtf->hrirs[i].elevation = hrirs[i].elevation;
+        hrtf->hrirs[i].left = left;
+        hrtf->hrirs[i].right = right;
+    }
+
+    // SDL_mixer only spatializes in the horizontal plane, so each azimuth bucket uses whatever HRIR is closest to
+    //  its direction at zero elevation. Only the HRIRs that some bucket actually uses get turned into filters.
+    int *hrir_filters = (int *) SDL_malloc(sizeof (int) * num_hrirs);
+    if (!hrir_filters) {
+        MIX_DestroyHRTF(hrtf);
+        return NULL;
+    }
+    for (int i = 0; i < num_hrirs; i++) {
+        hrir_filters[i] = -1;
+    }
+
+    int *filter_hrirs = (int *) SDL_malloc(sizeof (int) * MIX_HRTF_AZIMUTH_BUCKETS);
+    if (!filter_hrirs) {
+        SDL_free(hrir_filters);
+        MIX_DestroyHRTF(hrtf);
+        return NULL;
+    }
+
+    for (int bucket = 0; bucket < MIX_HRTF_AZIMUTH_BUCKETS; bucket++) {
+        const float azimuth = (bucket * 2.0f * SDL_PI_F) / MIX_HRTF_AZIMUTH_BUCKETS;
+        const float bx = SDL_cosf(azimuth);
+        const float by = SDL_sinf(azimuth);
+        int best = 0;
+        float best_dot = -2.0f;
+        for (int i = 0; i < num_hrirs; i++) {
+            const float az = hrirs[i].azimuth * (SDL_PI_F / 180.0f);
+            const float el = hrirs[i].elevation * (SDL_PI_F / 180.0f);
+            const float dot = SDL_cosf(el) * ((SDL_cosf(az) * bx) + (SDL_sinf(az) * by));
+            if (dot > best_dot) {
+                best_dot = dot;
+                best = i;
+            }
+        }
+        if (hrir_filters[best] < 0) {
+            filter_hrirs[hrtf->num_filters] = best;
+            hrir_filters[best] = hrtf->num_filters++;
+        }
+        hrtf->bucket_filters[bucket] = hrir_filters[best];
+    }
+    SDL_free(hrir_filters);
+
+    // resample the HRIRs we need to the mixer's rate. An impulse response gets louder as it gets more samples, so scale it back down, too.
+    const SDL_AudioSpec hrir_spec = { SDL_AUDIO_F32, 1, hrir_freq };
+    const SDL_AudioSpec spec = { SDL_AUDIO_F32, 1, freq };
+    const float rate_scale = (float) hrir_freq / (float) freq;
+    float **resampled = (float **) SDL_calloc(hrtf->num_filters * 2, sizeof (float *));
+    int *resampled_frames = (int *) SDL_calloc(hrtf->num_filters * 2, sizeof (int));
+    bool okay = (resampled && resampled_frames);
+    int max_frames = 0;
+    for (int i = 0; okay && (i < hrtf->num_filters * 2); i++) {
+        const MIX_HRIR *hrir = &hrtf->hrirs[filter_hrirs[i / 2]];
+        const float *ir = (i & 1) ? hrir->right : hrir->left;
+        if (hrir_freq == freq) {
+            resampled[i] = (float *) SDL_malloc(sizeof (float) * frames);
+            okay = (resampled[i] != NULL);
+            if (okay) {
+                SDL_memcpy(resampled[i], ir, sizeof (float) * frames);
+                resampled_frames[i] = frames;
+            }
+        } else {
+            int len = 0;
+            okay = SDL_ConvertAudioSamples(&hrir_spec, (const Uint8 *) ir, (int) (sizeof (float) * frames), &spec, (Uint8 **) &resampled[i], &len);
+            if (okay) {
+                resampled_frames[i] = SDL_min(len / (int) sizeof (float), MIX_HRTF_MAX_FRAMES);
+                for (int j = 0; j < resampled_frames[i]; j++) {
+                    resampled[i][j] *= rate_scale;
+                }
+            }
+        }
+        if (okay) {
+            max_frames = SDL_max(max_frames, resampled_frames[i]);
+        }
+    }
+    SDL_free(filter_hrirs);
+
+    if (okay) {
+        hrtf->num_partitions = SDL_max(1, (max_frames + (MIX_HRTF_PARTITION_FRAMES - 1)) / MIX_HRTF_PARTITION_FRAMES);
+        hrtf->filters = (float *) SDL_calloc((size_t) hrtf->num_filters * 2 * hrtf->num_partitions * MIX_HRTF_BINS * 2, sizeof (float));
+        okay = (hrtf->filters != NULL);
+    }
+
+    if (okay) {
+        for (int i = 0; i < MIX_HRTF_FFT_SIZE / 2; i++) {
+            const float angle = (-2.0f * SDL_PI_F * i) / MIX_HRTF_FFT_SIZE;
+            hrtf->fft_cos[i] = SDL_cosf(angle);
+            hrtf->fft_sin[i] = SDL_sinf(angle);
+        }
+        int bits = 0;
+        while ((1 << bits) < MIX_HRTF_FFT_SIZE) {
+            bits++;
+        }
+        for (int i = 0; i < MIX_HRTF_FFT_SIZE; i++) {
+            int reversed = 0;
+            for (int bit = 0; bit < bits; bit++) {
+                if (i & (1 << bit)) {
+                    reversed |= 1 << (bits - 1 - bit);
+                }
+            }
+            hrtf->fft_bitrev[i] = reversed;
+        }
+
+        // each partition of each impulse response is zero-padded to the FFT size and transformed once, up front.
+        //  The inverse FFT's 1/N scaling is folded in here, too, so rendering doesn't have to do it.
+        float re[MIX_HRTF_FFT_SIZE];
+        float im[MIX_HRTF_FFT_SIZE];
+        const float scale = 1.0f / MIX_HRTF_FFT_SIZE;
+        for (int i = 0; i < hrtf->num_filters * 2; i++) {
+            for (int partition = 0; partition < hrtf->num_partitions; partition++) {
+                const int offset = partition * MIX_HRTF_PARTITION_FRAMES;
+                const int available = SDL_clamp(resampled_frames[i] - offset, 0, MIX_HRTF_PARTITION_FRAMES);
+                SDL_zeroa(re);
+                SDL_zeroa(im);
+                for (int j = 0; j < available; j++) {
+                    re[j] = resampled[i][offset + j] * scale;
+                }
+                hrtf_fft(hrtf, re, im, false);
+                float *spectrum = hrtf_filter_partition(hrtf, i / 2, i & 1, partition);
+                SDL_memcpy(spectrum, re, sizeof (float) * MIX_HRTF_BINS);
+                SDL_memcpy(spectrum + MIX_HRTF_BINS, im, sizeof (float) * MIX_HRTF_BINS);
+            }
+        }
+    }
+
+    if (resampled) {
+        for (int i = 0; i < hrtf->num_filters * 2; i++) {
+            SDL_free(resampled[i]);
+        }
+    }
+    SDL_free(resampled);
+    SDL_free(resampled_frames);
+
+    if (!okay) {
+        MIX_DestroyHRTF(hrtf);
+        return NULL;
+    }
+
+    return hrtf;
+}
+
+MIX_BinauralState *MIX_CreateBinauralState(const MIX_HRTF *hrtf)
+{
+    const size_t spectrum_floats = MIX_HRTF_BINS * 2;
+    const size_t total_floats = (spectrum_floats * hrtf->num_partitions) +  // fdl
+                                MIX_HRTF_FFT_SIZE +                         // input
+                                (MIX_HRTF_PARTITION_FRAMES * 2) +           // output
+                                (MIX_HRTF_FFT_SIZE * 2) +                   // work_re, work_im
+                                spectrum_floats;                            // acc
+
+    MIX_BinauralState *state = (MIX_BinauralState *) SDL_calloc(1, sizeof (*state) + (sizeof (float) * total_floats));
+    if (!state) {
+        return NULL;
+    }
+
+    float *ptr = (float *) (state + 1);
+    state->hrtf = hrtf;
+    state->fdl = ptr; ptr += spectrum_floats * hrtf->num_partitions;
+    state->input = ptr; ptr += MIX_HRTF_FFT_SIZE;
+    state->output = ptr; ptr += MIX_HRTF_PARTITION_FRAMES * 2;
+    state->work_re = ptr; ptr += MIX_HRTF_FFT_SIZE;
+    state->work_im = ptr; ptr += MIX_HRTF_FFT_SIZE;
+    state->acc = ptr;
+    state->filter = -1;
+    return state;
+}
+
+void MIX_DestroyBinauralState(MIX_BinauralState *state)
+{
+    SDL_free(state);  // it's all one allocation.
+}
+
+// Run one ear's filter over the delay line; the result ends up in the second half of state->work_re.
+static void convolve_partition(const MIX_HRTF *hrtf, MIX_BinauralState *state, const int filter, const int ear)
+{
+    float *acc_re = state->acc;
+    float *acc_im = state->acc + MIX_HRTF_BINS;
+    SDL_memset(state->acc, '\0', sizeof (float) * MIX_HRTF_BINS * 2);
+
+    const int num_partitions = hrtf->num_partitions;
+    for (int partition = 0; partition < num_partitions; partition++) {
+        const int slot = ((state->fdl_head - partition) + num_partitions) % num_partitions;
+        const float *x = state->fdl + (slot * MIX_HRTF_BINS * 2);
+        const float *h = hrtf_filter_partition(hrtf, filter, ear, partition);
+        complex_multiply_accumulate(acc_re, acc_im, x, x + MIX_HRTF_BINS, h, h + MIX_HRTF_BINS, MIX_HRTF_BINS);
+    }
+
+    // rebuild the full spectrum from the half we kept (it's conjugate-symmetric, since the signal is real), and transform back.
+    float *re = state->work_re;
+    float *im = state->work_im;
+    SDL_memcpy(re, acc_re, sizeof (float) * MIX_HRTF_BINS);
+    SDL_memcpy(im, acc_im, sizeof (float) * MIX_HRTF_BINS);
+    for (int i = MIX_HRTF_BINS; i < MIX_HRTF_FFT_SIZE; i++) {
+        re[i] = acc_re[MIX_HRTF_FFT_SIZE - i];
+        im[i] = -acc_im[MIX_HRTF_FFT_SIZE - i];
+    }
+    hrtf_fft(hrtf, re, im, true);
+}
+
+static void process_binaural_partition(const MIX_HRTF *hrtf, MIX_BinauralState *state, const int filter)
+{
+    // transform the last two partitions of input (overlap-save), and push the spectrum onto the delay line.
+    state->fdl_head = (state->fdl_head + 1) % hrtf->num_partitions;
+    SDL_memcpy(state->work_re, state->input, sizeof (float) * MIX_HRTF_FFT_SIZE);
+    SDL_memset(state->work_im, '\0', sizeof (float) * MIX_HRTF_FFT_SIZE);
+    hrtf_fft(hrtf, state->work_re, state->work_im, false);
+    float *x = state->fdl + (state->fdl_head * MIX_HRTF_BINS * 2);
+    SDL_memcpy(x, state->work_re, sizeof (float) * MIX_HRTF_BINS);
+    SDL_memcpy(x + MIX_HRTF_BINS, state->work_im, sizeof (float) * MIX_HRTF_BINS);
+
+    // only the second half of the circular convolution is valid output.
+    const float *valid = state->work_re + MIX_HRTF_PARTITION_FRAMES;
+    float *output = state->output;
+    const int old_filter = state->filter;
+    if ((old_filter < 0) || (old_filter == filter)) {
+        for (int ear = 0; ear < 2; ear++) {
+            convolve_partition(hrtf, state, filter, ear);
+            for (int i = 0; i < MIX_HRTF_PARTITION_FRAMES; i++) {
+                output[(i * 2) + ear] = valid[i];
+            }
+        }
+    } else {
+        // the source moved to a different HRIR; render with both, and crossfade across this partition so it doesn't click.
+        const float step = 1.0f / MIX_HRTF_PARTITION_FRAMES;
+        for (int ear = 0; ear < 2; ear++) {
+            convolve_partition(hrtf, state, old_filter, ear);
+            for (int i = 0; i < MIX_HRTF_PARTITION_FRAMES; i++) {
+                output[(i * 2) + ear] = valid[i] * (1.0f - (step * (i + 1)));
+            }
+            convolve_partition(hrtf, state, filter, ear);
+            for (int i = 0; i < MIX_HRTF_PARTITION_FRAMES; i++) {
+                output[(i * 2) + ear] += valid[i] * (step * (i + 1));
+            }
+        }
+    }
+    state->filter = filter;
+
+    // this partition becomes the first half of the next FFT.
+    SDL_memcpy(state->input, state->input + MIX_HRTF_PARTITION_FRAMES, sizeof (float) * MIX_HRTF_PARTITION_FRAMES);
+}
+
+void MIX_RenderBinaural(const MIX_HRTF *hrtf, MIX_BinauralState *state, const float *src, int samples, float radians, float gain, float *dst)
+{
+    SDL_assert(state->hrtf == hrtf);
+
+    if (!state->primed) {  // new, or the track stopped since we last used this; don't let old audio leak in.
+        SDL_memset(state->fdl, '\0', sizeof (float) * MIX_HRTF_BINS * 2 * hrtf->num_partitions);
+        SDL_memset(state->input, '\0', sizeof (float) * MIX_HRTF_FFT_SIZE);
+        SDL_memset(state->output, '\0', sizeof (float) * MIX_HRTF_PARTITION_FRAMES * 2);
+        state->fill = 0;
+        state->fdl_head = 0;
+        state->filter = -1;
+        state->primed = true;
+    }
+
+    const int filter = hrtf->bucket_filters[hrtf_azimuth_bucket(radians)];
+
+    while (samples > 0) {
+        const int cpy = SDL_min(samples, MIX_HRTF_PARTITION_FRAMES - state->fill);
+        SDL_memcpy(state->input + MIX_HRTF_PARTITION_FRAMES + state->fill, src, sizeof (float) * cpy);
+
+        const float *output = state->output + (state->fill * 2);
+        for (int i = 0; i < cpy * 2; i++) {
+            dst[i] += output[i] * gain;
+        }
+
+        src += cpy;
+        dst += cpy * 2;
+        samples -= cpy;
+        state->fill += cpy;
+        if (state->fill == MIX_HRTF_PARTITION_FRAMES) {
+            process_binaural_partition(hrtf, state, filter);
+            state->fill = 0;
+        }
+    }
+}
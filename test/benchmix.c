@@ -0,0 +1,1098 @@
+/*
+  benchmix: headless throughput benchmark for SDL_mixer.
+
+  This drives MIX_CreateMixer() + MIX_Generate() as fast as possible and
+  reports real-time factors (seconds of audio produced per second of wall
+  clock time) as JSON, so results can be compared across releases and
+  between scalar and SIMD builds.
+
+  All test assets are generated in memory, so no data files are needed.
+
+  USAGE: benchmix [--quick] [--seconds N] [--max-tracks N] [--threads N]
+                  [--channels N] [--freq N] [--output file.json]
+*/
+
+#include <stdio.h>
+
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_main.h>
+#include "SDL3_mixer/SDL_mixer.h"
+
+#ifndef SDL_MIXER_FORCE_SCALAR_FALLBACK
+#define SDL_MIXER_FORCE_SCALAR_FALLBACK 0
+#endif
+
+#define ASSET_FREQ 44100
+#define ASSET_CHANNELS 2
+#define ASSET_FRAMES (4096 * 11)  // a hair over one second; a multiple of the FLAC and Vorbis block sizes.
+#define CHUNK_FRAMES 1024
+
+typedef enum BenchSpatialization
+{
+    BENCH_SPATIALIZATION_NONE,
+    BENCH_SPATIALIZATION_STEREO,
+    BENCH_SPATIALIZATION_3D
+} BenchSpatialization;
+
+static const char *spatialization_names[] = { "none", "stereo", "3d" };
+
+typedef struct ByteBuffer
+{
+    Uint8 *data;
+    size_t len;
+    size_t allocated;
+    bool failed;
+} ByteBuffer;
+
+typedef struct BitWriter
+{
+    ByteBuffer *buf;
+    Uint32 bits;
+    int numbits;
+} BitWriter;
+
+typedef struct BenchAsset
+{
+    const char *name;      // name of the asset in the report.
+    const char *decoder;   // decoder to force, so we measure what we think we're measuring.
+    ByteBuffer data;
+} BenchAsset;
+
+static SDL_IOStream *output = NULL;
+static bool first_result = true;
+static double bench_seconds = 2.0;
+static int max_tracks = 2000;
+static int render_threads = 0;
+static bool quick = false;
+
+
+// Byte buffer helpers...
+
+static void PutBytes(ByteBuffer *buf, const void *data, size_t len)
+{
+    if (buf->failed) {
+        return;
+    } else if ((buf->len + len) > buf->allocated) {
+        size_t newlen = buf->allocated ? buf->allocated : 1024;
+        while (newlen < (buf->len + len)) {
+            newlen *= 2;
+        }
+        void *ptr = SDL_realloc(buf->data, newlen);
+        if (!ptr) {
+            buf->failed = true;
+            return;
+        }
+        buf->data = (Uint8 *) ptr;
+        buf->allocated = newlen;
+    }
+    SDL_memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+}
+
+static void Put8(ByteBuffer *buf, Uint8 val) { PutBytes(buf, &val, 1); }
+static void Put16LE(ByteBuffer *buf, Uint16 val) { Put8(buf, (Uint8) val); Put8(buf, (Uint8) (val >> 8)); }
+static void Put32LE(ByteBuffer *buf, Uint32 val) { Put16LE(buf, (Uint16) val); Put16LE(buf, (Uint16) (val >> 16)); }
+static void Put16BE(ByteBuffer *buf, Uint16 val) { Put8(buf, (Uint8) (val >> 8)); Put8(buf, (Uint8) val); }
+static void Put32BE(ByteBuffer *buf, Uint32 val) { Put16BE(buf, (Uint16) (val >> 16)); Put16BE(buf, (Uint16) val); }
+static void PutString(ByteBuffer *buf, const char *str) { PutBytes(buf, str, SDL_strlen(str)); }
+
+static void Patch32LE(ByteBuffer *buf, size_t offset, Uint32 val)
+{
+    if (!buf->failed) {
+        buf->data[offset + 0] = (Uint8) val;
+        buf->data[offset + 1] = (Uint8) (val >> 8);
+        buf->data[offset + 2] = (Uint8) (val >> 16);
+        buf->data[offset + 3] = (Uint8) (val >> 24);
+    }
+}
+
+static void Patch32BE(ByteBuffer *buf, size_t offset, Uint32 val)
+{
+    if (!buf->failed) {
+        buf->data[offset + 0] = (Uint8) (val >> 24);
+        buf->data[offset + 1] = (Uint8) (val >> 16);
+        buf->data[offset + 2] = (Uint8) (val >> 8);
+        buf->data[offset + 3] = (Uint8) val;
+    }
+}
+
+// Vorbis packs bits starting at the least significant bit of each byte...
+static void PutBitsLSB(BitWriter *bw, Uint32 val, int numbits)
+{
+    for (int i = 0; i < numbits; i++) {
+        bw->bits |= ((val >> i) & 1) << bw->numbits;
+        if (++bw->numbits == 8) {
+            Put8(bw->buf, (Uint8) bw->bits);
+            bw->bits = 0;
+            bw->numbits = 0;
+        }
+    }
+}
+
+// ...and FLAC packs them starting at the most significant bit.
+static void PutBitsMSB(BitWriter *bw, Uint32 val, int numbits)
+{
+    for (int i = numbits - 1; i >= 0; i--) {
+        bw->bits = (bw->bits << 1) | ((val >> i) & 1);
+        if (++bw->numbits == 8) {
+            Put8(bw->buf, (Uint8) bw->bits);
+            bw->bits = 0;
+            bw->numbits = 0;
+        }
+    }
+}
+
+static void FlushBitsLSB(BitWriter *bw)
+{
+    if (bw->numbits) {
+        PutBitsLSB(bw, 0, 8 - bw->numbits);
+    }
+}
+
+static void FlushBitsMSB(BitWriter *bw)
+{
+    if (bw->numbits) {
+        PutBitsMSB(bw, 0, 8 - bw->numbits);
+    }
+}
+
+
+// The test signal: a different sine wave in each channel, with a little headroom.
+
+static Sint16 TestSample(int frame, int channel)
+{
+    const float hz = (channel == 0) ? 440.0f : 660.0f;
+    return (Sint16) (SDL_sinf(((float) frame) * hz * (2.0f * SDL_PI_F) / ((float) ASSET_FREQ)) * 16000.0f);
+}
+
+
+// Asset generators...
+
+static void GenerateWAVPCM(ByteBuffer *buf)
+{
+    const Uint32 datalen = ASSET_FRAMES * ASSET_CHANNELS * sizeof (Sint16);
+    PutString(buf, "RIFF");
+    Put32LE(buf, 4 + (8 + 16) + (8 + datalen));
+    PutString(buf, "WAVE");
+    PutString(buf, "fmt ");
+    Put32LE(buf, 16);
+    Put16LE(buf, 1);  // PCM
+    Put16LE(buf, ASSET_CHANNELS);
+    Put32LE(buf, ASSET_FREQ);
+    Put32LE(buf, ASSET_FREQ * ASSET_CHANNELS * sizeof (Sint16));
+    Put16LE(buf, ASSET_CHANNELS * sizeof (Sint16));
+    Put16LE(buf, 16);
+    PutString(buf, "data");
+    Put32LE(buf, datalen);
+    for (int i = 0; i < ASSET_FRAMES; i++) {
+        for (int c = 0; c < ASSET_CHANNELS; c++) {
+            Put16LE(buf, (Uint16) TestSample(i, c));
+        }
+    }
+}
+
+static const Sint16 ima_step_table[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31, 34, 37, 41,
+    45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143, 157, 173, 190,
+    209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+    876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499,
+    2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845,
+    8630, 9493, 10442, 11487, 12635, 13899, 15289, 16818, 18500, 20350,
+    22385, 24623, 27086, 29794, 32767
+};
+
+static Uint8 EncodeIMANibble(Sint32 *predictor, int *index, Sint16 sample)
+{
+    const Sint32 step = ima_step_table[*index];
+    Sint32 diff = ((Sint32) sample) - *predictor;
+    Uint8 nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+
+    Sint32 delta = step >> 3;
+    if (diff >= step) { nibble |= 4; diff -= step; delta += step; }
+    if (diff >= (step >> 1)) { nibble |= 2; diff -= step >> 1; delta += step >> 1; }
+    if (diff >= (step >> 2)) { nibble |= 1; delta += step >> 2; }
+
+    *predictor += (nibble & 8) ? -delta : delta;
+    *predictor = SDL_clamp(*predictor, -32768, 32767);
+
+    static const int index_table[8] = { -1, -1, -1, -1, 2, 4, 6, 8 };
+    *index = SDL_clamp(*index + index_table[nibble & 7], 0, 88);
+    return nibble;
+}
+
+static void GenerateWAVADPCM(ByteBuffer *buf)
+{
+    const int blockalign = 1024;
+    const int headersize = 4 * ASSET_CHANNELS;
+    const int samplesperblock = ((blockalign - headersize) * 8) / (4 * ASSET_CHANNELS) + 1;
+    const int numblocks = (ASSET_FRAMES + samplesperblock - 1) / samplesperblock;
+    const Uint32 datalen = (Uint32) (numblocks * blockalign);
+
+    PutString(buf, "RIFF");
+    Put32LE(buf, 4 + (8 + 20) + (8 + 4) + (8 + datalen));
+    PutString(buf, "WAVE");
+    PutString(buf, "fmt ");
+    Put32LE(buf, 20);
+    Put16LE(buf, 0x0011);  // IMA ADPCM
+    Put16LE(buf, ASSET_CHANNELS);
+    Put32LE(buf, ASSET_FREQ);
+    Put32LE(buf, (Uint32) ((ASSET_FREQ * blockalign) / samplesperblock));
+    Put16LE(buf, (Uint16) blockalign);
+    Put16LE(buf, 4);
+    Put16LE(buf, 2);  // cbSize
+    Put16LE(buf, (Uint16) samplesperblock);
+    PutString(buf, "fact");
+    Put32LE(buf, 4);
+    Put32LE(buf, (Uint32) (numblocks * samplesperblock));
+    PutString(buf, "data");
+    Put32LE(buf, datalen);
+
+    Sint32 predictor[ASSET_CHANNELS];
+    int index[ASSET_CHANNELS];
+    SDL_zeroa(index);
+
+    for (int block = 0; block < numblocks; block++) {
+        const int first = block * samplesperblock;
+        for (int c = 0; c < ASSET_CHANNELS; c++) {
+            predictor[c] = TestSample(first, c);
+            Put16LE(buf, (Uint16) (Sint16) predictor[c]);
+            Put8(buf, (Uint8) index[c]);
+            Put8(buf, 0);
+        }
+
+        // the rest of the block is groups of 8 samples per channel, 4 bytes each, interleaved by channel.
+        for (int i = 1; i < samplesperblock; i += 8) {
+            for (int c = 0; c < ASSET_CHANNELS; c++) {
+                for (int j = 0; j < 8; j += 2) {
+                    const Uint8 lo = EncodeIMANibble(&predictor[c], &index[c], TestSample(first + i + j, c));
+                    const Uint8 hi = EncodeIMANibble(&predictor[c], &index[c], TestSample(first + i + j + 1, c));
+                    Put8(buf, (Uint8) (lo | (hi << 4)));
+                }
+            }
+        }
+    }
+}
+
+static void GenerateAIFF(ByteBuffer *buf)
+{
+    const Uint32 datalen = ASSET_FRAMES * ASSET_CHANNELS * sizeof (Sint16);
+    PutString(buf, "FORM");
+    Put32BE(buf, 4 + (8 + 18) + (8 + 8 + datalen));
+    PutString(buf, "AIFF");
+    PutString(buf, "COMM");
+    Put32BE(buf, 18);
+    Put16BE(buf, ASSET_CHANNELS);
+    Put32BE(buf, ASSET_FRAMES);
+    Put16BE(buf, 16);
+
+    // sample rate is an 80-bit IEEE 754 extended float.
+    int exponent = 0;
+    while ((ASSET_FREQ >> (exponent + 1)) != 0) {
+        exponent++;
+    }
+    Put16BE(buf, (Uint16) (16383 + exponent));
+    Put32BE(buf, ((Uint32) ASSET_FREQ) << (31 - exponent));
+    Put32BE(buf, 0);
+
+    PutString(buf, "SSND");
+    Put32BE(buf, 8 + datalen);
+    Put32BE(buf, 0);  // offset
+    Put32BE(buf, 0);  // block size
+    for (int i = 0; i < ASSET_FRAMES; i++) {
+        for (int c = 0; c < ASSET_CHANNELS; c++) {
+            Put16BE(buf, (Uint16) TestSample(i, c));
+        }
+    }
+}
+
+static void GenerateVOC(ByteBuffer *buf)
+{
+    // VOC files in the wild are almost always the classic 8-bit mono kind, at about 22kHz.
+    const Uint8 time_constant = 211;  // 1000000 / (256 - 211) == 22222Hz
+    const Uint32 numframes = ASSET_FRAMES / 2;
+    const Uint32 blocklen = numframes + 2;
+    PutString(buf, "Creative Voice File\x1A");
+    Put16LE(buf, 26);      // offset of first data block
+    Put16LE(buf, 0x010A);  // version 1.10
+    Put16LE(buf, (Uint16) (~0x010A + 0x1234));
+    Put8(buf, 1);  // VOC_DATA
+    Put8(buf, (Uint8) (blocklen & 0xFF));
+    Put8(buf, (Uint8) ((blocklen >> 8) & 0xFF));
+    Put8(buf, (Uint8) ((blocklen >> 16) & 0xFF));
+    Put8(buf, time_constant);
+    Put8(buf, 0);  // codec: 8-bit unsigned PCM
+    for (Uint32 i = 0; i < numframes; i++) {
+        Put8(buf, (Uint8) ((TestSample((int) (i * 2), 0) >> 8) + 128));
+    }
+    Put8(buf, 0);  // VOC_TERM
+}
+
+static void GenerateAU(ByteBuffer *buf)
+{
+    PutString(buf, ".snd");
+    Put32BE(buf, 24);  // header size
+    Put32BE(buf, ASSET_FRAMES * ASSET_CHANNELS * sizeof (Sint16));
+    Put32BE(buf, 3);  // 16-bit linear PCM
+    Put32BE(buf, ASSET_FREQ);
+    Put32BE(buf, ASSET_CHANNELS);
+    for (int i = 0; i < ASSET_FRAMES; i++) {
+        for (int c = 0; c < ASSET_CHANNELS; c++) {
+            Put16BE(buf, (Uint16) TestSample(i, c));
+        }
+    }
+}
+
+static void GenerateMP3(ByteBuffer *buf)
+{
+    // Writing an MP3 encoder is out of scope, so these are valid MPEG-1
+    // Layer III frames (128kbps, 44.1kHz, stereo) whose granules are all
+    // silent. The decoder still does its full synthesis work on them.
+    const int framelen = (144 * 128000) / ASSET_FREQ;
+    const int numframes = (ASSET_FRAMES + 1151) / 1152;
+    for (int i = 0; i < numframes; i++) {
+        Put8(buf, 0xFF);
+        Put8(buf, 0xFB);  // MPEG-1, Layer III, no CRC
+        Put8(buf, 0x90);  // 128kbps, 44100Hz, no padding
+        Put8(buf, 0x00);  // stereo
+        for (int j = 4; j < framelen; j++) {
+            Put8(buf, 0);  // side info and main data, all zero.
+        }
+    }
+}
+
+static Uint8 FLACCRC8(const Uint8 *data, size_t len)
+{
+    Uint8 crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++) {
+            crc = (Uint8) ((crc & 0x80) ? ((crc << 1) ^ 0x07) : (crc << 1));
+        }
+    }
+    return crc;
+}
+
+static Uint16 FLACCRC16(const Uint8 *data, size_t len)
+{
+    Uint16 crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= (Uint16) (data[i] << 8);
+        for (int j = 0; j < 8; j++) {
+            crc = (Uint16) ((crc & 0x8000) ? ((crc << 1) ^ 0x8005) : (crc << 1));
+        }
+    }
+    return crc;
+}
+
+static void GenerateFLAC(ByteBuffer *buf)
+{
+    // VERBATIM subframes, so this measures the container and bitreader, not the LPC math.
+    const int blocksize = 4096;
+    const int numframes = ASSET_FRAMES / blocksize;
+    BitWriter bw = { buf, 0, 0 };
+
+    PutString(buf, "fLaC");
+    Put8(buf, 0x80);  // last metadata block, STREAMINFO
+    Put8(buf, 0);
+    Put8(buf, 0);
+    Put8(buf, 34);
+    Put16BE(buf, (Uint16) blocksize);
+    Put16BE(buf, (Uint16) blocksize);
+    Put8(buf, 0); Put16BE(buf, 0);  // min frame size: unknown
+    Put8(buf, 0); Put16BE(buf, 0);  // max frame size: unknown
+    PutBitsMSB(&bw, ASSET_FREQ, 20);
+    PutBitsMSB(&bw, ASSET_CHANNELS - 1, 3);
+    PutBitsMSB(&bw, 16 - 1, 5);
+    PutBitsMSB(&bw, 0, 4);
+    PutBitsMSB(&bw, ASSET_FRAMES, 32);
+    for (int i = 0; i < 16; i++) {
+        Put8(buf, 0);  // no MD5 signature
+    }
+
+    for (int frame = 0; frame < numframes; frame++) {
+        const size_t framestart = buf->len;
+        PutBitsMSB(&bw, 0x3FFE, 14);  // sync code
+        PutBitsMSB(&bw, 0, 1);
+        PutBitsMSB(&bw, 0, 1);  // fixed blocksize
+        PutBitsMSB(&bw, 12, 4);  // 4096 samples
+        PutBitsMSB(&bw, 9, 4);  // 44.1kHz
+        PutBitsMSB(&bw, ASSET_CHANNELS - 1, 4);  // independent channels
+        PutBitsMSB(&bw, 4, 3);  // 16 bits per sample
+        PutBitsMSB(&bw, 0, 1);
+        SDL_assert(frame < 128);  // one-byte UTF-8 coded frame number
+        PutBitsMSB(&bw, (Uint32) frame, 8);
+        if (buf->failed) {
+            return;
+        }
+        Put8(buf, FLACCRC8(buf->data + framestart, buf->len - framestart));
+
+        for (int c = 0; c < ASSET_CHANNELS; c++) {
+            PutBitsMSB(&bw, 0x02, 8);  // VERBATIM, no wasted bits
+            for (int i = 0; i < blocksize; i++) {
+                PutBitsMSB(&bw, (Uint16) TestSample((frame * blocksize) + i, c), 16);
+            }
+        }
+        FlushBitsMSB(&bw);
+        if (buf->failed) {
+            return;
+        }
+        Put16BE(buf, FLACCRC16(buf->data + framestart, buf->len - framestart));
+    }
+}
+
+static Uint32 OggCRC(const Uint8 *data, size_t len)
+{
+    Uint32 crc = 0;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= ((Uint32) data[i]) << 24;
+        for (int j = 0; j < 8; j++) {
+            crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void PutOggPage(ByteBuffer *buf, Uint8 flags, Uint64 granule, Uint32 sequence, const ByteBuffer *packets, const int *packetlens, int numpackets)
+{
+    const size_t pagestart = buf->len;
+    PutString(buf, "OggS");
+    Put8(buf, 0);  // version
+    Put8(buf, flags);
+    Put32LE(buf, (Uint32) granule);
+    Put32LE(buf, (Uint32) (granule >> 32));
+    Put32LE(buf, 0x534D4958);  // serial number
+    Put32LE(buf, sequence);
+    Put32LE(buf, 0);  // CRC, patched below.
+
+    int numsegments = 0;
+    for (int i = 0; i < numpackets; i++) {
+        numsegments += (packetlens[i] / 255) + 1;
+    }
+    SDL_assert(numsegments <= 255);
+    Put8(buf, (Uint8) numsegments);
+    for (int i = 0; i < numpackets; i++) {
+        int len = packetlens[i];
+        while (len >= 255) {
+            Put8(buf, 255);
+            len -= 255;
+        }
+        Put8(buf, (Uint8) len);
+    }
+    PutBytes(buf, packets->data, packets->len);
+
+    if (!buf->failed) {
+        Patch32LE(buf, pagestart + 22, OggCRC(buf->data + pagestart, buf->len - pagestart));
+    }
+}
+
+static void GenerateVorbis(ByteBuffer *buf)
+{
+    // The smallest legal Vorbis setup: one codebook, one floor1 with no
+    // partitions, one residue, one mapping, one mode with 2048-sample
+    // blocks. Every audio packet marks each channel's floor as unused, so
+    // this decodes to silence, but still goes through the full inverse MDCT
+    // and overlap-add for each block.
+    const int blocksize = 2048;
+    const int numpackets = (ASSET_FRAMES / (blocksize / 2)) + 1;  // the first block only primes the overlap.
+    ByteBuffer packets;
+    int packetlens[3];
+    BitWriter bw = { &packets, 0, 0 };
+
+    // identification header, on its own page.
+    SDL_zero(packets);
+    Put8(&packets, 1);
+    PutString(&packets, "vorbis");
+    Put32LE(&packets, 0);  // version
+    Put8(&packets, ASSET_CHANNELS);
+    Put32LE(&packets, ASSET_FREQ);
+    Put32LE(&packets, 0);  // bitrate maximum
+    Put32LE(&packets, 0);  // bitrate nominal
+    Put32LE(&packets, 0);  // bitrate minimum
+    Put8(&packets, (11 << 4) | 11);  // both blocksizes are 2^11
+    Put8(&packets, 1);  // framing
+    packetlens[0] = (int) packets.len;
+    PutOggPage(buf, 0x02, 0, 0, &packets, packetlens, 1);
+
+    // comment and setup headers share the second page.
+    packets.len = 0;
+    Put8(&packets, 3);
+    PutString(&packets, "vorbis");
+    Put32LE(&packets, 8);
+    PutString(&packets, "benchmix");
+    Put32LE(&packets, 0);  // no user comments
+    Put8(&packets, 1);  // framing
+    packetlens[0] = (int) packets.len;
+
+    Put8(&packets, 5);
+    PutString(&packets, "vorbis");
+    PutBitsLSB(&bw, 0, 8);  // one codebook
+    PutBitsLSB(&bw, 0x564342, 24);
+    PutBitsLSB(&bw, 1, 16);  // dimensions
+    PutBitsLSB(&bw, 2, 24);  // entries
+    PutBitsLSB(&bw, 0, 1);  // not ordered
+    PutBitsLSB(&bw, 0, 1);  // not sparse
+    PutBitsLSB(&bw, 0, 5);  // entry 0 is 1 bit long
+    PutBitsLSB(&bw, 0, 5);  // entry 1 is 1 bit long
+    PutBitsLSB(&bw, 0, 4);  // no lookup table
+    PutBitsLSB(&bw, 0, 6);  // one time domain transform...
+    PutBitsLSB(&bw, 0, 16);  // ...which is a placeholder.
+    PutBitsLSB(&bw, 0, 6);  // one floor...
+    PutBitsLSB(&bw, 1, 16);  // ...of type 1...
+    PutBitsLSB(&bw, 0, 5);  // ...with no partitions
+    PutBitsLSB(&bw, 0, 2);  // multiplier 1
+    PutBitsLSB(&bw, 10, 4);  // rangebits
+    PutBitsLSB(&bw, 0, 6);  // one residue...
+    PutBitsLSB(&bw, 0, 16);  // ...of type 0...
+    PutBitsLSB(&bw, 0, 24);  // ...begin...
+    PutBitsLSB(&bw, 0, 24);  // ...end...
+    PutBitsLSB(&bw, 0, 24);  // ...partition size 1...
+    PutBitsLSB(&bw, 0, 6);  // ...one classification...
+    PutBitsLSB(&bw, 0, 8);  // ...using codebook 0...
+    PutBitsLSB(&bw, 0, 3);  // ...with no cascade books.
+    PutBitsLSB(&bw, 0, 1);
+    PutBitsLSB(&bw, 0, 6);  // one mapping...
+    PutBitsLSB(&bw, 0, 16);  // ...of type 0...
+    PutBitsLSB(&bw, 0, 1);  // ...with one submap...
+    PutBitsLSB(&bw, 0, 1);  // ...no channel coupling...
+    PutBitsLSB(&bw, 0, 2);  // ...(reserved)...
+    PutBitsLSB(&bw, 0, 8);  // ...(unused time config)...
+    PutBitsLSB(&bw, 0, 8);  // ...floor 0...
+    PutBitsLSB(&bw, 0, 8);  // ...residue 0.
+    PutBitsLSB(&bw, 0, 6);  // one mode...
+    PutBitsLSB(&bw, 0, 1);  // ...short blocks...
+    PutBitsLSB(&bw, 0, 16);  // ...window type 0...
+    PutBitsLSB(&bw, 0, 16);  // ...transform type 0...
+    PutBitsLSB(&bw, 0, 8);  // ...mapping 0.
+    PutBitsLSB(&bw, 1, 1);  // framing
+    FlushBitsLSB(&bw);
+    packetlens[1] = (int) packets.len - packetlens[0];
+    PutOggPage(buf, 0x00, 0, 1, &packets, packetlens, 2);
+
+    // audio packets: one byte each (audio packet, mode 0, every floor unused).
+    Uint32 sequence = 2;
+    Uint64 granule = 0;
+    for (int i = 0; i < numpackets; i += 128) {
+        const int count = SDL_min(128, numpackets - i);
+        int lens[128];
+        packets.len = 0;
+        for (int j = 0; j < count; j++) {
+            Put8(&packets, 0);
+            lens[j] = 1;
+            if ((i + j) > 0) {
+                granule += blocksize / 2;
+            }
+        }
+        const bool last = ((i + count) == numpackets);
+        PutOggPage(buf, last ? 0x04 : 0x00, granule, sequence++, &packets, lens, count);
+    }
+
+    buf->failed = buf->failed || packets.failed;
+    SDL_free(packets.data);
+}
+
+static void PutMIDIVarLen(ByteBuffer *buf, Uint32 val)
+{
+    Uint8 bytes[4];
+    int num = 0;
+    do {
+        bytes[num++] = (Uint8) (val & 0x7F);
+        val >>= 7;
+    } while (val && (num < 4));
+    while (num > 1) {
+        Put8(buf, bytes[--num] | 0x80);
+    }
+    Put8(buf, bytes[0]);
+}
+
+static void GenerateMIDI(ByteBuffer *buf)
+{
+    // A short arpeggio on a piano, one beat per note at 120bpm.
+    static const Uint8 notes[] = { 60, 64, 67, 72 };
+    PutString(buf, "MThd");
+    Put32BE(buf, 6);
+    Put16BE(buf, 0);  // format 0
+    Put16BE(buf, 1);  // one track
+    Put16BE(buf, 96);  // ticks per quarter note
+    PutString(buf, "MTrk");
+    const size_t lenpos = buf->len;
+    Put32BE(buf, 0);  // patched below.
+    const size_t trackstart = buf->len;
+    PutMIDIVarLen(buf, 0);
+    Put8(buf, 0xC0);  // program change
+    Put8(buf, 0);
+    for (size_t i = 0; i < SDL_arraysize(notes); i++) {
+        PutMIDIVarLen(buf, 0);
+        Put8(buf, 0x90);  // note on
+        Put8(buf, notes[i]);
+        Put8(buf, 100);
+        PutMIDIVarLen(buf, 96);
+        Put8(buf, 0x80);  // note off
+        Put8(buf, notes[i]);
+        Put8(buf, 0);
+    }
+    PutMIDIVarLen(buf, 0);
+    Put8(buf, 0xFF);  // end of track
+    Put8(buf, 0x2F);
+    Put8(buf, 0);
+    Patch32BE(buf, lenpos, (Uint32) (buf->len - trackstart));
+}
+
+
+// Output...
+
+static void Print(SDL_PRINTF_FORMAT_STRING const char *fmt, ...) SDL_PRINTF_VARARG_FUNC(1);
+static void Print(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    SDL_IOvprintf(output, fmt, ap);
+    va_end(ap);
+}
+
+static void BeginResult(void)
+{
+    Print("%s\n    {", first_result ? "" : ",");
+    first_result = false;
+}
+
+static void PrintStats(MIX_Mixer *mixer)
+{
+    MIX_MixerStats stats;
+    if (MIX_GetMixerStats(mixer, &stats)) {
+        Print(", \"stats\": { \"callbacks\": %" SDL_PRIu64 ", \"callback_avg_ns\": %" SDL_PRIu64 ", \"callback_max_ns\": %" SDL_PRIu64
+              ", \"decode_ns\": %" SDL_PRIu64 ", \"mix_ns\": %" SDL_PRIu64 ", \"buffer_reallocations\": %" SDL_PRIu64
+              ", \"virtual_tracks\": %d, \"culled_tracks\": %d }",
+              stats.callbacks, stats.callback_avg_ns, stats.callback_max_ns, stats.decode_ns, stats.mix_ns, stats.buffer_reallocations,
+              stats.virtual_tracks, stats.culled_tracks);
+    }
+}
+
+static void PrintEscaped(const char *str)
+{
+    Print("\"");
+    for (const char *ptr = str; *ptr; ptr++) {
+        const unsigned char ch = (unsigned char) *ptr;
+        if ((ch == '"') || (ch == '\\')) {
+            Print("\\%c", ch);
+        } else if (ch < 0x20) {
+            Print("\\u%04x", (unsigned int) ch);
+        } else {
+            Print("%c", ch);
+        }
+    }
+    Print("\"");
+}
+
+
+// The actual benchmarking...
+
+static MIX_Mixer *CreateBenchMixer(const SDL_AudioSpec *spec)
+{
+    MIX_Mixer *mixer = MIX_CreateMixer(spec);
+    if (mixer && (render_threads > 0) && !MIX_SetMixerRenderThreads(mixer, render_threads)) {
+        SDL_Log("Couldn't set render threads, continuing without: %s", SDL_GetError());
+    }
+    return mixer;
+}
+
+static bool StartTracks(MIX_Mixer *mixer, MIX_Audio *audio, MIX_Track **tracks, int numtracks, BenchSpatialization spatialization,
+                        MIX_Group **groups, int numgroups, Sint64 fade_frames)
+{
+    const SDL_PropertiesID options = SDL_CreateProperties();
+    if (!options) {
+        return false;
+    }
+
+    SDL_SetNumberProperty(options, MIX_PROP_PLAY_LOOPS_NUMBER, -1);
+    if (fade_frames > 0) {
+        SDL_SetNumberProperty(options, MIX_PROP_PLAY_FADE_IN_FRAMES_NUMBER, fade_frames);
+    }
+
+    bool retval = true;
+    for (int i = 0; i < numtracks; i++) {
+        MIX_Track *track = tracks[i] = MIX_CreateTrack(mixer);
+        if (!track || !MIX_SetTrackAudio(track, audio)) {
+            retval = false;
+            break;
+        }
+
+        // spread things out so the kernels can't get lucky with identical gains.
+        const float t = ((float) i) / ((float) numtracks);
+        if (spatialization == BENCH_SPATIALIZATION_STEREO) {
+            const MIX_StereoGains gains = { 1.0f - t, t };
+            MIX_SetTrackStereo(track, &gains);
+        } else if (spatialization == BENCH_SPATIALIZATION_3D) {
+            const MIX_Point3D position = { SDL_cosf(t * 2.0f * SDL_PI_F) * 5.0f, 0.0f, SDL_sinf(t * 2.0f * SDL_PI_F) * 5.0f };
+            MIX_SetTrack3DPosition(track, &position);
+        }
+
+        if (numgroups > 0) {
+            MIX_SetTrackGroup(track, groups[i % numgroups]);
+        }
+
+        // stagger start positions so every track isn't decoding the same block at the same time.
+        SDL_SetNumberProperty(options, MIX_PROP_PLAY_START_FRAME_NUMBER, (Sint64) ((i * 997) % ASSET_FRAMES));
+        if (!MIX_PlayTrack(track, options)) {
+            retval = false;
+            break;
+        }
+    }
+
+    SDL_DestroyProperties(options);
+    return retval;
+}
+
+// Returns the real-time factor, or a negative number on error.
+static double RunMixer(MIX_Mixer *mixer, const SDL_AudioSpec *spec, Uint64 *elapsed_ns)
+{
+    const int framesize = SDL_AUDIO_FRAMESIZE(*spec);
+    const int buflen = CHUNK_FRAMES * framesize;
+    const Sint64 total_frames = (Sint64) (bench_seconds * spec->freq);
+    void *buf = SDL_malloc(buflen);
+    if (!buf) {
+        return -1.0;
+    }
+
+    // warm up: let decoders, caches and buffer allocations settle.
+    for (int i = 0; i < 4; i++) {
+        if (!MIX_Generate(mixer, buf, buflen)) {
+            SDL_free(buf);
+            return -1.0;
+        }
+    }
+
+    const Uint64 start = SDL_GetTicksNS();
+    for (Sint64 frames = 0; frames < total_frames; frames += CHUNK_FRAMES) {
+        if (!MIX_Generate(mixer, buf, buflen)) {
+            SDL_free(buf);
+            return -1.0;
+        }
+    }
+    const Uint64 elapsed = SDL_max(SDL_GetTicksNS() - start, 1);
+
+    SDL_free(buf);
+    *elapsed_ns = elapsed;
+    return (((double) total_frames) / ((double) spec->freq)) / (((double) elapsed) / 1000000000.0);
+}
+
+static void BenchMix(const SDL_AudioSpec *spec, MIX_Audio *audio, const char *audio_format, int numtracks, BenchSpatialization spatialization, int numgroups, bool fade, int max_voices)
+{
+    MIX_Mixer *mixer = CreateBenchMixer(spec);
+    MIX_Track **tracks = (MIX_Track **) SDL_calloc(numtracks, sizeof (MIX_Track *));
+    MIX_Group *groups[8];
+    const char *error = NULL;
+    double rtf = -1.0;
+    Uint64 elapsed_ns = 0;
+
+    SDL_zeroa(groups);
+    SDL_assert(numgroups <= (int) SDL_arraysize(groups));
+
+    if (!mixer || !tracks) {
+        error = SDL_GetError();
+    } else if ((max_voices > 0) && !MIX_SetMixerMaxVoices(mixer, max_voices)) {
+        error = SDL_GetError();
+    } else {
+        bool okay = true;
+        for (int i = 0; okay && (i < numgroups); i++) {
+            groups[i] = MIX_CreateGroup(mixer);
+            okay = (groups[i] != NULL);
+        }
+
+        // fade over a lot longer than the test, so it's active the whole time.
+        const Sint64 fade_frames = fade ? (Sint64) (bench_seconds * spec->freq * 4) : 0;
+        if (!okay || !StartTracks(mixer, audio, tracks, numtracks, spatialization, groups, numgroups, fade_frames)) {
+            error = SDL_GetError();
+        } else if ((rtf = RunMixer(mixer, spec, &elapsed_ns)) < 0.0) {
+            error = SDL_GetError();
+        }
+    }
+
+    BeginResult();
+    Print("\"audio_format\": \"%s\", \"tracks\": %d, \"spatialization\": \"%s\", \"groups\": %d, \"fade\": %s, \"max_voices\": %d", audio_format, numtracks, spatialization_names[spatialization], numgroups, fade ? "true" : "false", max_voices);
+    if (error) {
+        Print(", \"error\": ");
+        PrintEscaped(error);
+    } else {
+        Print(", \"realtime_factor\": %.3f, \"ns_per_track_frame\": %.3f", rtf,
+              ((double) elapsed_ns) / ((bench_seconds * spec->freq) * numtracks));
+        PrintStats(mixer);
+    }
+    Print(" }");
+
+    SDL_Log("mix: %s audio, %d tracks, %s, %d groups, %s, %d max voices: %s%.2fx realtime", audio_format, numtracks, spatialization_names[spatialization], numgroups,
+            fade ? "fading" : "no fade", max_voices, error ? "FAILED " : "", rtf);
+
+    if (tracks) {
+        for (int i = 0; i < numtracks; i++) {
+            MIX_DestroyTrack(tracks[i]);  // NULL is safe here.
+        }
+        SDL_free(tracks);
+    }
+    for (int i = 0; i < numgroups; i++) {
+        MIX_DestroyGroup(groups[i]);
+    }
+    MIX_DestroyMixer(mixer);
+}
+
+static bool DecoderAvailable(const char *name)
+{
+    const int total = MIX_GetNumAudioDecoders();
+    for (int i = 0; i < total; i++) {
+        if (SDL_strcmp(MIX_GetAudioDecoder(i), name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static MIX_Audio *LoadAsset(MIX_Mixer *mixer, const BenchAsset *asset, bool predecode, bool mixer_format)
+{
+    SDL_IOStream *io = SDL_IOFromConstMem(asset->data.data, asset->data.len);
+    if (!io) {
+        return NULL;
+    }
+
+    const SDL_PropertiesID props = SDL_CreateProperties();
+    if (!props) {
+        SDL_CloseIO(io);
+        return NULL;
+    }
+
+    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_IOSTREAM_POINTER, io);
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_CLOSEIO_BOOLEAN, true);
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_PREDECODE_BOOLEAN, predecode);
+    SDL_SetBooleanProperty(props, MIX_PROP_AUDIO_LOAD_PREDECODE_MIXER_FORMAT_BOOLEAN, mixer_format);
+    SDL_SetPointerProperty(props, MIX_PROP_AUDIO_LOAD_PREFERRED_MIXER_POINTER, mixer);
+    SDL_SetStringProperty(props, MIX_PROP_AUDIO_DECODER_STRING, asset->decoder);
+    MIX_Audio *audio = MIX_LoadAudioWithProperties(props);
+    SDL_DestroyProperties(props);
+    return audio;
+}
+
+static void BenchDecoder(const SDL_AudioSpec *spec, const BenchAsset *asset, int numtracks)
+{
+    const char *status = "ok";
+    const char *error = NULL;
+    double rtf = -1.0;
+    Uint64 elapsed_ns = 0;
+    MIX_Mixer *mixer = NULL;
+    MIX_Audio *audio = NULL;
+    MIX_Track **tracks = NULL;
+
+    if (!DecoderAvailable(asset->decoder)) {
+        status = "skipped";
+        error = "decoder not built";
+    } else if ((mixer = CreateBenchMixer(spec)) == NULL) {
+        status = "failed";
+        error = SDL_GetError();
+    } else if (asset->data.len == 0) {
+        audio = MIX_CreateSineWaveAudio(mixer, 440, 0.25f);
+    } else {
+        audio = LoadAsset(mixer, asset, false, false);  // don't predecode: we want to measure the decoder, not memcpy.
+    }
+
+    if (mixer && !error) {
+        if (!audio) {
+            // things like Timidity need external instrument data, which we can't promise is installed.
+            status = "skipped";
+            error = SDL_GetError();
+        } else if ((tracks = (MIX_Track **) SDL_calloc(numtracks, sizeof (MIX_Track *))) == NULL) {
+            status = "failed";
+            error = SDL_GetError();
+        } else if (!StartTracks(mixer, audio, tracks, numtracks, BENCH_SPATIALIZATION_NONE, NULL, 0, 0)) {
+            status = "failed";
+            error = SDL_GetError();
+        } else if ((rtf = RunMixer(mixer, spec, &elapsed_ns)) < 0.0) {
+            status = "failed";
+            error = SDL_GetError();
+        }
+    }
+
+    BeginResult();
+    Print("\"asset\": \"%s\", \"decoder\": \"%s\", \"tracks\": %d, \"status\": \"%s\"", asset->name, asset->decoder, numtracks, status);
+    if (error) {
+        Print(", \"error\": ");
+        PrintEscaped(error);
+    } else {
+        Print(", \"realtime_factor\": %.3f, \"ns_per_track_frame\": %.3f", rtf,
+              ((double) elapsed_ns) / ((bench_seconds * spec->freq) * numtracks));
+        PrintStats(mixer);
+    }
+    Print(" }");
+
+    SDL_Log("decode: %s (%s), %d tracks: %s %s%.2fx realtime", asset->name, asset->decoder, numtracks, status, error ? error : "", rtf);
+
+    if (tracks) {
+        for (int i = 0; i < numtracks; i++) {
+            MIX_DestroyTrack(tracks[i]);
+        }
+        SDL_free(tracks);
+    }
+    MIX_DestroyAudio(audio);
+    MIX_DestroyMixer(mixer);
+}
+
+int main(int argc, char **argv)
+{
+    SDL_AudioSpec spec = { SDL_AUDIO_F32, 2, 48000 };
+    const char *outpath = NULL;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const bool hasval = (i + 1) < argc;
+        if (SDL_strcmp(arg, "--quick") == 0) {
+            quick = true;
+        } else if (hasval && (SDL_strcmp(arg, "--seconds") == 0)) {
+            bench_seconds = SDL_max(SDL_atof(argv[++i]), 0.1);
+        } else if (hasval && (SDL_strcmp(arg, "--max-tracks") == 0)) {
+            max_tracks = SDL_max(SDL_atoi(argv[++i]), 1);
+        } else if (hasval && (SDL_strcmp(arg, "--threads") == 0)) {
+            render_threads = SDL_max(SDL_atoi(argv[++i]), 0);
+        } else if (hasval && (SDL_strcmp(arg, "--channels") == 0)) {
+            spec.channels = SDL_clamp(SDL_atoi(argv[++i]), 1, 8);
+        } else if (hasval && (SDL_strcmp(arg, "--freq") == 0)) {
+            spec.freq = SDL_max(SDL_atoi(argv[++i]), 8000);
+        } else if (hasval && (SDL_strcmp(arg, "--output") == 0)) {
+            outpath = argv[++i];
+        } else {
+            SDL_Log("USAGE: %s [--quick] [--seconds N] [--max-tracks N] [--threads N] [--channels N] [--freq N] [--output file.json]", argv[0]);
+            return 1;
+        }
+    }
+
+    if (!SDL_Init(0)) {
+        SDL_Log("Couldn't initialize SDL: %s", SDL_GetError());
+        return 1;
+    } else if (!MIX_Init()) {
+        SDL_Log("Couldn't initialize SDL_mixer: %s", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+
+    output = outpath ? SDL_IOFromFile(outpath, "w") : SDL_IOFromDynamicMem();
+    if (!output) {
+        SDL_Log("Couldn't open output: %s", SDL_GetError());
+        MIX_Quit();
+        SDL_Quit();
+        return 1;
+    }
+
+    BenchAsset assets[] = {
+        { "wav_pcm16", "WAV", { NULL, 0, 0, false } },
+        { "wav_ima_adpcm", "WAV", { NULL, 0, 0, false } },
+        { "aiff", "AIFF", { NULL, 0, 0, false } },
+        { "voc", "VOC", { NULL, 0, 0, false } },
+        { "au", "AU", { NULL, 0, 0, false } },
+        { "mp3", "DRMP3", { NULL, 0, 0, false } },
+        { "flac", "DRFLAC", { NULL, 0, 0, false } },
+        { "ogg_vorbis", "STBVORBIS", { NULL, 0, 0, false } },
+        { "midi", "TIMIDITY", { NULL, 0, 0, false } },
+        { "sinewave", "SINEWAVE", { NULL, 0, 0, false } }
+    };
+
+    GenerateWAVPCM(&assets[0].data);
+    GenerateWAVADPCM(&assets[1].data);
+    GenerateAIFF(&assets[2].data);
+    GenerateVOC(&assets[3].data);
+    GenerateAU(&assets[4].data);
+    GenerateMP3(&assets[5].data);
+    GenerateFLAC(&assets[6].data);
+    GenerateVorbis(&assets[7].data);
+    GenerateMIDI(&assets[8].data);
+    // sinewave has no data; it's generated by MIX_CreateSineWaveAudio.
+
+    bool okay = true;
+    for (size_t i = 0; i < SDL_arraysize(assets); i++) {
+        if (assets[i].data.failed) {
+            SDL_Log("Out of memory generating %s asset", assets[i].name);
+            okay = false;
+        }
+    }
+
+    const int version = MIX_Version();
+    Print("{\n  \"benchmark\": \"benchmix\",\n");
+    Print("  \"sdl_mixer_version\": \"%d.%d.%d\",\n", SDL_VERSIONNUM_MAJOR(version), SDL_VERSIONNUM_MINOR(version), SDL_VERSIONNUM_MICRO(version));
+    Print("  \"sdl_version\": \"%d.%d.%d\",\n", SDL_VERSIONNUM_MAJOR(SDL_GetVersion()), SDL_VERSIONNUM_MINOR(SDL_GetVersion()), SDL_VERSIONNUM_MICRO(SDL_GetVersion()));
+    Print("  \"platform\": \"%s\",\n", SDL_GetPlatform());
+    Print("  \"cpu\": { \"cores\": %d, \"sse\": %s, \"avx2\": %s, \"neon\": %s },\n", SDL_GetNumLogicalCPUCores(),
+          SDL_HasSSE() ? "true" : "false", SDL_HasAVX2() ? "true" : "false", SDL_HasNEON() ? "true" : "false");
+    Print("  \"scalar_fallback\": %s,\n", SDL_MIXER_FORCE_SCALAR_FALLBACK ? "true" : "false");
+    Print("  \"spec\": { \"format\": \"%s\", \"channels\": %d, \"freq\": %d },\n", SDL_GetAudioFormatName(spec.format), spec.channels, spec.freq);
+    Print("  \"chunk_frames\": %d,\n  \"seconds\": %.3f,\n  \"render_threads\": %d,\n", CHUNK_FRAMES, bench_seconds, render_threads);
+
+    // mixing throughput: a predecoded asset, so decoders are out of the picture.
+    Print("  \"mix\": [");
+    if (okay) {
+        MIX_Mixer *loader = MIX_CreateMixer(&spec);
+        MIX_Audio *audio = loader ? LoadAsset(loader, &assets[0], true, false) : NULL;
+        MIX_Audio *mixer_format_audio = loader ? LoadAsset(loader, &assets[0], true, true) : NULL;
+        if (!audio || !mixer_format_audio) {
+            SDL_Log("Couldn't load mixing asset: %s", SDL_GetError());
+            okay = false;
+        } else {
+            static const int full_counts[] = { 1, 2, 8, 32, 128, 512, 1000, 2000 };
+            static const int quick_counts[] = { 1, 32, 256 };
+            const int *counts = quick ? quick_counts : full_counts;
+            const int numcounts = quick ? (int) SDL_arraysize(quick_counts) : (int) SDL_arraysize(full_counts);
+            for (int i = 0; i < numcounts; i++) {
+                const int numtracks = SDL_min(counts[i], max_tracks);
+                if ((i > 0) && (numtracks == SDL_min(counts[i - 1], max_tracks))) {
+                    break;  // clamped to max_tracks, we already did this one.
+                }
+                for (int spatialization = BENCH_SPATIALIZATION_NONE; spatialization <= BENCH_SPATIALIZATION_3D; spatialization++) {
+                    BenchMix(&spec, audio, "native", numtracks, (BenchSpatialization) spatialization, 0, false, 0);
+                }
+                BenchMix(&spec, mixer_format_audio, "mixer", numtracks, BENCH_SPATIALIZATION_NONE, 0, false, 0);  // predecoded to the mixer's format: no conversion at all.
+                BenchMix(&spec, audio, "native", numtracks, BENCH_SPATIALIZATION_NONE, 0, true, 0);
+                BenchMix(&spec, audio, "native", numtracks, BENCH_SPATIALIZATION_NONE, 4, false, 0);
+                if (!quick) {
+                    BenchMix(&spec, audio, "native", numtracks, BENCH_SPATIALIZATION_3D, 8, true, 0);
+                }
+                if (numtracks > 64) {
+                    BenchMix(&spec, audio, "native", numtracks, BENCH_SPATIALIZATION_3D, 0, false, 64);  // voice limiting: only 64 tracks are really mixed, the rest are virtual.
+                }
+            }
+        }
+        MIX_DestroyAudio(audio);
+        MIX_DestroyAudio(mixer_format_audio);
+        MIX_DestroyMixer(loader);
+    }
+    Print("\n  ],\n");
+
+    // decoding throughput: streamed from memory, one decoder instance per track.
+    first_result = true;
+    Print("  \"decode\": [");
+    if (okay) {
+        const int decode_tracks = SDL_min(quick ? 8 : 32, max_tracks);
+        for (size_t i = 0; i < SDL_arraysize(assets); i++) {
+            BenchDecoder(&spec, &assets[i], 1);
+            if (decode_tracks > 1) {
+                BenchDecoder(&spec, &assets[i], decode_tracks);
+            }
+        }
+    }
+    Print("\n  ]\n}\n");
+
+    if (!outpath) {
+        // dump the JSON to stdout in one go, so the SDL_Log progress on stderr doesn't interleave with it.
+        const Sint64 len = SDL_GetIOSize(output);
+        const char *json = (const char *) SDL_GetPointerProperty(SDL_GetIOProperties(output), SDL_PROP_IOSTREAM_DYNAMIC_MEMORY_POINTER, NULL);
+        if (json && (len > 0)) {
+            fwrite(json, 1, (size_t) len, stdout);
+            fflush(stdout);
+        }
+    }
+    SDL_CloseIO(output);
+
+    for (size_t i = 0; i < SDL_arraysize(assets); i++) {
+        SDL_free(assets[i].data.data);
+    }
+
+    MIX_Quit();
+    SDL_Quit();
+    return okay ? 0 : 1;
+}